@@ -0,0 +1,292 @@
+#include "BitPlane.hpp"
+#include <algorithm>
+#include <cstring>
+#include "bitPacking.hpp"
+
+/*!
+	\brief
+	Table of the 8 pixels of every byte of a packed row : the pixel k of the entry b is 0 if the bit k of b is set (black) and 255 otherwise
+*/
+static std::vector<std::uint64_t>	makeUnpackTable();
+
+/*!
+	\brief
+	See makeUnpackTable
+*/
+static std::vector<std::uint64_t> const	UNPACK_TABLE = makeUnpackTable();
+
+/*!
+	\brief
+	Mask of the bitsNb lowest bits of a word
+
+	\param bitsNb in [0; 64]
+*/
+static std::uint64_t	getLowMask(int bitsNb);
+
+BitPlane::BitPlane() :
+	m_words(std::make_shared<std::vector<std::uint64_t>>()),
+	m_start(0),
+	m_rows(0),
+	m_cols(0),
+	m_stride(0),
+	m_bitOffset(0)
+{
+
+}
+
+BitPlane::BitPlane(int rows, int cols) :
+	m_words(std::make_shared<std::vector<std::uint64_t>>(static_cast<std::size_t>(rows) * getPackedWordsNb(cols), 0)),
+	m_start(0),
+	m_rows(rows),
+	m_cols(cols),
+	m_stride(getPackedWordsNb(cols)),
+	m_bitOffset(0)
+{
+
+}
+
+BitPlane	BitPlane::fromMat(cv::Mat const& img, unsigned char thresh)
+{
+	BitPlane	plane;
+
+	fromMat(img, thresh, plane);
+	return plane;
+}
+
+void	BitPlane::fromMat(cv::Mat const& img, unsigned char thresh, BitPlane& plane)
+{
+	CV_Assert(img.type() == CV_8UC1);
+	if(plane.m_words.use_count() != 1)
+	{
+		plane.m_words = std::make_shared<std::vector<std::uint64_t>>();
+	}
+	packRows(img, 0, img.cols, thresh, *plane.m_words);
+	plane.m_start = 0;
+	plane.m_rows = img.rows;
+	plane.m_cols = img.cols;
+	plane.m_stride = getPackedWordsNb(img.cols);
+	plane.m_bitOffset = 0;
+}
+
+void	BitPlane::create(int rows, int cols)
+{
+	// the words shared with another plane are left to it
+	if(m_words.use_count() != 1)
+	{
+		m_words = std::make_shared<std::vector<std::uint64_t>>();
+	}
+	m_words->assign(static_cast<std::size_t>(rows) * getPackedWordsNb(cols), 0);
+	m_start = 0;
+	m_rows = rows;
+	m_cols = cols;
+	m_stride = getPackedWordsNb(cols);
+	m_bitOffset = 0;
+}
+
+int		BitPlane::getRows() const
+{
+	return m_rows;
+}
+
+int		BitPlane::getCols() const
+{
+	return m_cols;
+}
+
+int		BitPlane::getStride() const
+{
+	return m_stride;
+}
+
+int		BitPlane::getBitOffset() const
+{
+	return m_bitOffset;
+}
+
+bool	BitPlane::isEmpty() const
+{
+	return m_rows == 0 || m_cols == 0;
+}
+
+std::uint64_t const*	BitPlane::getRow(int i) const
+{
+	return m_words->data() + m_start + static_cast<std::size_t>(i) * m_stride;
+}
+
+std::uint64_t*	BitPlane::getRow(int i)
+{
+	return m_words->data() + m_start + static_cast<std::size_t>(i) * m_stride;
+}
+
+bool	BitPlane::isBlack(int i, int j) const
+{
+	int	bit = m_bitOffset + j;
+
+	return (getRow(i)[bit / 64] >> (bit % 64)) & 1;
+}
+
+std::uint64_t	BitPlane::getBits(int i, int j) const
+{
+	// the last word of the row may hold the columns of the plane a region of interest comes from, so the bits after the last column are cleared
+	return getPackedBits(getRow(i), getPackedWordsNb(m_bitOffset + m_cols), m_bitOffset + j) & getLowMask(std::min(64, m_cols - j));
+}
+
+void	BitPlane::setBits(int i, int j, std::uint64_t bits, int bitsNb)
+{
+	std::uint64_t*	row = getRow(i);
+	std::uint64_t	mask = getLowMask(bitsNb);
+	int				bit = m_bitOffset + j;
+	int				w = bit / 64;
+	int				shift = bit % 64;
+
+	if(bitsNb <= 0)
+	{
+		return;
+	}
+	bits &= mask;
+	row[w] = (row[w] & ~(mask << shift)) | (bits << shift);
+	// the bits overflowing the first word go to the low bits of the next one
+	if(shift + bitsNb > 64)
+	{
+		row[w + 1] = (row[w + 1] & ~(mask >> (64 - shift))) | (bits >> (64 - shift));
+	}
+}
+
+void	BitPlane::copyRows(BitPlane const& src, int srcRow, int dstRow, int rowsNb)
+{
+	int		wordsNb = getPackedWordsNb(m_cols);
+
+	CV_Assert(src.m_cols == m_cols && rowsNb >= 0 && srcRow >= 0 && srcRow + rowsNb <= src.m_rows && dstRow >= 0 && dstRow + rowsNb <= m_rows);
+	for(int i = 0; i < rowsNb; ++i)
+	{
+		// the rows of whole planes are copied word by word, the words of a region of interest may hold columns out of it
+		if(m_bitOffset == 0 && src.m_bitOffset == 0 && m_stride == wordsNb && src.m_stride == wordsNb)
+		{
+			std::memcpy(getRow(dstRow + i), src.getRow(srcRow + i), wordsNb * sizeof(std::uint64_t));
+			continue;
+		}
+		for(int j = 0; j < m_cols; j += 64)
+		{
+			setBits(dstRow + i, j, src.getBits(srcRow + i, j), std::min(64, m_cols - j));
+		}
+	}
+}
+
+int		BitPlane::countBlack(int i) const
+{
+	return countBlack(i, 0, m_cols);
+}
+
+int		BitPlane::countBlack(int i, int colStart, int colEnd) const
+{
+	int	blackPixelsNb = 0;
+
+	for(int j = colStart; j < colEnd; j += 64)
+	{
+		blackPixelsNb += popCount(getBits(i, j) & getLowMask(std::min(64, colEnd - j)));
+	}
+	return blackPixelsNb;
+}
+
+std::vector<std::uint64_t>	BitPlane::getPackedWords() const
+{
+	std::vector<std::uint64_t>	words;
+
+	getPackedWords(words);
+	return words;
+}
+
+void	BitPlane::getPackedWords(std::vector<std::uint64_t>& words) const
+{
+	int		wordsNb = getPackedWordsNb(m_cols);
+
+	words.assign(static_cast<std::size_t>(m_rows) * wordsNb, 0);
+	for(int i = 0; i < m_rows; ++i)
+	{
+		for(int w = 0; w < wordsNb; ++w)
+		{
+			words[static_cast<std::size_t>(i) * wordsNb + w] = getBits(i, 64 * w);
+		}
+	}
+}
+
+BitPlane	BitPlane::operator()(cv::Rect const& roi) const
+{
+	BitPlane	plane(*this);
+	int			bit = m_bitOffset + roi.x;
+
+	CV_Assert(roi.x >= 0 && roi.y >= 0 && roi.width >= 0 && roi.height >= 0 && roi.x + roi.width <= m_cols && roi.y + roi.height <= m_rows);
+	plane.m_start = m_start + static_cast<std::size_t>(roi.y) * m_stride + bit / 64;
+	plane.m_bitOffset = bit % 64;
+	plane.m_rows = roi.height;
+	plane.m_cols = roi.width;
+	return plane;
+}
+
+BitPlane	BitPlane::clone() const
+{
+	BitPlane	plane;
+
+	*plane.m_words = getPackedWords();
+	plane.m_rows = m_rows;
+	plane.m_cols = m_cols;
+	plane.m_stride = getPackedWordsNb(m_cols);
+	return plane;
+}
+
+cv::Mat	BitPlane::toMat() const
+{
+	cv::Mat	img;
+
+	toMat(img);
+	return img;
+}
+
+void	BitPlane::toMat(cv::Mat& img) const
+{
+	int				bitsNb = 0;
+	std::uint64_t	bits = 0;
+	unsigned char*	pixels = nullptr;
+
+	img.create(m_rows, m_cols, CV_8UC1);
+	for(int i = 0; i < m_rows; ++i)
+	{
+		pixels = img.ptr<unsigned char>(i);
+		for(int j = 0; j < m_cols; j += 64)
+		{
+			bitsNb = std::min(64, m_cols - j);
+			bits = getBits(i, j);
+			// 8 pixels per entry of the table, only the first pixels of the last entry when the row ends inside it
+			for(int k = 0; k < bitsNb; k += 8)
+			{
+				std::memcpy(pixels + j + k, &UNPACK_TABLE[(bits >> k) & 0xff], std::min(8, bitsNb - k));
+			}
+		}
+	}
+}
+
+static std::vector<std::uint64_t>	makeUnpackTable()
+{
+	std::vector<std::uint64_t>	table;
+	unsigned char				pixels[8];
+
+	table.assign(256, 0);
+	for(int b = 0; b < 256; ++b)
+	{
+		for(int k = 0; k < 8; ++k)
+		{
+			pixels[k] = ((b >> k) & 1) ? 0 : 255;
+		}
+		std::memcpy(&table.at(b), pixels, sizeof(pixels));
+	}
+	return table;
+}
+
+static std::uint64_t	getLowMask(int bitsNb)
+{
+	if(bitsNb >= 64)
+	{
+		return ~std::uint64_t(0);
+	}
+	return (std::uint64_t(1) << std::max(0, bitsNb)) - 1;
+}
@@ -0,0 +1,101 @@
+#ifndef BIT_PLANE_HPP
+#define BIT_PLANE_HPP
+#include <opencv2/core/core.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*!
+	\class BitPlane
+	\brief BitPlane stores a binary image with 1 bit per pixel : the bit of a black pixel is set, the row i starts in the word i * stride of the data and its column j is the bit (bitOffset + j) % 64 of the word (bitOffset + j) / 64 of the row (see packRows). Like cv::Mat, a copy or a region of interest shares the data of the plane, clone() copies it
+*/
+class BitPlane
+{
+	std::shared_ptr<std::vector<std::uint64_t>>	m_words;
+	std::size_t									m_start;
+	int											m_rows;
+	int											m_cols;
+	int											m_stride;
+	int											m_bitOffset;
+
+public :
+							BitPlane();
+	/*!
+		white plane of rows x cols pixels, whose rows take getPackedWordsNb(cols) words
+	 */
+							BitPlane(int rows, int cols);
+	/*!
+		pack an 8 bits image : a pixel is black if it is lower or equal to thresh (0 for a binarized image)
+	 */
+	static BitPlane			fromMat(cv::Mat const& img, unsigned char thresh = 0);
+	/*!
+		fromMat in a plane given by the caller (see create)
+	 */
+	static void				fromMat(cv::Mat const& img, unsigned char thresh, BitPlane& plane);
+	/*!
+		make the plane a white plane of rows x cols pixels, as BitPlane(rows, cols) but in the words of the plane when they are not shared with another plane (a copy or a region of interest), so that their memory is reused
+	 */
+	void					create(int rows, int cols);
+	int						getRows() const;
+	int						getCols() const;
+	/*!
+		number of words between the starts of 2 consecutive rows
+	 */
+	int						getStride() const;
+	/*!
+		bit of the column 0 in the first word of a row (not 0 for a region of interest starting inside a word)
+	 */
+	int						getBitOffset() const;
+	bool					isEmpty() const;
+	/*!
+		first word of the row i (its column 0 is the bit getBitOffset())
+	 */
+	std::uint64_t const*	getRow(int i) const;
+	std::uint64_t*			getRow(int i);
+	bool					isBlack(int i, int j) const;
+	/*!
+		the 64 pixels of the row i from the column j, the pixel j in the bit 0 (the bits after the last column are 0)
+	 */
+	std::uint64_t			getBits(int i, int j) const;
+	/*!
+		write the bitsNb lowest bits of bits in the pixels [j; j + bitsNb[ of the row i
+
+		\param bitsNb in [0; 64]
+	 */
+	void					setBits(int i, int j, std::uint64_t bits, int bitsNb);
+	/*!
+		copy the rows [srcRow; srcRow + rowsNb[ of src in the rows of the plane from dstRow, src having the columns of the plane (word by word between whole planes)
+	 */
+	void					copyRows(BitPlane const& src, int srcRow, int dstRow, int rowsNb);
+	/*!
+		number of black pixels of the row i
+	 */
+	int						countBlack(int i) const;
+	/*!
+		number of black pixels of the columns [colStart; colEnd[ of the row i
+	 */
+	int						countBlack(int i, int colStart, int colEnd) const;
+	/*!
+		rows packed one after another as packRows gives them : getPackedWordsNb(cols) words per row, the unused bits of their last word equal to 0
+	 */
+	std::vector<std::uint64_t>	getPackedWords() const;
+	/*!
+		getPackedWords in a buffer given by the caller, whose memory is reused from one call to another
+	 */
+	void					getPackedWords(std::vector<std::uint64_t>& words) const;
+	/*!
+		region of interest sharing the data of the plane
+	 */
+	BitPlane				operator()(cv::Rect const& roi) const;
+	BitPlane				clone() const;
+	/*!
+		unpack in an 8 bits image : 0 for a black pixel and 255 for a white one
+	 */
+	cv::Mat					toMat() const;
+	/*!
+		toMat in a buffer given by the caller, reallocated only if it has not the size of the plane
+	 */
+	void					toMat(cv::Mat& img) const;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "CombFilter.hpp"
+#include <algorithm>
+
+CombFilter::CombFilter(int linesNb, int spacing, int epsilon) :
+	m_linesNb(std::max(0, linesNb)),
+	m_spacing(spacing),
+	m_epsilon(std::max(0, epsilon))
+{
+
+}
+
+int		CombFilter::getLinesNb() const
+{
+	return m_linesNb;
+}
+
+int		CombFilter::getSpacing() const
+{
+	return m_spacing;
+}
+
+int		CombFilter::getEpsilon() const
+{
+	return m_epsilon;
+}
+
+void	CombFilter::setup(int linesNb, int spacing, int epsilon)
+{
+	m_linesNb = std::max(0, linesNb);
+	m_spacing = spacing;
+	m_epsilon = std::max(0, epsilon);
+}
+
+void	CombFilter::apply(std::vector<int> const& profileVect, std::vector<int>& filteredVect)
+{
+	int	profileVectSize = static_cast<int>(profileVect.size());
+	int	firstLine = -(m_linesNb - 1) / 2;
+	int	center = 0;
+	int	windowStart = 0;
+	int	windowEnd = 0;
+
+	m_prefixSums.assign(profileVectSize + 1, 0);
+	for(int x = 0; x < profileVectSize; ++x)
+	{
+		m_prefixSums[x + 1] = m_prefixSums[x] + profileVect[x];
+	}
+	filteredVect.assign(profileVectSize, 0);
+	// one window after another so that the rows of a window are read in order, a window cut by the borders is clamped into the profile
+	for(int line = firstLine; line < firstLine + m_linesNb; ++line)
+	{
+		for(int x = 0; x < profileVectSize; ++x)
+		{
+			center = x + line * m_spacing;
+			windowStart = std::max(0, center - m_epsilon);
+			windowEnd = std::min(profileVectSize, center + m_epsilon + 1);
+			if(windowStart < windowEnd)
+			{
+				filteredVect[x] += static_cast<int>(m_prefixSums[windowEnd] - m_prefixSums[windowStart]);
+			}
+		}
+	}
+}
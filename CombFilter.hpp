@@ -0,0 +1,43 @@
+#ifndef COMB_FILTER_HPP
+#define COMB_FILTER_HPP
+#include <vector>
+
+/*!
+	\class CombFilter
+	\brief CombFilter sums, for every row of a horizontal profile, the profile in linesNb windows of 2 * epsilon + 1 rows centered spacing rows apart around the row (the lines of a stave around its middle line). The windows are read from the prefix sums of the profile, so that a row costs linesNb subtractions whatever epsilon is. The rows outside of the profile count for 0
+*/
+class CombFilter
+{
+	int						m_linesNb;
+	int						m_spacing;
+	int						m_epsilon;
+	std::vector<long long>	m_prefixSums;
+
+public :
+	/*!
+		\param linesNb number of windows (the first one is centered linesNb / 2 spacings above the row when linesNb is odd)
+		\param spacing number of rows between the centers of 2 consecutive windows (the interline)
+		\param epsilon half size of a window (the variation of the interline between the lines of a stave)
+	 */
+						CombFilter(int linesNb, int spacing, int epsilon);
+	int					getLinesNb() const;
+	int					getSpacing() const;
+	int					getEpsilon() const;
+	/*!
+		change the windows of the filter, its buffer is kept (a filter per interline does not allocate its prefix sums again)
+
+		\param linesNb see CombFilter
+		\param spacing see CombFilter
+		\param epsilon see CombFilter
+	 */
+	void				setup(int linesNb, int spacing, int epsilon);
+	/*!
+		filter profileVect into filteredVect (the buffers of the filter and of the caller are reused from one call to another)
+
+		\param profileVect see getHorizontalProfile
+		\param filteredVect profileVect.size() values
+	 */
+	void				apply(std::vector<int> const& profileVect, std::vector<int>& filteredVect);
+};
+
+#endif
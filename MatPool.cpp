@@ -0,0 +1,166 @@
+#include "MatPool.hpp"
+
+MatPool::MatPool() :
+	m_liveNb(0),
+	m_createdNb(0),
+	m_reusedNb(0),
+	m_isReleased(false)
+{
+
+}
+
+MatPool::~MatPool()
+{
+
+}
+
+cv::UMatData*	MatPool::allocate(int dims, int const* sizes, int type, void* data0, std::size_t* step, MatAccessFlag flags, cv::UMatUsageFlags usageFlags) const
+{
+	std::size_t		total = CV_ELEM_SIZE(type);
+	std::size_t		best = 0;
+	cv::UMatData*	data = nullptr;
+
+	// the pixels of the caller are not the business of the pool
+	if(data0 != nullptr)
+	{
+		return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data0, step, flags, usageFlags);
+	}
+	for(int i = dims - 1; i >= 0; --i)
+	{
+		if(step != nullptr)
+		{
+			step[i] = total;
+		}
+		total *= sizes[i];
+	}
+	{
+		std::lock_guard<std::mutex>	lock(m_mutex);
+
+		// the smallest released buffer big enough, unless it is more than twice too big
+		best = m_idle.size();
+		for(std::size_t i = 0; i < m_idle.size(); ++i)
+		{
+			if(m_idle[i].data->size >= total && m_idle[i].data->size <= 2 * total && (best == m_idle.size() || m_idle[i].data->size < m_idle[best].data->size))
+			{
+				best = i;
+			}
+		}
+		if(best < m_idle.size())
+		{
+			data = m_idle[best].data;
+			m_idle[best] = m_idle.back();
+			m_idle.pop_back();
+			++m_reusedNb;
+		}
+		else
+		{
+			++m_createdNb;
+		}
+		++m_liveNb;
+	}
+	if(data == nullptr)
+	{
+		data = new cv::UMatData(this);
+		data->data = data->origdata = static_cast<unsigned char*>(cv::fastMalloc(total));
+		data->size = total;
+	}
+	data->refcount = 0;
+	data->urefcount = 0;
+	data->currAllocator = this;
+	return data;
+}
+
+bool	MatPool::allocate(cv::UMatData* data, MatAccessFlag, cv::UMatUsageFlags) const
+{
+	return data != nullptr;
+}
+
+void	MatPool::deallocate(cv::UMatData* data) const
+{
+	bool	isDestroyed = false;
+	bool	isLast = false;
+
+	if(data == nullptr)
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex>	lock(m_mutex);
+
+		--m_liveNb;
+		isDestroyed = m_isReleased;
+		isLast = (m_isReleased && m_liveNb == 0);
+		if(!m_isReleased)
+		{
+			m_idle.push_back({data, true});
+		}
+	}
+	if(isDestroyed)
+	{
+		destroy(data);
+	}
+	if(isLast)
+	{
+		delete this;
+	}
+}
+
+void	MatPool::trim()
+{
+	std::lock_guard<std::mutex>	lock(m_mutex);
+	std::size_t					kept = 0;
+
+	for(auto& entry : m_idle)
+	{
+		if(entry.isRecent)
+		{
+			m_idle[kept++] = {entry.data, false};
+		}
+		else
+		{
+			destroy(entry.data);
+		}
+	}
+	m_idle.resize(kept);
+}
+
+void	MatPool::release()
+{
+	bool	isLast = false;
+
+	{
+		std::lock_guard<std::mutex>	lock(m_mutex);
+
+		for(auto& entry : m_idle)
+		{
+			destroy(entry.data);
+		}
+		m_idle.clear();
+		m_isReleased = true;
+		isLast = (m_liveNb == 0);
+	}
+	if(isLast)
+	{
+		delete this;
+	}
+}
+
+std::size_t		MatPool::getCreatedNb() const
+{
+	std::lock_guard<std::mutex>	lock(m_mutex);
+
+	return m_createdNb;
+}
+
+std::size_t		MatPool::getReusedNb() const
+{
+	std::lock_guard<std::mutex>	lock(m_mutex);
+
+	return m_reusedNb;
+}
+
+void	MatPool::destroy(cv::UMatData* data)
+{
+	cv::fastFree(data->origdata);
+	delete data;
+}
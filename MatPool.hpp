@@ -0,0 +1,72 @@
+#ifndef MAT_POOL_HPP
+#define MAT_POOL_HPP
+#include <opencv2/core/core.hpp>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/*!
+	\brief
+	Access flags of cv::MatAllocator, an enum since OpenCV 4
+*/
+#if CV_VERSION_MAJOR >= 4
+typedef cv::AccessFlag	MatAccessFlag;
+#else
+typedef int				MatAccessFlag;
+#endif
+
+/*!
+	\class MatPool
+	\brief MatPool is an allocator of matrices (see cv::Mat::allocator) that keeps the pixels of the matrices it gave once they are released, to give them again to the next matrices of close sizes : the images of a page reuse the memory of the images of the page before. A buffer is only given to a matrix that needs at least half of it, the buffers that were not given since the previous call to trim are freed by trim.
+	The pool is shared by the matrices it gave, which may outlive the one that created it : it is created with new and given up by release, it is deleted once its last matrix is released
+*/
+class MatPool : public cv::MatAllocator
+{
+	/*!
+		\struct Entry
+		\brief Entry stores a released buffer of the pool
+	 */
+	struct Entry
+	{
+		cv::UMatData*	data;		///< header of the buffer, its size is the size of the buffer
+		bool			isRecent;	///< given or released since the last call to trim
+	};
+
+	mutable std::mutex			m_mutex;
+	mutable std::vector<Entry>	m_idle;
+	mutable std::size_t			m_liveNb;
+	mutable std::size_t			m_createdNb;
+	mutable std::size_t			m_reusedNb;
+	bool						m_isReleased;
+
+public :
+						MatPool();
+	cv::UMatData*		allocate(int dims, int const* sizes, int type, void* data0, std::size_t* step, MatAccessFlag flags, cv::UMatUsageFlags usageFlags) const;
+	bool				allocate(cv::UMatData* data, MatAccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const;
+	void				deallocate(cv::UMatData* data) const;
+	/*!
+		free the released buffers that were neither given nor released since the previous call
+	 */
+	void				trim();
+	/*!
+		give up the pool : its released buffers are freed, then the buffers of the matrices still alive as they are released, and the pool itself with the last of them
+	 */
+	void				release();
+	/*!
+		number of buffers allocated by the pool
+	 */
+	std::size_t			getCreatedNb() const;
+	/*!
+		number of matrices given a released buffer
+	 */
+	std::size_t			getReusedNb() const;
+
+private :
+						~MatPool();
+	/*!
+		free a buffer and its header
+	 */
+	static void			destroy(cv::UMatData* data);
+};
+
+#endif
@@ -0,0 +1,202 @@
+#include "PageQueue.hpp"
+#include <cstdint>
+
+PageQueue::PageQueue(std::size_t capacity) :
+	m_pushPosition(0),
+	m_popPosition(0),
+	m_maxDepth(0),
+	m_waitersNb(0)
+{
+	std::size_t		size = 2;
+
+	// the position of a cell in the ring is the position in the queue modulo its size, read with a mask. The ring has at least 2 cells : a page pushed at the position p leaves its cell with the sequence p + 1, which is also the sequence of a free cell for the next push at p + 1. With a single cell, this next push would find the cell free and write over the page before it is popped
+	while(size < capacity)
+	{
+		size *= 2;
+	}
+	m_cells.reset(new Cell[size]);
+	m_mask = size - 1;
+	for(std::size_t i = 0; i < size; ++i)
+	{
+		m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+std::size_t		PageQueue::getCapacity() const
+{
+	return m_mask + 1;
+}
+
+std::size_t		PageQueue::getDepth() const
+{
+	std::size_t		popPosition = m_popPosition.load(std::memory_order_relaxed);
+	std::size_t		pushPosition = m_pushPosition.load(std::memory_order_relaxed);
+
+	return (pushPosition > popPosition ? pushPosition - popPosition : 0);
+}
+
+std::size_t		PageQueue::getMaxDepth() const
+{
+	return m_maxDepth.load(std::memory_order_relaxed);
+}
+
+bool	PageQueue::tryPush(PageItem& item)
+{
+	std::size_t		position = m_pushPosition.load(std::memory_order_relaxed);
+	std::size_t		depth = 0;
+	std::size_t		maxDepth = 0;
+	std::intptr_t	lag = 0;
+	Cell*			cell = nullptr;
+
+	while(true)
+	{
+		cell = &m_cells[position & m_mask];
+		lag = static_cast<std::intptr_t>(cell->sequence.load(std::memory_order_acquire)) - static_cast<std::intptr_t>(position);
+		if(lag == 0)
+		{
+			// the cell is free for this position : claim it
+			if(m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if(lag < 0)
+		{
+			// the cell still holds the page pushed a turn of the ring ago
+			return false;
+		}
+		else
+		{
+			// another producer claimed the position
+			position = m_pushPosition.load(std::memory_order_relaxed);
+		}
+	}
+	cell->item = std::move(item);
+	cell->sequence.store(position + 1, std::memory_order_release);
+	wakeWaiters();
+	depth = getDepth();
+	maxDepth = m_maxDepth.load(std::memory_order_relaxed);
+	// a failed exchange reads the maximum written by another producer
+	while(depth > maxDepth)
+	{
+		if(m_maxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed))
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+bool	PageQueue::tryPop(PageItem& item)
+{
+	std::size_t		position = m_popPosition.load(std::memory_order_relaxed);
+	std::intptr_t	lag = 0;
+	Cell*			cell = nullptr;
+
+	while(true)
+	{
+		cell = &m_cells[position & m_mask];
+		lag = static_cast<std::intptr_t>(cell->sequence.load(std::memory_order_acquire)) - static_cast<std::intptr_t>(position + 1);
+		if(lag == 0)
+		{
+			// the cell is filled for this position : claim it
+			if(m_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if(lag < 0)
+		{
+			// the page of this position is not pushed yet
+			return false;
+		}
+		else
+		{
+			// another consumer claimed the position
+			position = m_popPosition.load(std::memory_order_relaxed);
+		}
+	}
+	item = std::move(cell->item);
+	// the cell keeps no reference on the pixels of the page
+	cell->item = PageItem();
+	// the cell is free for the position a turn of the ring later
+	cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+	wakeWaiters();
+	return true;
+}
+
+void	PageQueue::push(PageItem& item)
+{
+	while(!tryPush(item))
+	{
+		std::unique_lock<std::mutex>	lock(m_mutex);
+
+		// counted before the queue is read again : a pop that the waiter does not see sees the waiter (see wakeWaiters)
+		++m_waitersNb;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		m_changed.wait(lock, [this]() { return isPushable(); });
+		--m_waitersNb;
+	}
+}
+
+void	PageQueue::pop(PageItem& item)
+{
+	while(!tryPop(item))
+	{
+		std::unique_lock<std::mutex>	lock(m_mutex);
+
+		// counted before the queue is read again : a push that the waiter does not see sees the waiter (see wakeWaiters)
+		++m_waitersNb;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		m_changed.wait(lock, [this]() { return isPoppable(); });
+		--m_waitersNb;
+	}
+}
+
+bool	PageQueue::isPushable() const
+{
+	std::size_t		position = m_pushPosition.load(std::memory_order_relaxed);
+	std::intptr_t	lag = 0;
+
+	while(true)
+	{
+		lag = static_cast<std::intptr_t>(m_cells[position & m_mask].sequence.load(std::memory_order_acquire)) - static_cast<std::intptr_t>(position);
+		if(lag <= 0)
+		{
+			return lag == 0;
+		}
+		// the position was pushed since it was read
+		position = m_pushPosition.load(std::memory_order_relaxed);
+	}
+}
+
+bool	PageQueue::isPoppable() const
+{
+	std::size_t		position = m_popPosition.load(std::memory_order_relaxed);
+	std::intptr_t	lag = 0;
+
+	while(true)
+	{
+		lag = static_cast<std::intptr_t>(m_cells[position & m_mask].sequence.load(std::memory_order_acquire)) - static_cast<std::intptr_t>(position + 1);
+		if(lag <= 0)
+		{
+			return lag == 0;
+		}
+		// the position was popped since it was read
+		position = m_popPosition.load(std::memory_order_relaxed);
+	}
+}
+
+void	PageQueue::wakeWaiters()
+{
+	// the cell written is ordered with the count of the waiters, as the count is with the cells they read : either the waiter sees the cell, or the cell sees the waiter
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(m_waitersNb.load(std::memory_order_relaxed) > 0)
+	{
+		// the lock orders the cell with the test of a waiter going to sleep
+		{
+			std::lock_guard<std::mutex>	lock(m_mutex);
+		}
+		m_changed.notify_all();
+	}
+}
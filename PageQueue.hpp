@@ -0,0 +1,109 @@
+#ifndef PAGE_QUEUE_HPP
+#define PAGE_QUEUE_HPP
+#include <opencv2/core/core.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include "Staves.hpp"
+
+/*!
+	\struct PageItem
+	\brief PageItem stores a page of a batch between 2 stages of runBatch
+*/
+struct PageItem
+{
+	std::size_t				page;	///< index of the page in the batch, PAGE_ITEM_END to stop the stage reading it
+	cv::Mat					score;	///< decoded image of the page, released once its staves are set up
+	std::unique_ptr<Staves>	staves;	///< staves of the page once they are set up, nullptr if the setup failed
+};
+
+/*!
+	\brief
+	Index of the PageItem telling a stage that no page will follow
+*/
+std::size_t const	PAGE_ITEM_END = static_cast<std::size_t>(-1);
+
+/*!
+	\class PageQueue
+	\brief PageQueue is a bounded queue of pages between 2 stages, shared by any number of producers and consumers without lock : a ring of cells whose sequence numbers tell whether a cell is free for the producer of a position or filled for its consumer (the bounded queue of Dmitry Vyukov). A producer or a consumer only claims its position with a compare and swap : tryPush and tryPop fail when it is full or empty. The threads waiting for the queue sleep in push and pop, on a condition variable signalled by the pushes and the pops only when a thread waits (the pages go through the queue without lock)
+*/
+class PageQueue
+{
+	/*!
+		\struct Cell
+		\brief Cell stores a page of the ring and its sequence number : the position of the next push in the cell when it is free, this position + 1 once it is filled
+	 */
+	struct Cell
+	{
+		std::atomic<std::size_t>	sequence;
+		PageItem					item;
+	};
+
+	std::unique_ptr<Cell[]>				m_cells;
+	std::size_t							m_mask;
+	alignas(64) std::atomic<std::size_t>	m_pushPosition;
+	alignas(64) std::atomic<std::size_t>	m_popPosition;
+	alignas(64) std::atomic<std::size_t>	m_maxDepth;
+	std::atomic<unsigned int>				m_waitersNb;
+	std::mutex								m_mutex;
+	std::condition_variable					m_changed;
+
+public :
+	/*!
+		\param capacity number of pages the queue can hold, rounded up to a power of 2 (at least 2 : with a single cell, the sequence of a filled cell is the one of a free cell for the next push, see the constructor)
+	 */
+	explicit		PageQueue(std::size_t capacity);
+	std::size_t		getCapacity() const;
+	/*!
+		number of pages in the queue (approximate while the stages run)
+	 */
+	std::size_t		getDepth() const;
+	/*!
+		highest number of pages seen in the queue after a push
+	 */
+	std::size_t		getMaxDepth() const;
+	/*!
+		move item to the end of the queue, unless it is full
+
+		\param item page to push, moved only if it is pushed
+		\return false if the queue is full
+	 */
+	bool			tryPush(PageItem& item);
+	/*!
+		move the first page of the queue to item, unless it is empty
+
+		\param item page popped
+		\return false if the queue is empty
+	 */
+	bool			tryPop(PageItem& item);
+	/*!
+		tryPush, sleeping while the queue is full
+
+		\param item page to push
+	 */
+	void			push(PageItem& item);
+	/*!
+		tryPop, sleeping while the queue is empty
+
+		\param item page popped
+	 */
+	void			pop(PageItem& item);
+
+private :
+	/*!
+		whether the cell of the next push is free, without claiming it
+	 */
+	bool			isPushable() const;
+	/*!
+		whether the cell of the next pop is filled, without claiming it
+	 */
+	bool			isPoppable() const;
+	/*!
+		wake the threads sleeping in push and pop after a page was pushed or popped
+	 */
+	void			wakeWaiters();
+};
+
+#endif
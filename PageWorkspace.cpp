@@ -0,0 +1,91 @@
+#include "PageWorkspace.hpp"
+
+PageWorkspace::PageWorkspace() :
+	m_pool(new MatPool())
+{
+
+}
+
+PageWorkspace::~PageWorkspace()
+{
+	// the sub images still give their pixels back to the pool once it is given up
+	m_pool->release();
+}
+
+cv::MatAllocator*	PageWorkspace::getAllocator()
+{
+	return m_pool;
+}
+
+PageBuffers&	PageWorkspace::getPage()
+{
+	return m_page;
+}
+
+void	PageWorkspace::reset()
+{
+	// the headers are kept, only their pixels are given back
+	for(auto& subImage : m_page.subImages)
+	{
+		subImage.release();
+	}
+	m_pool->trim();
+}
+
+DetectionBuffers&	PageWorkspace::acquireStaveBuffers()
+{
+	std::lock_guard<std::mutex>	lock(m_mutex);
+	DetectionBuffers*			buffers = nullptr;
+
+	if(m_freeStaveBuffers.empty())
+	{
+		// a new task running at the same time as the others : the list of the free buffers must be able to hold all of them
+		m_staveBuffers.push_back(std::unique_ptr<DetectionBuffers>(new DetectionBuffers()));
+		m_freeStaveBuffers.reserve(m_staveBuffers.size());
+		return *m_staveBuffers.back();
+	}
+	buffers = m_freeStaveBuffers.back();
+	m_freeStaveBuffers.pop_back();
+	return *buffers;
+}
+
+void	PageWorkspace::releaseStaveBuffers(DetectionBuffers& buffers)
+{
+	std::lock_guard<std::mutex>	lock(m_mutex);
+
+	m_freeStaveBuffers.push_back(&buffers);
+}
+
+std::size_t		PageWorkspace::getStaveBuffersNb()
+{
+	std::lock_guard<std::mutex>	lock(m_mutex);
+
+	return m_staveBuffers.size();
+}
+
+std::size_t		PageWorkspace::getCreatedMatsNb() const
+{
+	return m_pool->getCreatedNb();
+}
+
+std::size_t		PageWorkspace::getReusedMatsNb() const
+{
+	return m_pool->getReusedNb();
+}
+
+StaveBuffersLease::StaveBuffersLease(PageWorkspace& workspace) :
+	m_workspace(workspace),
+	m_buffers(workspace.acquireStaveBuffers())
+{
+
+}
+
+StaveBuffersLease::~StaveBuffersLease()
+{
+	m_workspace.releaseStaveBuffers(m_buffers);
+}
+
+DetectionBuffers&	StaveBuffersLease::get()
+{
+	return m_buffers;
+}
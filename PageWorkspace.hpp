@@ -0,0 +1,106 @@
+#ifndef PAGE_WORKSPACE_HPP
+#define PAGE_WORKSPACE_HPP
+#include <opencv2/core/core.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "BitPlane.hpp"
+#include "runLengths.hpp"
+#include "staveDetection.hpp"
+#include "MatPool.hpp"
+#include "StripDeskewer.hpp"
+
+/*!
+	\struct PageBuffers
+	\brief PageBuffers stores the buffers of the steps of Staves::setup that run once for the whole page
+*/
+struct PageBuffers
+{
+	BitPlane						pagePlane;					///< page thresholded before the correction of its slope
+	std::vector<int>				profileVect;				///< row profile of the page corrected from its slope
+	RunStatistics					runStatistics;				///< see getRunStatistics
+	RunBuffers						runs;						///< see getRunStatistics
+	std::vector<int>				middleLineAbscs;			///< see detectMiddleLineAbsc
+	std::vector<int>				thicknessHistogram;			///< see getLineThicknessHistogram
+	std::vector<int>				bandLineAbscs;				///< middle lines of the bands whose rows are all read, see addLineThicknessHistogram
+	std::vector<std::vector<int>>	thicknessTaskHistograms;	///< see addLineThicknessHistogram
+	std::vector<int>				subImgCenters;				///< see extractSubImages
+	std::vector<int>				subImgOrigins;				///< see extractSubImages
+	std::vector<int>				subImgHeights;				///< see extractSubImages
+	std::vector<cv::Mat>			subImages;					///< see extractSubImages
+	DetectionBuffers				detection;					///< detection of the staves and slope of the page
+	cv::Mat							grayStrip;					///< last strip read from a StripSource to find the slope of the page
+	StripDeskewer					deskewer;					///< strips of a StripSource corrected from the slope of the page
+	BitPlane						correctedStrip;				///< last rows given by the deskewer
+	std::vector<int>				stripProfile;				///< row profile of correctedStrip
+	BitPlane						band;						///< corrected rows kept for the staves not set up yet
+	BitPlane						nextBand;					///< band of the next strip, swapped with band
+};
+
+/*!
+	\class PageWorkspace
+	\brief PageWorkspace stores everything Staves::setup needs from one page to another, so that the setup of a page of the size of the previous ones allocates nothing : the buffers of the page, the buffers of the tasks of the staves (one set for every task running at the same time, leased by the tasks, see StaveBuffersLease) and the pool of the pixels of the images (see MatPool). A workspace is used by one page at a time
+*/
+class PageWorkspace
+{
+	MatPool*										m_pool;
+	PageBuffers										m_page;
+	std::vector<std::unique_ptr<DetectionBuffers>>	m_staveBuffers;
+	std::vector<DetectionBuffers*>					m_freeStaveBuffers;
+	std::mutex										m_mutex;
+
+public :
+								PageWorkspace();
+	/*!
+		give up the pool : the images still using it keep their pixels (see MatPool::release)
+	 */
+								~PageWorkspace();
+								PageWorkspace(PageWorkspace const&) = delete;
+	PageWorkspace&				operator=(PageWorkspace const&) = delete;
+	/*!
+		allocator of the images of the page (see cv::Mat::allocator)
+	 */
+	cv::MatAllocator*			getAllocator();
+	PageBuffers&				getPage();
+	/*!
+		get ready for a new page : the sub images of the previous page are released and the pool frees the pixels that the previous page did not use
+	 */
+	void						reset();
+	/*!
+		buffers of a task, kept by the task until releaseStaveBuffers (see StaveBuffersLease)
+	 */
+	DetectionBuffers&			acquireStaveBuffers();
+	void						releaseStaveBuffers(DetectionBuffers& buffers);
+	/*!
+		number of sets of buffers of the tasks
+	 */
+	std::size_t					getStaveBuffersNb();
+	/*!
+		number of pixel buffers allocated by the pool (see MatPool::getCreatedNb)
+	 */
+	std::size_t					getCreatedMatsNb() const;
+	/*!
+		number of images given pixels already allocated by the pool (see MatPool::getReusedNb)
+	 */
+	std::size_t					getReusedMatsNb() const;
+};
+
+/*!
+	\class StaveBuffersLease
+	\brief StaveBuffersLease holds buffers of a workspace for a task (see PageWorkspace::acquireStaveBuffers), given back when it is destroyed
+*/
+class StaveBuffersLease
+{
+	PageWorkspace&		m_workspace;
+	DetectionBuffers&	m_buffers;
+
+public :
+	explicit			StaveBuffersLease(PageWorkspace& workspace);
+						~StaveBuffersLease();
+						StaveBuffersLease(StaveBuffersLease const&) = delete;
+	StaveBuffersLease&	operator=(StaveBuffersLease const&) = delete;
+	DetectionBuffers&	get();
+};
+
+#endif
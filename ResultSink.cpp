@@ -0,0 +1,234 @@
+#include "ResultSink.hpp"
+#include <opencv2/highgui/highgui.hpp>
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "Staves.hpp"
+
+/*!
+	\brief
+	Number of images waiting to be written by PngSink beyond which putImage waits for the writing thread
+*/
+static std::size_t const	PNG_SINK_QUEUE_MAX = 64;
+
+/*!
+	\brief
+	Name of a file from the name of an image : the characters other than letters, digits, '-' and '.' are replaced by '_'
+
+	\param name see ResultSink::putImage
+*/
+static std::string	getFileName(std::string const& name);
+
+/*!
+	\brief
+	JSON string of a text (between quotes, with the quotes, backslashes and control characters escaped)
+
+	\param text text to write
+*/
+static std::string	getJsonString(std::string const& text);
+
+ResultSink::~ResultSink()
+{
+
+}
+
+void	WindowSink::putImage(std::string const& name, cv::Mat const& img)
+{
+	cv::imshow(name, img);
+	cv::waitKey(0);
+}
+
+void	WindowSink::putGeometry(std::string const& pageName, Staves const& staves)
+{
+	static_cast<void>(pageName);
+	static_cast<void>(staves);
+}
+
+void	NullSink::putImage(std::string const& name, cv::Mat const& img)
+{
+	static_cast<void>(name);
+	static_cast<void>(img);
+}
+
+void	NullSink::putGeometry(std::string const& pageName, Staves const& staves)
+{
+	static_cast<void>(pageName);
+	static_cast<void>(staves);
+}
+
+PngSink::PngSink(std::string const& directory) :
+	m_directory(directory),
+	m_isClosed(false)
+{
+	m_writer = std::thread(&PngSink::write, this);
+}
+
+PngSink::~PngSink()
+{
+	{
+		std::lock_guard<std::mutex>	lock(m_mutex);
+		m_isClosed = true;
+	}
+	m_condition.notify_all();
+	m_writer.join();
+}
+
+void	PngSink::putImage(std::string const& name, cv::Mat const& img)
+{
+	// the image is copied out of the lock, the caller may write in it once putImage has returned
+	std::pair<std::string, cv::Mat>	file(m_directory + "/" + getFileName(name) + ".png", img.clone());
+	std::unique_lock<std::mutex>	lock(m_mutex);
+
+	m_condition.wait(lock, [this]() { return m_queue.size() < PNG_SINK_QUEUE_MAX; });
+	m_queue.push_back(std::move(file));
+	lock.unlock();
+	m_condition.notify_all();
+}
+
+void	PngSink::putGeometry(std::string const& pageName, Staves const& staves)
+{
+	static_cast<void>(pageName);
+	static_cast<void>(staves);
+}
+
+void	PngSink::write()
+{
+	std::pair<std::string, cv::Mat>	file;
+	std::unique_lock<std::mutex>	lock(m_mutex);
+
+	while(true)
+	{
+		m_condition.wait(lock, [this]() { return m_isClosed || !m_queue.empty(); });
+		if(m_queue.empty())
+		{
+			// closed and every image has been written
+			return;
+		}
+		file = std::move(m_queue.front());
+		m_queue.pop_front();
+		lock.unlock();
+		m_condition.notify_all();
+		if(!cv::imwrite(file.first, file.second))
+		{
+			std::cerr << "'" << file.first << "' can't be written" << std::endl;
+		}
+		lock.lock();
+	}
+}
+
+JsonSink::JsonSink(std::string const& path) :
+	m_stream(&std::cout)
+{
+	if(!path.empty())
+	{
+		m_file.open(path);
+		if(!m_file)
+		{
+			throw std::invalid_argument("'" + path + "' can't be written");
+		}
+		m_stream = &m_file;
+	}
+}
+
+void	JsonSink::putImage(std::string const& name, cv::Mat const& img)
+{
+	static_cast<void>(name);
+	static_cast<void>(img);
+}
+
+void	JsonSink::putGeometry(std::string const& pageName, Staves const& staves)
+{
+	std::ostringstream	json;
+
+	json << "{\"page\":" << getJsonString(pageName) << ",\"interline\":" << staves.getInterline() << ",\"thickness0\":" << staves.getThickness0() << ",\"thicknessAvg\":" << staves.getThicknessMoy() << ",\"staves\":[";
+	for(std::size_t i = 0; i < staves.getStaves().size(); ++i)
+	{
+		Stave const&	stave = staves.getStaves().at(i);
+
+		// the rows of the lines are the ones of the image of the stave, whose first row is the row origin of the page corrected from its slope
+		json << (i > 0 ? "," : "") << "{\"id\":" << stave.getId() << ",\"origin\":" << stave.getOrigin() << ",\"leftOrd\":" << stave.getLeftOrd() << ",\"rightOrd\":" << stave.getRightOrd() << ",\"hMax\":" << stave.getHMax() << ",\"lines\":[";
+		for(std::size_t l = 0; l < stave.getStaveLines().size(); ++l)
+		{
+			std::vector<int> const&	absCoords = stave.getStaveLines().at(l).getAbsCoords();
+
+			json << (l > 0 ? ",[" : "[");
+			for(std::size_t j = 0; j < absCoords.size(); ++j)
+			{
+				json << (j > 0 ? "," : "") << absCoords.at(j);
+			}
+			json << "]";
+		}
+		json << "]}";
+	}
+	json << "]}\n";
+	// the pages can be put by several threads, an object is written at once
+	std::lock_guard<std::mutex>	lock(m_mutex);
+	*m_stream << json.str() << std::flush;
+}
+
+std::unique_ptr<ResultSink>	makeResultSink(std::string const& description)
+{
+	if(description == "window")
+	{
+		return std::unique_ptr<ResultSink>(new WindowSink());
+	}
+	if(description == "null")
+	{
+		return std::unique_ptr<ResultSink>(new NullSink());
+	}
+	if(description.compare(0, 4, "png:") == 0 && description.size() > 4)
+	{
+		return std::unique_ptr<ResultSink>(new PngSink(description.substr(4)));
+	}
+	if(description == "json")
+	{
+		return std::unique_ptr<ResultSink>(new JsonSink(""));
+	}
+	if(description.compare(0, 5, "json:") == 0 && description.size() > 5)
+	{
+		return std::unique_ptr<ResultSink>(new JsonSink(description.substr(5)));
+	}
+	throw std::invalid_argument("unknown sink '" + description + "' (window, null, png:<directory>, json or json:<file>)");
+}
+
+static std::string	getFileName(std::string const& name)
+{
+	std::string	fileName = name;
+
+	for(auto& c : fileName)
+	{
+		if(!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.')
+		{
+			c = '_';
+		}
+	}
+	return fileName;
+}
+
+static std::string	getJsonString(std::string const& text)
+{
+	std::ostringstream	json;
+	char				escaped[8];
+
+	json << '"';
+	for(auto const& c : text)
+	{
+		if(c == '"' || c == '\\')
+		{
+			json << '\\' << c;
+		}
+		else if(static_cast<unsigned char>(c) < 0x20)
+		{
+			std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+			json << escaped;
+		}
+		else
+		{
+			json << c;
+		}
+	}
+	json << '"';
+	return json.str();
+}
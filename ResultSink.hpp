@@ -0,0 +1,120 @@
+#ifndef RESULT_SINK_HPP
+#define RESULT_SINK_HPP
+#include <opencv2/core/core.hpp>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+class Staves;
+
+/*!
+	\class ResultSink
+	\brief ResultSink receives what the stages produce for the user : the images of the stages (the staves with their lines, the erased lines, ...) and the geometry of the staves of every page. The stages never open a window themselves, so that the program can run on a server without display
+*/
+class ResultSink
+{
+public :
+	virtual			~ResultSink();
+	/*!
+		image produced by a stage
+
+		\param name name of the image (the title of its window)
+		\param img image in gray scale or in color, it can be modified by the caller once putImage has returned
+	 */
+	virtual void	putImage(std::string const& name, cv::Mat const& img) = 0;
+	/*!
+		geometry of the staves of a page once they are set up
+
+		\param pageName name of the page (the path of its image)
+		\param staves staves of the page
+	 */
+	virtual void	putGeometry(std::string const& pageName, Staves const& staves) = 0;
+};
+
+/*!
+	\class WindowSink
+	\brief WindowSink displays every image in a window and waits for a key, the geometry is not displayed
+*/
+class WindowSink : public ResultSink
+{
+public :
+	void	putImage(std::string const& name, cv::Mat const& img);
+	void	putGeometry(std::string const& pageName, Staves const& staves);
+};
+
+/*!
+	\class NullSink
+	\brief NullSink discards everything (to time the stages)
+*/
+class NullSink : public ResultSink
+{
+public :
+	void	putImage(std::string const& name, cv::Mat const& img);
+	void	putGeometry(std::string const& pageName, Staves const& staves);
+};
+
+/*!
+	\class PngSink
+	\brief PngSink writes every image in a PNG file of a directory, named after the image. The files are written by a thread of their own : putImage only copies the image, unless PNG_SINK_QUEUE_MAX images are already waiting to be written. The geometry is not written
+*/
+class PngSink : public ResultSink
+{
+	std::string										m_directory;
+	std::deque<std::pair<std::string, cv::Mat>>		m_queue;
+	std::mutex										m_mutex;
+	std::condition_variable							m_condition;
+	bool											m_isClosed;
+	std::thread										m_writer;
+
+public :
+	/*!
+		\param directory existing directory of the files
+	 */
+	explicit	PngSink(std::string const& directory);
+	/*!
+		wait for all the images to be written
+	 */
+				~PngSink();
+	void		putImage(std::string const& name, cv::Mat const& img);
+	void		putGeometry(std::string const& pageName, Staves const& staves);
+
+private :
+	/*!
+		loop of the writing thread
+	 */
+	void		write();
+};
+
+/*!
+	\class JsonSink
+	\brief JsonSink writes the geometry of the staves of every page as one JSON object per line (interline, thicknesses, and for every stave its ordinates and the rows of its 5 lines at every column), the images are discarded
+*/
+class JsonSink : public ResultSink
+{
+	std::ofstream	m_file;
+	std::ostream*	m_stream;
+	std::mutex		m_mutex;
+
+public :
+	/*!
+		\param path file of the JSON objects, the standard output if path is empty
+	 */
+	explicit	JsonSink(std::string const& path);
+	void		putImage(std::string const& name, cv::Mat const& img);
+	void		putGeometry(std::string const& pageName, Staves const& staves);
+};
+
+/*!
+	\brief
+	Sink described by the value of the argument "sink=" : "window", "null", "png:<directory>", "json" (standard output) or "json:<file>". Throw std::invalid_argument for any other description
+
+	\param description description of the sink
+*/
+std::unique_ptr<ResultSink>	makeResultSink(std::string const& description);
+
+#endif
@@ -0,0 +1,82 @@
+#include "SlopeModel.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+SlopeModel::SlopeModel(int residualRange, int fallbackRange) :
+	m_page({0, 0.0, 0.0, 0.0}),
+	m_residualRange(residualRange),
+	m_fallbackRange(std::max(residualRange, fallbackRange))
+{
+
+}
+
+SlopeEstimate const&	SlopeModel::getPageEstimate() const
+{
+	return m_page;
+}
+
+std::vector<SlopeEstimate> const&	SlopeModel::getStaveEstimates() const
+{
+	return m_staves;
+}
+
+int		SlopeModel::getResidualRange() const
+{
+	return m_residualRange;
+}
+
+int		SlopeModel::getFallbackRange() const
+{
+	return m_fallbackRange;
+}
+
+double	SlopeModel::getStaveHMax(unsigned int id) const
+{
+	return m_appliedHMaxs.at(id) + m_staves.at(id).hMaxSub;
+}
+
+void	SlopeModel::setupPage(cv::Mat const& binaryImg)
+{
+	setupPage(estimateSlope(binaryImg));
+}
+
+void	SlopeModel::setupPage(SlopeEstimate const& pageEstimate)
+{
+	m_page = pageEstimate;
+	m_staves.clear();
+	m_appliedHMaxs.clear();
+}
+
+SlopeEstimate const&	SlopeModel::addStave(cv::Mat const& staveImg, int appliedHMax)
+{
+	reserveStaves(1);
+	return setStave(static_cast<unsigned int>(m_staves.size()) - 1, staveImg, appliedHMax);
+}
+
+void	SlopeModel::reserveStaves(unsigned int stavesNb)
+{
+	m_staves.resize(m_staves.size() + stavesNb, {0, 0.0, 0.0, 0.0});
+	m_appliedHMaxs.resize(m_appliedHMaxs.size() + stavesNb, 0);
+}
+
+SlopeEstimate const&	SlopeModel::setStave(unsigned int id, cv::Mat const& staveImg, int appliedHMax)
+{
+	SlopeBuffers	buffers;
+
+	return setStave(id, staveImg, appliedHMax, buffers);
+}
+
+SlopeEstimate const&	SlopeModel::setStave(unsigned int id, cv::Mat const& staveImg, int appliedHMax, SlopeBuffers& buffers)
+{
+	int				prior = m_page.hMax - appliedHMax;
+	SlopeEstimate	estimate = estimateSlopeAround(staveImg, prior, m_residualRange, buffers);
+
+	// the best shift of the window is on its border : the stave does not follow the page, the wide window is searched around the prior at full resolution (estimateSlope would only search 2% of the few rows of the stave)
+	if(std::abs(estimate.hMax - prior) == m_residualRange)
+	{
+		estimate = estimateSlopeAround(staveImg, prior, m_fallbackRange, buffers);
+	}
+	m_staves.at(id) = estimate;
+	m_appliedHMaxs.at(id) = appliedHMax;
+	return m_staves.at(id);
+}
@@ -0,0 +1,80 @@
+#ifndef SLOPE_MODEL_HPP
+#define SLOPE_MODEL_HPP
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "staveDetection.hpp"
+
+/*!
+	\class SlopeModel
+	\brief SlopeModel stores the slope of a page of score and the residual slope of each of its staves. The slope of the page is the prior of the slope of every stave : a stave is only searched in a narrow window of shifts around it
+*/
+class SlopeModel
+{
+	SlopeEstimate				m_page;
+	std::vector<SlopeEstimate>	m_staves;
+	std::vector<int>			m_appliedHMaxs;
+	int							m_residualRange;
+	int							m_fallbackRange;
+
+public :
+	/*!
+		\param residualRange half size of the window of shifts searched around the prior for every stave
+		\param fallbackRange half size of the window searched around the prior when the best shift is on the border of the narrow one (the range of correlation by default)
+	 */
+	explicit							SlopeModel(int residualRange = 3, int fallbackRange = 30);
+	SlopeEstimate const&				getPageEstimate() const;
+	/*!
+		residual estimates of the staves in the order they were added (relative to the image given to addStave or setStave)
+	 */
+	std::vector<SlopeEstimate> const&	getStaveEstimates() const;
+	int									getResidualRange() const;
+	int									getFallbackRange() const;
+	/*!
+		vertical shift between the left and right halves of the stave in the page before any correction : the correction already applied to the image of the stave plus its sub pixel residual
+
+		\param id index of the stave (order of addStave or slot of setStave)
+	 */
+	double								getStaveHMax(unsigned int id) const;
+	/*!
+		search the slope of the whole page and forget the staves of the previous page
+
+		\param binaryImg binarized page of score
+	 */
+	void								setupPage(cv::Mat const& binaryImg);
+	/*!
+		record the slope of a page estimated elsewhere (see preprocessScore) and forget the staves of the previous page
+
+		\param pageEstimate slope of the whole page
+	 */
+	void								setupPage(SlopeEstimate const& pageEstimate);
+	/*!
+		search the residual slope of a stave in [prior - residualRange; prior + residualRange] where the prior is the slope of the page minus the correction already applied to the image of the stave. A peak on the border of the window is not trusted and [prior - fallbackRange; prior + fallbackRange] is searched instead. The estimate is recorded and returned
+
+		\param staveImg binarized image of the stave
+		\param appliedHMax shift already corrected in staveImg (the hMax of the page when the stave is extracted from the corrected page)
+	 */
+	SlopeEstimate const&				addStave(cv::Mat const& staveImg, int appliedHMax);
+	/*!
+		allocate the slots of stavesNb staves after the staves already recorded, to be filled by setStave
+	 */
+	void								reserveStaves(unsigned int stavesNb);
+	/*!
+		search the residual slope of a stave as addStave does, but record it in its slot (see reserveStaves) : the slots of different staves can be filled in any order and by several threads at the same time
+
+		\param id index of the slot of the stave
+		\param staveImg see addStave
+		\param appliedHMax see addStave
+	 */
+	SlopeEstimate const&				setStave(unsigned int id, cv::Mat const& staveImg, int appliedHMax);
+	/*!
+		setStave with the buffers of the caller : every thread filling slots needs its own buffers
+
+		\param id index of the slot of the stave
+		\param staveImg see addStave
+		\param appliedHMax see addStave
+		\param buffers see SlopeBuffers
+	 */
+	SlopeEstimate const&				setStave(unsigned int id, cv::Mat const& staveImg, int appliedHMax, SlopeBuffers& buffers);
+};
+
+#endif
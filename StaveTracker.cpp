@@ -0,0 +1,169 @@
+#include "StaveTracker.hpp"
+
+/*!
+	\brief
+	Weight of the previous column in the smoothing of the correlations (SMOOTHING)
+*/
+static double const	TRACKER_ALPHA = 0.98;
+
+/*!
+	\brief
+	Number of columns between the last column added and the last decided one (VITERBI) : the best paths ending in the different shifts have merged after a few interlines
+*/
+static int const	TRACKER_VITERBI_LAG = 64;
+
+/*!
+	\brief
+	Normalized correlation lost by a path when its shift changes by 1 between 2 columns (VITERBI)
+*/
+static double const	TRACKER_TRANSITION_COST = 0.1;
+
+StaveTracker::StaveTracker(int shiftRange, double normalization, TrackingMode mode) :
+	m_mode(mode),
+	m_shiftRange(shiftRange),
+	m_normalization(normalization),
+	m_shift(0),
+	m_columnsNb(0)
+{
+
+}
+
+TrackingMode	StaveTracker::getMode() const
+{
+	return m_mode;
+}
+
+int		StaveTracker::getShiftRange() const
+{
+	return m_shiftRange;
+}
+
+void	StaveTracker::setup(int shiftRange, double normalization, TrackingMode mode)
+{
+	m_mode = mode;
+	m_shiftRange = shiftRange;
+	m_normalization = normalization;
+	m_shift = 0;
+	m_columnsNb = 0;
+	m_shifts.clear();
+}
+
+void	StaveTracker::start(int const* correlations, int shift)
+{
+	int	shiftsNb = 2 * m_shiftRange + 1;
+
+	m_scores.resize(shiftsNb);
+	m_previousScores.resize(shiftsNb);
+	m_shifts.clear();
+	for(int s = 0; s < shiftsNb; ++s)
+	{
+		m_scores[s] = correlations[s] / m_normalization;
+	}
+	m_shift = shift;
+	m_columnsNb = 1;
+	if(m_mode == TrackingMode::SMOOTHING)
+	{
+		m_shifts.push_back(shift);
+	}
+	else
+	{
+		m_backPointers.assign(TRACKER_VITERBI_LAG * shiftsNb, 0);
+	}
+}
+
+void	StaveTracker::addColumn(int const* correlations)
+{
+	int				shiftsNb = 2 * m_shiftRange + 1;
+	double			maxCor = 0.0;
+	double			correlation = 0.0;
+	int				bestShift = 0;
+	signed char*	backPointers = nullptr;
+
+	if(m_mode == TrackingMode::SMOOTHING)
+	{
+		for(int s = 0; s < shiftsNb; ++s)
+		{
+			// update the value of the correlation by weighting its value with the one of the previous column
+			correlation = correlations[s] / m_normalization;
+			correlation *= (1.0 - TRACKER_ALPHA);
+			correlation += (m_scores[s] * TRACKER_ALPHA);
+			m_scores[s] = correlation;
+			// the shift of the previous column is kept when no smoothed correlation is positive
+			if(correlation > maxCor)
+			{
+				maxCor = correlation;
+				m_shift = s - m_shiftRange;
+			}
+		}
+		m_shifts.push_back(m_shift);
+		++m_columnsNb;
+		return;
+	}
+	m_scores.swap(m_previousScores);
+	backPointers = m_backPointers.data() + (m_columnsNb % TRACKER_VITERBI_LAG) * shiftsNb;
+	for(int s = 0; s < shiftsNb; ++s)
+	{
+		// the path can come from the same shift or from one of its 2 neighbours
+		backPointers[s] = 0;
+		maxCor = m_previousScores[s];
+		for(int d = -1; d <= 1; d += 2)
+		{
+			if(s + d >= 0 && s + d < shiftsNb && m_previousScores[s + d] - TRACKER_TRANSITION_COST > maxCor)
+			{
+				maxCor = m_previousScores[s + d] - TRACKER_TRANSITION_COST;
+				backPointers[s] = d;
+			}
+		}
+		m_scores[s] = maxCor + correlations[s] / m_normalization;
+		if(m_scores[s] > m_scores[bestShift])
+		{
+			bestShift = s;
+		}
+	}
+	++m_columnsNb;
+	if(m_columnsNb > TRACKER_VITERBI_LAG)
+	{
+		decide(m_columnsNb - 1 - TRACKER_VITERBI_LAG, bestShift);
+	}
+}
+
+std::vector<int> const&		StaveTracker::finish()
+{
+	int	bestShift = 0;
+
+	if(m_mode == TrackingMode::VITERBI && m_columnsNb > 0)
+	{
+		for(int s = 1; s < 2 * m_shiftRange + 1; ++s)
+		{
+			if(m_scores[s] > m_scores[bestShift])
+			{
+				bestShift = s;
+			}
+		}
+		decide(m_columnsNb - 1, bestShift);
+	}
+	return m_shifts;
+}
+
+void	StaveTracker::decide(int column, int lastShift)
+{
+	int	shiftsNb = 2 * m_shiftRange + 1;
+	int	firstColumn = static_cast<int>(m_shifts.size());
+	int	s = lastShift;
+
+	m_pathShifts.resize(m_columnsNb - firstColumn);
+
+	// walk the best path back from the last column (its choices are in the ring buffer for the TRACKER_VITERBI_LAG last columns)
+	for(int c = m_columnsNb - 1; c >= firstColumn; --c)
+	{
+		m_pathShifts[c - firstColumn] = s - m_shiftRange;
+		if(c > firstColumn)
+		{
+			s += m_backPointers[(c % TRACKER_VITERBI_LAG) * shiftsNb + s];
+		}
+	}
+	for(int c = firstColumn; c <= column; ++c)
+	{
+		m_shifts.push_back(m_pathShifts[c - firstColumn]);
+	}
+}
@@ -0,0 +1,76 @@
+#ifndef STAVE_TRACKER_HPP
+#define STAVE_TRACKER_HPP
+#include <vector>
+
+/*!
+	\brief
+	Choice of the shift of the middle line of a stave at every column by StaveTracker
+*/
+enum class TrackingMode
+{
+	SMOOTHING,	///< the correlations are smoothed from left to right and every column takes the best smoothed shift (as in the thesis)
+	VITERBI		///< the shifts form the path of best total correlation whose shift changes by 1 at most from one column to the next
+};
+
+/*!
+	\class StaveTracker
+	\brief StaveTracker follows the middle line of a stave from left to right, one column of correlations between the mask of the stave and the image at a time (see getMiddleLineAbsc). It only keeps the state of the last column, and in the VITERBI mode a ring buffer of the choices of the last TRACKER_VITERBI_LAG columns : the shift of a column is decided once the lag is over, so that the memory does not depend on the width of the stave
+*/
+class StaveTracker
+{
+	TrackingMode				m_mode;
+	int							m_shiftRange;
+	double						m_normalization;
+	int							m_shift;
+	int							m_columnsNb;
+	std::vector<double>			m_scores;
+	std::vector<double>			m_previousScores;
+	std::vector<signed char>	m_backPointers;
+	std::vector<int>			m_shifts;
+	std::vector<int>			m_pathShifts;
+
+public :
+	/*!
+		\param shiftRange the shifts of a column are in [-shiftRange; shiftRange]
+		\param normalization the correlations are divided by normalization (the height of the mask) before being compared
+		\param mode see TrackingMode
+	 */
+								StaveTracker(int shiftRange, double normalization, TrackingMode mode);
+	TrackingMode				getMode() const;
+	int							getShiftRange() const;
+	/*!
+		change the parameters of the tracker for the next stave, its buffers are kept
+
+		\param shiftRange see StaveTracker
+		\param normalization see StaveTracker
+		\param mode see StaveTracker
+	 */
+	void						setup(int shiftRange, double normalization, TrackingMode mode);
+	/*!
+		first column of the stave
+
+		\param correlations 2 * shiftRange + 1 integer correlations, from the shift -shiftRange
+		\param shift shift chosen for the first column in the SMOOTHING mode
+	 */
+	void						start(int const* correlations, int shift);
+	/*!
+		next column of the stave, its shift is decided now (SMOOTHING) or TRACKER_VITERBI_LAG columns later (VITERBI)
+
+		\param correlations see start
+	 */
+	void						addColumn(int const* correlations);
+	/*!
+		decide the shifts of the last columns
+
+		\return the shift of every column since start
+	 */
+	std::vector<int> const&		finish();
+
+private :
+	/*!
+		shifts of the columns [m_shifts.size(); column] in the best path ending at the shift lastShift of the last column added
+	 */
+	void						decide(int column, int lastShift);
+};
+
+#endif
@@ -1,5 +1,111 @@
 #include "Staves.hpp"
-#include "Bivector.hpp"
+#include "profiles.hpp"
+#include "runLengths.hpp"
+#include "TaskPool.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+/*!
+	\brief
+	Only one column every INTERLINE_SAMPLING_STEP columns is followed to find the interline of a page : the thicknesses of the lines come from the bands around the staves, the vertical runs of the page only give its interline (the most frequent distance between 2 lines is read in any sample of the columns)
+*/
+static int const	INTERLINE_SAMPLING_STEP = 4;
+
+/*!
+	\brief
+	Highest gray level of a black pixel of the page binarized with the fixed threshold
+*/
+static unsigned char const	FIXED_THRESH = 220;
+
+/*!
+	\brief
+	Value of the white pixels of the binarized images
+*/
+static unsigned char const	WHITE = 255;
+
+/*!
+	\brief
+	Value of the black pixels of the binarized images
+*/
+static unsigned char const	BLACK = 0;
+
+/*!
+	\struct EraseBuffers
+	\brief EraseBuffers stores the state of every column of a line of stave in eraseLine
+*/
+struct EraseBuffers
+{
+	std::vector<int>			xUps;	///< top of the vertical black segment around the line
+	std::vector<int>			xDowns;	///< bottom of the vertical black segment around the line
+	std::vector<unsigned char>	whites;	///< whether the pixel of the previous row read is white
+};
+
+/*!
+	\class EraseBody
+	\brief Erasure of the lines of a range of staves for parallelFor, every stave is written in its own image
+*/
+class EraseBody : public cv::ParallelLoopBody
+{
+	std::vector<Stave>&	m_staves;
+	int					m_thicknessThresh;
+
+public :
+	EraseBody(std::vector<Stave>& staves, int thicknessThresh);
+	void	operator()(cv::Range const& staves) const;
+};
+
+/*!
+	\class StaveSetupBody
+	\brief Setup of a range of staves for parallelFor once the page level values are known : every stave goes through the row of its middle line in its sub image, its left and right ordinates and the tracking of its middle line on its own, and is set up in its preallocated slot
+*/
+class StaveSetupBody : public cv::ParallelLoopBody
+{
+	std::vector<Stave>&				m_staves;
+	std::vector<cv::Mat> const&		m_subImg;
+	std::vector<int> const&			m_subImgOrigins;
+	SlopeModel const&				m_slopeModel;
+	int								m_interline;
+	double							m_thicknessAvg;
+	int								m_thickness0;
+	TrackingMode					m_trackingMode;
+	PageWorkspace&					m_workspace;
+
+public :
+	/*!
+		\param staves one stave for every sub image, set up by the tasks
+		\param workspace buffers of the tasks
+	 */
+	StaveSetupBody(std::vector<Stave>& staves, std::vector<cv::Mat> const& subImg, std::vector<int> const& subImgOrigins, SlopeModel const& slopeModel, int interline, double thicknessAvg, int thickness0, TrackingMode trackingMode, PageWorkspace& workspace);
+	void	operator()(cv::Range const& staves) const;
+};
+
+/*!
+	\brief
+	Erase the pixels of a line of stave in the columns [leftOrd; leftOrd + lineAbscs.size()[ of the image of the stave. In a column, the vertical black segment around the line goes up and down from the line until 2 white pixels in a row (the rows out of the image are white). It is erased if it is not thicker than thicknessThresh (criteria 1) and does not go as far as thicknessThresh above (criteria 2) nor below (criteria 3) the line. Instead of following every segment, the ends of the segments are found a row at a time over the columns where the line stays on the same row (see findSegmentEnds)
+
+	\param staveImg image of the stave
+	\param lineAbscs see StaveLine::getAbsCoords
+	\param leftOrd see Stave::getLeftOrd
+	\param thicknessThresh see Staves::erase
+	\param buffers buffers of the columns, reused from one line to another
+*/
+static void	eraseLine(cv::Mat& staveImg, std::vector<int> const& lineAbscs, int leftOrd, int thicknessThresh, EraseBuffers& buffers);
+
+/*!
+	\brief
+	Ends of the vertical black segments around a line of stave over a segment of columns where the line stays on the same row (see eraseLine) : the rows are read from thicknessThresh rows above the line down to it, then from thicknessThresh rows below the line up to it. The rows out of the image are white
+
+	\param staveImg image of the stave
+	\param x row of the line
+	\param firstCol first column of the segment
+	\param width number of columns of the segment
+	\param thicknessThresh see Staves::erase
+	\param xUps top of the segment of every column, x - thicknessThresh if it is not found within thicknessThresh rows
+	\param xDowns bottom of the segment of every column, x + thicknessThresh if it is not found within thicknessThresh rows
+	\param whites buffer of the colors of the previous row read
+*/
+static void	findSegmentEnds(cv::Mat const& staveImg, int x, int firstCol, int width, int thicknessThresh, int* xUps, int* xDowns, unsigned char* whites);
 
 // StaveLine implementation
 StaveLine::StaveLine(unsigned int id) :
@@ -22,6 +128,7 @@ void	StaveLine::setup(std::vector<int> const&	middleLineAbscs, int interline)
 {
 	int	shift = (interline) * (m_id - 2);
 	int	vectorSize = middleLineAbscs.size();
+	m_absCoords.clear();
 	m_absCoords.reserve(middleLineAbscs.size());
 	for(int i = 0; i < vectorSize; ++i)
 	{
@@ -36,6 +143,64 @@ Stave::Stave(unsigned int id) :
 	
 }
 
+Stave::Stave(Stave const& stave) :
+	m_id(stave.m_id),
+	m_staveLines(stave.m_staveLines),
+	m_staveImg(stave.m_isImgShared ? stave.m_staveImg : stave.m_staveImg.clone()),
+	m_origin(stave.m_origin),
+	m_isImgShared(stave.m_isImgShared),
+	m_leftOrd(stave.m_leftOrd),
+	m_rightOrd(stave.m_rightOrd),
+	m_hMax(stave.m_hMax)
+{
+
+}
+
+Stave::Stave(Stave&& stave) noexcept :
+	m_id(stave.m_id),
+	m_staveLines(std::move(stave.m_staveLines)),
+	m_staveImg(std::move(stave.m_staveImg)),
+	m_origin(stave.m_origin),
+	m_isImgShared(stave.m_isImgShared),
+	m_leftOrd(stave.m_leftOrd),
+	m_rightOrd(stave.m_rightOrd),
+	m_hMax(stave.m_hMax)
+{
+
+}
+
+Stave&	Stave::operator=(Stave const& stave)
+{
+	if(this != &stave)
+	{
+		m_id = stave.m_id;
+		m_staveLines = stave.m_staveLines;
+		m_staveImg = stave.m_isImgShared ? stave.m_staveImg : stave.m_staveImg.clone();
+		m_origin = stave.m_origin;
+		m_isImgShared = stave.m_isImgShared;
+		m_leftOrd = stave.m_leftOrd;
+		m_rightOrd = stave.m_rightOrd;
+		m_hMax = stave.m_hMax;
+	}
+	return *this;
+}
+
+Stave&	Stave::operator=(Stave&& stave) noexcept
+{
+	if(this != &stave)
+	{
+		m_id = stave.m_id;
+		m_staveLines = std::move(stave.m_staveLines);
+		m_staveImg = std::move(stave.m_staveImg);
+		m_origin = stave.m_origin;
+		m_isImgShared = stave.m_isImgShared;
+		m_leftOrd = stave.m_leftOrd;
+		m_rightOrd = stave.m_rightOrd;
+		m_hMax = stave.m_hMax;
+	}
+	return *this;
+}
+
 std::vector<StaveLine> const&	Stave::getStaveLines() const
 {
 	return m_staveLines;
@@ -46,6 +211,21 @@ cv::Mat const&	Stave::getStaveImg() const
 	return m_staveImg;
 }
 
+cv::Mat&	Stave::getEditableStaveImg()
+{
+	if(m_isImgShared)
+	{
+		m_staveImg = m_staveImg.clone();
+		m_isImgShared = false;
+	}
+	return m_staveImg;
+}
+
+int		Stave::getOrigin() const
+{
+	return m_origin;
+}
+
 int		Stave::getId() const
 {
 	return m_id;
@@ -61,9 +241,15 @@ int	Stave::getRightOrd() const
 	return m_rightOrd;
 }
 
+double	Stave::getHMax() const
+{
+	return m_hMax;
+}
+
 void	Stave::setStaveImg(cv::Mat const& img)
 {
 	m_staveImg = img;
+	m_isImgShared = true;
 }
 
 // Staves implementation
@@ -98,72 +284,224 @@ cv::Mat const&	Staves::getScore() const
 	return m_score;
 }
 
-void	Stave::setup(cv::Mat subImg, int leftOrd, int rightOrd, std::vector<int> middleLineAbscs, int interline)
+BitPlane const&	Staves::getScorePlane() const
+{
+	return m_scorePlane;
+}
+
+SlopeModel const&	Staves::getSlopeModel() const
+{
+	return m_slopeModel;
+}
+
+void	Stave::setup(cv::Mat const& subImg, int origin, int leftOrd, int rightOrd, std::vector<int> const& middleLineAbscs, int interline, double hMax)
 {
-	std::vector<StaveLine>	staveLines;
 	unsigned int			staveLinesSize = 5;
 
-	m_staveImg = subImg.clone();
+	// the image is shared with the page (or with the corrected copy made by extractSubImages), it is copied by the first stage writing in it
+	m_staveImg = subImg;
+	m_isImgShared = true;
+	m_origin = origin;
 	m_leftOrd = leftOrd;
 	m_rightOrd = rightOrd;
-	staveLines.reserve(staveLinesSize);
-
-	for(unsigned int i = 0; i < staveLinesSize; ++i)
+	m_hMax = hMax;
+	// the lines of a stave set up again keep their memory
+	for(unsigned int i = static_cast<unsigned int>(m_staveLines.size()); i < staveLinesSize; ++i)
+	{
+		m_staveLines.push_back(StaveLine(i));
+	}
+	for(auto& staveLine : m_staveLines)
 	{
-		StaveLine staveLine(i);	
 		staveLine.setup(middleLineAbscs, interline);
-		staveLines.push_back(staveLine);
 	}
-	m_staveLines = staveLines;
 }
 
-void	Staves::setup(cv::Mat const& score)
+void	Staves::setup(cv::Mat const& score, BinarizationMode mode, TrackingMode trackingMode)
+{
+	PageWorkspace	workspace;
+
+	setup(score, workspace, mode, trackingMode);
+}
+
+void	Staves::setup(cv::Mat const& score, PageWorkspace& workspace, BinarizationMode mode, TrackingMode trackingMode)
+{
+	PageBuffers&		page = workspace.getPage();
+	RunStatistics&		runStatistics = page.runStatistics;
+
+	workspace.reset();
+	preprocessScore(score, FIXED_THRESH, m_slopeModel, m_scorePlane, page.profileVect, page.pagePlane, page.detection.slope);
+	if(mode != BinarizationMode::FIXED)
+	{
+		// the interline of the page binarized with the fixed threshold gives the window of the adaptive threshold (a sample of the columns is enough). The slope is searched again on the binarized page (its pixels are either 0 or 255) : the fixed threshold is the one that fails on the pages lit unevenly
+		getRunStatistics(m_scorePlane, INTERLINE_SAMPLING_STEP, runStatistics, page.runs);
+		preprocessScoreWithPrior(binarizeAdaptive(score, mode, getBinarizationWindowSize(runStatistics.interline)), 0, m_slopeModel.getPageEstimate(), m_slopeModel, m_scorePlane, page.profileVect, page.pagePlane, page.detection.slope);
+	}
+	// the pixels of the page come from the pool of the workspace : the staves of the previous page may still share the previous ones
+	m_score.release();
+	m_score.allocator = workspace.getAllocator();
+	m_scorePlane.toMat(m_score);
+	m_score.allocator = nullptr;
+	// interline from the vertical runs of a sample of the columns of the page, thicknesses of the lines from the runs of the bands around the staves only (the runs of the text and of the drawings out of the staves are left out)
+	getRunStatistics(m_scorePlane, INTERLINE_SAMPLING_STEP, runStatistics, page.runs);
+	m_interline = runStatistics.interline;
+	detectMiddleLineAbsc(page.profileVect, m_interline, page.detection, page.middleLineAbscs);
+	m_stavesNb = static_cast<unsigned int>(page.middleLineAbscs.size());
+	page.thicknessHistogram.assign(std::max(0, 6 * m_interline), 0);
+	addLineThicknessHistogram(page.middleLineAbscs, 6 * m_interline, m_scorePlane, page.thicknessHistogram, page.thicknessTaskHistograms);
+	setThicknesses(page.thicknessHistogram);
+	extractSubImages(m_score, page.middleLineAbscs, m_interline, m_slopeModel, workspace);
+	// the staves only share the values of the page from here : each one is set up in its own slot, whatever the number of threads
+	resizeStaves();
+	parallelFor(cv::Range(0, static_cast<int>(m_stavesNb)), StaveSetupBody(m_staves, page.subImages, page.subImgOrigins, m_slopeModel, m_interline, m_thicknessAvg, m_thickness0, trackingMode, workspace));
+}
+
+void	Staves::setup(StripSource& source, PageWorkspace& workspace, int stripRows, bool isKeepingImages, TrackingMode trackingMode)
+{
+	PageBuffers&		page = workspace.getPage();
+	RunStatistics&		runStatistics = page.runStatistics;
+	BitPlane&			strip = page.correctedStrip;
+	cv::Mat				bandImg;
+	int					rows = source.getRows();
+	int					cols = source.getCols();
+	int					readNb = 0;
+	int					firstRow = 0;
+	int					bandStart = 0;
+	int					bandOrigin = 0;
+	int					bandEnd = 0;
+	int					keepFrom = 0;
+	int					heightSize = 0;
+	int					halfHeightSize = 0;
+	unsigned int		nextStave = 0;
+	unsigned int		readyStave = 0;
+
+	CV_Assert(stripRows > 0);
+	if(rows == 0 || cols == 0)
+	{
+		throw std::invalid_argument("the page read by strips is empty");
+	}
+	workspace.reset();
+	m_score.release();
+	m_scorePlane = BitPlane();
+	// 1st reading : the slope of the page from its packed halves
+	source.rewind();
+	for(bool isFirstStrip = true; source.read(stripRows, page.grayStrip) > 0; isFirstStrip = false)
+	{
+		addStripHalves(page.grayStrip, FIXED_THRESH, isFirstStrip, page.detection.slope);
+	}
+	m_slopeModel.setupPage(estimateSlopeOfHalves(cols, page.detection.slope));
+	// 2nd reading : the profile and the vertical runs (for the interline) of the corrected rows, the rows are forgotten once they are counted
+	page.profileVect.resize(rows);
+	beginRunStatistics(rows, cols, INTERLINE_SAMPLING_STEP, runStatistics, page.runs);
+	page.deskewer.start(source, FIXED_THRESH, m_slopeModel.getPageEstimate().hMax, stripRows);
+	for(firstRow = 0; (readNb = page.deskewer.next(source, strip)) > 0; firstRow += readNb)
+	{
+		getRowProfile(strip, page.stripProfile);
+		std::copy(page.stripProfile.begin(), page.stripProfile.end(), page.profileVect.begin() + firstRow);
+		addRunStatisticsRows(strip, firstRow, runStatistics, page.runs);
+	}
+	endRunStatistics(rows, runStatistics, page.runs);
+	m_interline = runStatistics.interline;
+	detectMiddleLineAbsc(page.profileVect, m_interline, page.detection, page.middleLineAbscs);
+	m_stavesNb = static_cast<unsigned int>(page.middleLineAbscs.size());
+	// 3rd reading : the thicknesses of the lines from the runs of the bands around the staves, a band is counted once all its rows are read
+	heightSize = std::max(0, 6 * m_interline);
+	halfHeightSize = std::round(heightSize / 2.0);
+	page.thicknessHistogram.assign(heightSize, 0);
+	page.deskewer.start(source, FIXED_THRESH, m_slopeModel.getPageEstimate().hMax, stripRows);
+	page.band.create(0, cols);
+	bandStart = 0;
+	for(firstRow = 0; nextStave < m_stavesNb && (readNb = page.deskewer.next(source, strip)) > 0; firstRow += readNb)
+	{
+		keepFrom = std::max(bandStart, std::min(firstRow, page.middleLineAbscs.at(nextStave) - halfHeightSize));
+		page.nextBand.create(firstRow + readNb - keepFrom, cols);
+		page.nextBand.copyRows(page.band, keepFrom - bandStart, 0, firstRow - keepFrom);
+		page.nextBand.copyRows(strip, 0, firstRow - keepFrom, readNb);
+		std::swap(page.band, page.nextBand);
+		bandStart = keepFrom;
+		page.bandLineAbscs.clear();
+		while(nextStave < m_stavesNb && (page.middleLineAbscs.at(nextStave) + halfHeightSize <= firstRow + readNb || firstRow + readNb == rows))
+		{
+			page.bandLineAbscs.push_back(page.middleLineAbscs.at(nextStave) - bandStart);
+			++nextStave;
+		}
+		addLineThicknessHistogram(page.bandLineAbscs, heightSize, page.band, page.thicknessHistogram, page.thicknessTaskHistograms);
+	}
+	setThicknesses(page.thicknessHistogram);
+	getSubImageRows(page.middleLineAbscs, m_interline, rows, workspace);
+	page.subImages.resize(m_stavesNb);
+	// the slope model forgot the staves of the previous page : the slots of the staves start at 0
+	m_slopeModel.reserveStaves(m_stavesNb);
+	resizeStaves();
+	// 4th reading : the rows of the staves come in the order of the staves, the sub images of the staves whose last row is read are views on the band unpacked
+	page.deskewer.start(source, FIXED_THRESH, m_slopeModel.getPageEstimate().hMax, stripRows);
+	page.band.create(0, cols);
+	bandStart = 0;
+	nextStave = 0;
+	for(firstRow = 0; nextStave < m_stavesNb && (readNb = page.deskewer.next(source, strip)) > 0; firstRow += readNb)
+	{
+		// the rows above the first row of the next stave are read by no stave left
+		keepFrom = std::max(bandStart, std::min(firstRow, page.subImgOrigins.at(nextStave)));
+		page.nextBand.create(firstRow + readNb - keepFrom, cols);
+		page.nextBand.copyRows(page.band, keepFrom - bandStart, 0, firstRow - keepFrom);
+		page.nextBand.copyRows(strip, 0, firstRow - keepFrom, readNb);
+		std::swap(page.band, page.nextBand);
+		bandStart = keepFrom;
+		readyStave = nextStave;
+		while(readyStave < m_stavesNb && page.subImgOrigins.at(readyStave) + page.subImgHeights.at(readyStave) <= firstRow + readNb)
+		{
+			++readyStave;
+		}
+		if(readyStave == nextStave)
+		{
+			continue;
+		}
+		// the staves end in the order of the staves : the last ready one ends the lowest
+		bandOrigin = page.subImgOrigins.at(nextStave);
+		bandEnd = page.subImgOrigins.at(readyStave - 1) + page.subImgHeights.at(readyStave - 1);
+		bandImg.release();
+		bandImg.allocator = workspace.getAllocator();
+		page.band(cv::Rect(0, bandOrigin - bandStart, cols, bandEnd - bandOrigin)).toMat(bandImg);
+		bandImg.allocator = nullptr;
+		extractSubImages(bandImg, bandOrigin, cv::Range(nextStave, readyStave), m_slopeModel, 0, workspace);
+		parallelFor(cv::Range(nextStave, readyStave), StaveSetupBody(m_staves, page.subImages, page.subImgOrigins, m_slopeModel, m_interline, m_thicknessAvg, m_thickness0, trackingMode, workspace));
+		for(unsigned int i = nextStave; !isKeepingImages && i < readyStave; ++i)
+		{
+			m_staves.at(i).setStaveImg(cv::Mat());
+			page.subImages.at(i).release();
+		}
+		nextStave = readyStave;
+	}
+	bandImg.release();
+}
+
+void	Staves::setThicknesses(std::vector<int> const& histogram)
 {
-	std::vector<int>			profilVect;
-	std::vector<int>			middleLineAbscs;
-	//std::vector<int>			newMiddleLineAbscs;
-	std::vector<int>			lineThicknessHistogram;
-	std::vector<int>			middleLineAbsc;
-	std::vector<int> 			leftOrds;
-	std::vector<int> 			rightOrds; 
-	std::vector<cv::Mat>		subImg;
-	Bivector					ords;
+	m_thickness0 = getMaxIndex(histogram);
+	m_thicknessAvg = getLineThickness(histogram, m_thickness0);
+}
 
-	m_score = correctSlope(binarize(score.clone(), 220));
-	profilVect = getHorizontalProfile(m_score);
-	m_interline = findInterline(profilVect);
-	middleLineAbscs = detectMiddleLineAbsc(profilVect, m_interline);
-	m_stavesNb = static_cast<unsigned int>(middleLineAbscs.size());
-	lineThicknessHistogram = getLineThicknessHistogram(middleLineAbscs, static_cast<int>(6 * m_interline), m_score);
-	m_thickness0 = getMaxIndex(lineThicknessHistogram);
-	m_thicknessAvg = getLineThickness(lineThicknessHistogram, m_thickness0);
-	subImg = extractSubImages(m_score, middleLineAbscs, m_interline);
-	for(int i = 0; i < static_cast<int>(subImg.size()); ++i)
+void	Staves::resizeStaves()
+{
+	// the staves of the previous page are set up again
+	if(m_staves.size() > m_stavesNb)
 	{
-		profilVect = getHorizontalProfile(subImg.at(i));
-		middleLineAbscs.at(i) = (detectMiddleLineAbscInSub(profilVect, m_interline));
+		m_staves.erase(m_staves.begin() + m_stavesNb, m_staves.end());
 	}
-	ords = getOrdsPosition(subImg, m_thicknessAvg, m_thickness0, m_interline, middleLineAbscs);
-	m_staves.reserve(m_stavesNb); 
-	leftOrds = ords.getLeft();
-	rightOrds = ords.getRight();
-	for(unsigned int i = 0; i < m_stavesNb; ++i)
+	m_staves.reserve(m_stavesNb);
+	for(unsigned int i = static_cast<unsigned int>(m_staves.size()); i < m_stavesNb; ++i)
 	{
-		Stave stave(i);
-		middleLineAbsc = getMiddleLineAbsc(middleLineAbscs.at(i), m_interline, m_thickness0, subImg.at(i), leftOrds.at(i), rightOrds.at(i));
-		stave.setup(subImg.at(i), leftOrds.at(i), rightOrds.at(i), middleLineAbsc, m_interline);
-		m_staves.push_back(stave);
+		m_staves.push_back(Stave(i));
 	}
 }
 
-void	Staves::print() const
+void	Staves::print(ResultSink& sink) const
 {
 	cv::Vec3b	blue = {255, 0, 0};
 
 	for(unsigned int stave_id = 0; stave_id < m_stavesNb; ++stave_id)
 	{
-		Stave stave = m_staves.at(stave_id);
-		cv::Mat	subImg;
+		Stave const&	stave = m_staves.at(stave_id);
+		cv::Mat			subImg;
 		cvtColor(stave.getStaveImg(), subImg, cv::COLOR_GRAY2RGB);
 		int left = stave.getLeftOrd();
 		int right = stave.getRightOrd();
@@ -175,60 +513,171 @@ void	Staves::print() const
 				subImg.at<cv::Vec3b>(cv::Point(y, abs.at(y - left))) = blue;
 			}
 		}
-		cv::imshow("lines of image " + std::to_string(stave_id), subImg);
-		cv::waitKey(0);
+		sink.putImage("lines of image " + std::to_string(stave_id), subImg);
 	}
 }
 
 void	Staves::erase()
 {
-	unsigned char	white = 255;
-	unsigned char	black = 0;
-	int				thicknessThresh = round(m_thicknessAvg) + 2;
+	// criteria 1 : a black segment thicker than the lines is not a part of a line only
+	int		thicknessThresh = round(m_thicknessAvg) + 2;
 
-	for(unsigned int stave_id = 0; stave_id < m_stavesNb; ++stave_id)
+	parallelFor(cv::Range(0, static_cast<int>(m_staves.size())), EraseBody(m_staves, thicknessThresh));
+}
+
+void	Staves::printErasure(ResultSink& sink) const
+{
+	for(unsigned int stave_id = 0; stave_id < m_staves.size(); ++stave_id)
 	{
-		Stave 		stave = m_staves.at(stave_id);
-		cv::Mat		subImg = stave.getStaveImg().clone();
-		int			left = stave.getLeftOrd();
-		int 		right = stave.getRightOrd();
-		for(unsigned int staveLine_id = 0; staveLine_id < 5; ++staveLine_id)
+		sink.putImage("erasure of lines of image " + std::to_string(stave_id), m_staves.at(stave_id).getStaveImg());
+	}
+}
+
+EraseBody::EraseBody(std::vector<Stave>& staves, int thicknessThresh) :
+	m_staves(staves),
+	m_thicknessThresh(thicknessThresh)
+{
+
+}
+
+void	EraseBody::operator()(cv::Range const& staves) const
+{
+	EraseBuffers	buffers;
+
+	for(int stave_id = staves.start; stave_id < staves.end; ++stave_id)
+	{
+		Stave&	stave = m_staves.at(stave_id);
+
+		// a stave set up by strips without its image has nothing to erase
+		if(stave.getStaveImg().empty())
 		{
-			std::vector<int> const&	abs = stave.getStaveLines().at(staveLine_id).getAbsCoords();
-			for(int y = left; y <= right; ++y)
+			continue;
+		}
+		// the lines are erased in the pixels of the stave only, not in the page nor in the staves around it
+		cv::Mat&	subImg = stave.getEditableStaveImg();
+
+		// the lines are erased one after the other as a line may meet the segments of the line above it
+		for(auto const& staveLine : stave.getStaveLines())
+		{
+			eraseLine(subImg, staveLine.getAbsCoords(), stave.getLeftOrd(), m_thicknessThresh, buffers);
+		}
+	}
+}
+
+StaveSetupBody::StaveSetupBody(std::vector<Stave>& staves, std::vector<cv::Mat> const& subImg, std::vector<int> const& subImgOrigins, SlopeModel const& slopeModel, int interline, double thicknessAvg, int thickness0, TrackingMode trackingMode, PageWorkspace& workspace) :
+	m_staves(staves),
+	m_subImg(subImg),
+	m_subImgOrigins(subImgOrigins),
+	m_slopeModel(slopeModel),
+	m_interline(interline),
+	m_thicknessAvg(thicknessAvg),
+	m_thickness0(thickness0),
+	m_trackingMode(trackingMode),
+	m_workspace(workspace)
+{
+
+}
+
+void	StaveSetupBody::operator()(cv::Range const& staves) const
+{
+	StaveBuffersLease	lease(m_workspace);
+	DetectionBuffers&	buffers = lease.get();
+	int					subImgCenter = 0;
+	int					leftOrd = -1;
+	int					rightOrd = -1;
+
+	for(int i = staves.start; i < staves.end; ++i)
+	{
+		cv::Mat const&	subImg = m_subImg.at(i);
+
+		getRowProfile(subImg, buffers.profile);
+		subImgCenter = detectMiddleLineAbscInSub(buffers.profile, m_interline, buffers);
+		getStaveOrds(subImg, m_thicknessAvg, m_thickness0, m_interline, subImgCenter, leftOrd, rightOrd, buffers);
+		getMiddleLineAbsc(subImgCenter, m_interline, m_thickness0, subImg, leftOrd, rightOrd, m_trackingMode, buffers);
+		m_staves.at(i).setup(subImg, m_subImgOrigins.at(i), leftOrd, rightOrd, buffers.middleLineAbsc, m_interline, m_slopeModel.getStaveHMax(i));
+	}
+}
+
+static void	eraseLine(cv::Mat& staveImg, std::vector<int> const& lineAbscs, int leftOrd, int thicknessThresh, EraseBuffers& buffers)
+{
+	int		width = static_cast<int>(lineAbscs.size());
+	int		segmentEnd = 0;
+	int		x = 0;
+
+	buffers.xUps.resize(width);
+	buffers.xDowns.resize(width);
+	buffers.whites.resize(width);
+	// the line is horizontal over segments of columns, the rows around a segment are read one after the other
+	for(int segmentStart = 0; segmentStart < width; segmentStart = segmentEnd)
+	{
+		x = lineAbscs[segmentStart];
+		segmentEnd = segmentStart + 1;
+		while(segmentEnd < width && lineAbscs[segmentEnd] == x)
+		{
+			++segmentEnd;
+		}
+		findSegmentEnds(staveImg, x, leftOrd + segmentStart, segmentEnd - segmentStart, thicknessThresh, buffers.xUps.data() + segmentStart, buffers.xDowns.data() + segmentStart, buffers.whites.data() + segmentStart);
+	}
+	for(int j = 0; j < width; ++j)
+	{
+		x = lineAbscs[j];
+		// criteria 1, 2 & 3
+		if(buffers.xDowns[j] - buffers.xUps[j] <= thicknessThresh && buffers.xUps[j] > x - thicknessThresh && buffers.xDowns[j] < x + thicknessThresh)
+		{
+			for(int xErased = std::max(0, buffers.xUps[j]); xErased <= std::min(staveImg.rows - 1, buffers.xDowns[j]); ++xErased)
+			{
+				staveImg.at<unsigned char>(xErased, leftOrd + j) = WHITE;
+			}
+		}
+	}
+}
+
+static void	findSegmentEnds(cv::Mat const& staveImg, int x, int firstCol, int width, int thicknessThresh, int* xUps, int* xDowns, unsigned char* whites)
+{
+	unsigned char const*	pixels = nullptr;
+
+	// the segment can only meet the criteria 2 & 3 if its ends are found within thicknessThresh rows of the line, otherwise they stay at x - thicknessThresh and x + thicknessThresh
+	std::fill(xUps, xUps + width, x - thicknessThresh);
+	std::fill(xDowns, xDowns + width, x + thicknessThresh);
+	// going down to the line, the end of the segment above it is the last row white as well as the row above it
+	std::fill(whites, whites + width, 1);
+	for(int row = x - thicknessThresh; row <= x; ++row)
+	{
+		if(row < 0 || row >= staveImg.rows)
+		{
+			// the rows out of the image are white
+			for(int j = 0; j < width; ++j)
 			{
-				int x = abs.at(y - left);
-				int xUp = x;
-				int xDown = x;
-				// find the length of the vertical black segment from either side of every line of stave
-				while((subImg.at<unsigned char>(xUp, y) == black || subImg.at<unsigned char>(xUp - 1, y) == black)  && xUp >= 0)
-				{
-					--xUp;
-				}
-				while((subImg.at<unsigned char>(xDown, y) == black || subImg.at<unsigned char>(xDown + 1, y) == black) && xDown < subImg.rows)
-				{
-					++xDown;
-				}
-				//std::cout << xDown - xUp << std::endl;
-				// criteria 1
-				if(xDown - xUp <= thicknessThresh)
-				{
-					// criteria 2 & 3
-					if(xUp > x - thicknessThresh && xDown < x + thicknessThresh)
-					{
-						for(int xErased = xUp; xErased < xDown + 1; ++xErased)
-						{
-							if(xErased >= 0 && xErased < subImg.rows)
-							{
-								subImg.at<unsigned char>(xErased, y) = white;
-							}
-						}
-					}
-				}
+				xUps[j] = (whites[j] && row > x - thicknessThresh) ? row : xUps[j];
 			}
+			std::fill(whites, whites + width, 1);
+			continue;
+		}
+		pixels = staveImg.ptr<unsigned char>(row) + firstCol;
+		for(int j = 0; j < width; ++j)
+		{
+			xUps[j] = (whites[j] & (pixels[j] != BLACK) & (row > x - thicknessThresh)) ? row : xUps[j];
+			whites[j] = (pixels[j] != BLACK);
+		}
+	}
+	// going up to the line, the end of the segment below it is the last row white as well as the row below it
+	std::fill(whites, whites + width, 1);
+	for(int row = x + thicknessThresh; row >= x; --row)
+	{
+		if(row < 0 || row >= staveImg.rows)
+		{
+			for(int j = 0; j < width; ++j)
+			{
+				xDowns[j] = (whites[j] && row < x + thicknessThresh) ? row : xDowns[j];
+			}
+			std::fill(whites, whites + width, 1);
+			continue;
+		}
+		pixels = staveImg.ptr<unsigned char>(row) + firstCol;
+		for(int j = 0; j < width; ++j)
+		{
+			xDowns[j] = (whites[j] & (pixels[j] != BLACK) & (row < x + thicknessThresh)) ? row : xDowns[j];
+			whites[j] = (pixels[j] != BLACK);
 		}
-		m_staves.at(stave_id).setStaveImg(subImg);
-		cv::imshow("erasure of lines of image " + std::to_string(stave_id), subImg);
-		cv::waitKey(0);
 	}
 }
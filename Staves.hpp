@@ -8,6 +8,11 @@
 #include <iostream>
 #include "tools.hpp"
 #include "staveDetection.hpp"
+#include "SlopeModel.hpp"
+#include "preprocessing.hpp"
+#include "ResultSink.hpp"
+#include "PageWorkspace.hpp"
+#include "StripSource.hpp"
 
 /*!
   \class StaveLine
@@ -35,7 +40,7 @@ public :
 
 /*!
 	\class Stave
-	\brief Stave stores the shared informations of a stave defined by an id
+	\brief Stave stores the shared informations of a stave defined by an id. Its image is usually a view on the rows of the page corrected from its slope (overlapping the images of the staves around it) : the pixels are copied the first time they are written (copy on write, see getEditableStaveImg). A copy of a stave shares a shared image too, and gets its own pixels when the image belongs to the stave copied
 
  */
 class Stave
@@ -43,27 +48,54 @@ class Stave
 	unsigned int			m_id;
 	std::vector<StaveLine>	m_staveLines;
 	cv::Mat					m_staveImg;
+	int						m_origin = 0;
+	bool					m_isImgShared = false;
 	int						m_leftOrd = -1;
 	int						m_rightOrd = -1;
+	double					m_hMax = 0.0;
 
 public :
 									Stave(unsigned int id);
+	/*!
+		the pixels of the image are copied unless they are shared (see getEditableStaveImg), so that writing the image of one of the staves never changes the other one
+	 */
+									Stave(Stave const& stave);
+									Stave(Stave&& stave) noexcept;
+	Stave&							operator=(Stave const& stave);
+	Stave&							operator=(Stave&& stave) noexcept;
 	std::vector<StaveLine> const&	getStaveLines() const;
 	cv::Mat	const&					getStaveImg() const;
+	/*!
+		image of the stave that can be written : its pixels are copied first if they are shared with the page or with another image
+	 */
+	cv::Mat&						getEditableStaveImg();
+	/*!
+		row of the page of score corrected from its slope of the first row of the image of the stave
+	 */
+	int								getOrigin() const;
 	int								getId() const;
 	int								getLeftOrd() const;
 	int								getRightOrd() const;
+	/*!
+		vertical shift between the left and right halves of the stave in the page before the correction of its slope (see SlopeModel::getStaveHMax)
+	 */
+	double							getHMax() const;
 	/*!
 		set all the fields of the instance of Stave
 
 		Called by the setup function of Staves
-		\param subImg image of the i-th stave of the page of score
+		\param subImg image of the i-th stave of the page of score (shared, not copied)
+		\param origin see getOrigin
 		\param leftOrd the ordinate of the beginning of the stave
 		\param rightOrd the ordintate of the end of the stave
 		\param middleLineAbsc the abscissa of the third line of the stave between the first and last ordinates of the stave
 		\param interline the average distance between 2 lines of stave
+		\param hMax see getHMax
+	 */
+	void							setup(cv::Mat const& subImg, int origin, int leftOrd, int rightOrd, std::vector<int> const& middleLineAbscs, int interline, double hMax);
+	/*!
+		share img (see getEditableStaveImg)
 	 */
-	void							setup(cv::Mat subImg, int leftOrd, int rightOrd, std::vector<int> middleLineAbscs, int interline);
 	void							setStaveImg(cv::Mat const& img);
 };
 
@@ -80,6 +112,17 @@ class Staves
 	double				m_thicknessAvg;
 	int					m_thickness0;
 	cv::Mat				m_score;
+	BitPlane			m_scorePlane;
+	SlopeModel			m_slopeModel;
+
+	/*!
+		m_thickness0 and m_thicknessAvg from the histogram of the thickness of the lines of the staves (see getLineThicknessHistogram)
+	 */
+	void						setThicknesses(std::vector<int> const& histogram);
+	/*!
+		keep m_stavesNb staves : the staves of the previous page are set up again in place
+	 */
+	void						resizeStaves();
 
 public :
 	std::vector<Stave> const&	getStaves() const;
@@ -88,25 +131,62 @@ public :
 	double						getThicknessMoy() const;
 	int							getThickness0() const;
 	cv::Mat const&				getScore() const;
+	/*!
+		binarized page corrected from its slope, 1 bit per pixel (same pixels as getScore)
+	 */
+	BitPlane const&				getScorePlane() const;
+	/*!
+		slope of the page and residual slope of every stave
+	 */
+	SlopeModel const&			getSlopeModel() const;
 	/*!
 		set all the fields of the instance of Staves
 
 		Called by the main
 		\param score image of one page of score in gray scale
+		\param mode binarization of the page : the fixed threshold 220, or an adaptive one whose window follows the interline found on the page binarized with the fixed threshold
+		\param trackingMode tracking of the middle lines of the staves (see getMiddleLineAbsc)
+	 */
+	void						setup(cv::Mat const& score, BinarizationMode mode = BinarizationMode::FIXED, TrackingMode trackingMode = TrackingMode::SMOOTHING);
+	/*!
+		setup with the buffers of a workspace kept from one page to another : once the workspace has grown to the size of the pages, only the adaptive binarization and the scheduling of the tasks allocate memory, and the staves of the instance are set up again in place
+
+		\param score see setup
+		\param workspace see PageWorkspace, the images of the page use its pool
+		\param mode see setup
+		\param trackingMode see setup
 	 */
-	void						setup(cv::Mat const& score);
+	void						setup(cv::Mat const& score, PageWorkspace& workspace, BinarizationMode mode = BinarizationMode::FIXED, TrackingMode trackingMode = TrackingMode::SMOOTHING);
 	/*!
-		display every sub image of stave of the page with highlighted lines of stave
+		setup of a page read by strips, which is never held whole nor binarized whole : only the staves are kept, getScore and getScorePlane are empty. The source is read 4 times : the halves of the page compared to find its slope are packed (1 bit per pixel of the page), then the strips are corrected from the slope to get the profile and the vertical runs of the page, which give its staves. The strips are corrected again to measure the thickness of the lines in the bands around the staves (the band of a stave is kept until its last row is read). At last the strips are corrected again and the band of the rows of the staves not set up yet is kept : the staves whose rows are all read are set up at once and the rows above the next stave are forgotten. The results are the ones of setup with the fixed threshold (the adaptive ones read the neighbourhood of every pixel in the whole page)
+
+		\param source page in gray scale
+		\param workspace see setup
+		\param stripRows number of rows read at a time
+		\param isKeepingImages the staves keep their images, else the image of a stave is released once it is set up (only its geometry is left, see ResultSink::putGeometry) : the memory then depends on the strip and the band of one stave, not on the page
+		\param trackingMode see setup
+	 */
+	void						setup(StripSource& source, PageWorkspace& workspace, int stripRows, bool isKeepingImages, TrackingMode trackingMode = TrackingMode::SMOOTHING);
+	/*!
+		put every sub image of stave of the page with highlighted lines of stave in sink
 
 		Called by the argument "printLines" when executing the program 
+		\param sink see ResultSink
 	 */
-	void						print() const;
+	void						print(ResultSink& sink) const;
 	/*!
-		display every sub image of stave of the page with the lines erased
+		erase the lines of every stave in its own image (the page is left untouched), the staves are processed in parallel and nothing is displayed
 
 		Called by the argument "eraseLines" when executing the program 
 	 */
 	void						erase();
+	/*!
+		put every sub image of stave of the page (with the lines erased after erase) in sink
+
+		Called by the argument "eraseLines" when executing the program 
+		\param sink see ResultSink
+	 */
+	void						printErasure(ResultSink& sink) const;
 };
 
 #endif
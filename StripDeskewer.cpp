@@ -0,0 +1,82 @@
+#include "StripDeskewer.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+StripDeskewer::StripDeskewer() :
+	m_thresh(0),
+	m_stripRows(1),
+	m_rows(0),
+	m_cols(0),
+	m_minOffset(0),
+	m_maxOffset(0),
+	m_windowStart(0),
+	m_correctedEnd(0)
+{
+
+}
+
+void	StripDeskewer::start(StripSource& source, unsigned char thresh, int hMax, int stripRows)
+{
+	source.rewind();
+	m_thresh = thresh;
+	m_stripRows = std::max(1, stripRows);
+	m_rows = source.getRows();
+	m_cols = source.getCols();
+	// the offsets of correctSlope on the whole page
+	getShearOffsets(m_cols, static_cast<double>(hMax), m_offsets);
+	getShearRuns(m_offsets, m_runs);
+	m_minOffset = m_offsets.empty() ? 0 : *std::min_element(m_offsets.begin(), m_offsets.end());
+	m_maxOffset = m_offsets.empty() ? 0 : *std::max_element(m_offsets.begin(), m_offsets.end());
+	m_window.create(0, m_cols);
+	m_windowStart = 0;
+	m_correctedEnd = 0;
+}
+
+int		StripDeskewer::getCorrectedEnd() const
+{
+	return m_correctedEnd;
+}
+
+int		StripDeskewer::next(StripSource& source, BitPlane& correctedRows)
+{
+	int		readNb = 0;
+	int		windowEnd = 0;
+	int		keepFrom = 0;
+	int		correctedEnd = 0;
+	int		correctedNb = 0;
+
+	while(m_correctedEnd < m_rows)
+	{
+		readNb = source.read(m_stripRows, m_strip);
+		windowEnd = m_windowStart + m_window.getRows();
+		if(readNb == 0 && windowEnd < m_rows)
+		{
+			throw std::runtime_error("the strips of the page end before its row " + std::to_string(m_rows));
+		}
+		// the row i of the corrected page reads the rows [i - maxOffset; i - minOffset] : the rows above the ones read by the next corrected row are forgotten
+		keepFrom = std::max(m_windowStart, std::min(windowEnd, m_correctedEnd - m_maxOffset));
+		m_nextWindow.create(windowEnd + readNb - keepFrom, m_cols);
+		m_nextWindow.copyRows(m_window, keepFrom - m_windowStart, 0, windowEnd - keepFrom);
+		if(readNb > 0)
+		{
+			BitPlane::fromMat(m_strip, m_thresh, m_stripPlane);
+			m_nextWindow.copyRows(m_stripPlane, 0, windowEnd - keepFrom, readNb);
+		}
+		std::swap(m_window, m_nextWindow);
+		m_windowStart = keepFrom;
+		windowEnd += readNb;
+		// the rows below the window are out of the page once it is all read
+		correctedEnd = (windowEnd == m_rows) ? m_rows : std::min(m_rows, windowEnd + m_minOffset);
+		if(correctedEnd > m_correctedEnd)
+		{
+			correctedNb = correctedEnd - m_correctedEnd;
+			correctedRows.create(correctedNb, m_cols);
+			shearRows(m_window, m_windowStart, m_rows, m_correctedEnd, correctedRows, m_runs);
+			m_correctedEnd = correctedEnd;
+			return correctedNb;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,55 @@
+#ifndef STRIP_DESKEWER_HPP
+#define STRIP_DESKEWER_HPP
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "BitPlane.hpp"
+#include "shear.hpp"
+#include "StripSource.hpp"
+
+/*!
+	\class StripDeskewer
+	\brief StripDeskewer binarizes the strips of a page read from a StripSource and corrects them from the slope of the page, as correctSlope does on the whole page. A corrected row reads the rows of the page up to the largest shift of a column above or below it : only the rows of the last strip and the rows still read by the next corrected rows are kept. Its buffers are kept from one page to another
+*/
+class StripDeskewer
+{
+	unsigned char			m_thresh;
+	int						m_stripRows;
+	int						m_rows;
+	int						m_cols;
+	std::vector<int>		m_offsets;
+	std::vector<ShearRun>	m_runs;
+	int						m_minOffset;
+	int						m_maxOffset;
+	cv::Mat					m_strip;
+	BitPlane				m_stripPlane;
+	BitPlane				m_window;
+	BitPlane				m_nextWindow;
+	int						m_windowStart;
+	int						m_correctedEnd;
+
+public :
+							StripDeskewer();
+	/*!
+		start the correction of a page, the source is read again from its first row
+
+		\param source page in gray scale
+		\param thresh highest gray level of a black pixel (see binarize)
+		\param hMax shift of the slope of the page (see correctSlope)
+		\param stripRows number of rows read at a time
+	 */
+	void					start(StripSource& source, unsigned char thresh, int hMax, int stripRows);
+	/*!
+		row of the page after the last corrected row
+	 */
+	int						getCorrectedEnd() const;
+	/*!
+		read strips of the source until some more rows can be corrected
+
+		\param source see start
+		\param correctedRows the rows of the page corrected from its slope from the row getCorrectedEnd() before the call, its words are reused
+		\return number of rows corrected, 0 once the whole page is corrected. Throw std::runtime_error if the source ends before the last row of the page
+	 */
+	int						next(StripSource& source, BitPlane& correctedRows);
+};
+
+#endif
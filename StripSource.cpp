@@ -0,0 +1,143 @@
+#include "StripSource.hpp"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+/*!
+	\brief
+	Read the next number of the header of a PNM file, after the blanks and the comments before it
+
+	\param file file of the image
+	\param value number read
+	\return false if no number could be read
+*/
+static bool		readPnmValue(std::ifstream& file, int& value);
+
+StripSource::~StripSource()
+{
+
+}
+
+MatStripSource::MatStripSource(cv::Mat const& page) :
+	m_page(page),
+	m_row(0)
+{
+	CV_Assert(page.empty() || page.type() == CV_8UC1);
+}
+
+int		MatStripSource::getRows() const
+{
+	return m_page.rows;
+}
+
+int		MatStripSource::getCols() const
+{
+	return m_page.cols;
+}
+
+void	MatStripSource::rewind()
+{
+	m_row = 0;
+}
+
+int		MatStripSource::read(int rowsNb, cv::Mat& strip)
+{
+	int		readNb = std::max(0, std::min(rowsNb, m_page.rows - m_row));
+
+	if(readNb == 0)
+	{
+		strip.release();
+		return 0;
+	}
+	strip = m_page.rowRange(m_row, m_row + readNb);
+	m_row += readNb;
+	return readNb;
+}
+
+PgmStripSource::PgmStripSource(std::string const& path) :
+	m_file(path, std::ios::binary),
+	m_path(path),
+	m_dataStart(0),
+	m_rows(0),
+	m_cols(0),
+	m_row(0)
+{
+	char	magic[2] = {0, 0};
+	int		maxValue = 0;
+
+	if(!m_file || !m_file.read(magic, 2) || magic[0] != 'P' || magic[1] != '5')
+	{
+		throw std::invalid_argument("'" + path + "' is not a binary PGM file");
+	}
+	if(!readPnmValue(m_file, m_cols) || !readPnmValue(m_file, m_rows) || !readPnmValue(m_file, maxValue) || m_cols <= 0 || m_rows <= 0)
+	{
+		throw std::invalid_argument("the header of '" + path + "' can't be read");
+	}
+	if(maxValue > 255)
+	{
+		throw std::invalid_argument("'" + path + "' has more than 8 bits per pixel");
+	}
+	// a single blank separates the header from the pixels
+	m_file.get();
+	m_dataStart = m_file.tellg();
+}
+
+int		PgmStripSource::getRows() const
+{
+	return m_rows;
+}
+
+int		PgmStripSource::getCols() const
+{
+	return m_cols;
+}
+
+void	PgmStripSource::rewind()
+{
+	m_file.clear();
+	m_file.seekg(m_dataStart);
+	m_row = 0;
+}
+
+int		PgmStripSource::read(int rowsNb, cv::Mat& strip)
+{
+	int		readNb = std::max(0, std::min(rowsNb, m_rows - m_row));
+
+	if(readNb == 0)
+	{
+		return 0;
+	}
+	// the buffer of the strip is kept when it is not shared and has the size of the strip
+	if(strip.rows != readNb || strip.cols != m_cols || strip.type() != CV_8UC1 || !strip.isContinuous())
+	{
+		strip.release();
+		strip.create(readNb, m_cols, CV_8UC1);
+	}
+	if(!m_file.read(reinterpret_cast<char*>(strip.ptr<unsigned char>(0)), static_cast<std::streamsize>(readNb) * m_cols))
+	{
+		throw std::runtime_error("'" + m_path + "' ends before its row " + std::to_string(m_rows));
+	}
+	m_row += readNb;
+	return readNb;
+}
+
+bool	PgmStripSource::isPgmFile(std::string const& path)
+{
+	std::ifstream	file(path, std::ios::binary);
+	char			magic[2] = {0, 0};
+
+	return file.read(magic, 2) && magic[0] == 'P' && magic[1] == '5';
+}
+
+static bool		readPnmValue(std::ifstream& file, int& value)
+{
+	while(file && (std::isspace(file.peek()) || file.peek() == '#'))
+	{
+		if(file.get() == '#')
+		{
+			file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		}
+	}
+	return static_cast<bool>(file >> value);
+}
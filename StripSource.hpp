@@ -0,0 +1,79 @@
+#ifndef STRIP_SOURCE_HPP
+#define STRIP_SOURCE_HPP
+#include <opencv2/core/core.hpp>
+#include <fstream>
+#include <string>
+
+/*!
+	\class StripSource
+	\brief StripSource gives the rows of a page in gray scale by horizontal strips, from the top to the bottom, so that a page can be processed without being held whole in memory. The page can be read again from its first row (see rewind) : the streaming setup of the staves reads it several times (see Staves::setup)
+*/
+class StripSource
+{
+public :
+	virtual			~StripSource();
+	virtual int		getRows() const = 0;
+	virtual int		getCols() const = 0;
+	/*!
+		start again from the first row of the page
+	 */
+	virtual void	rewind() = 0;
+	/*!
+		read the next rows of the page
+
+		\param rowsNb most rows to read
+		\param strip the rows read in gray scale (8 bits), its memory may be reused from one call to another : the rows of the previous strip are no longer valid
+		\return number of rows read, 0 once the last row has been read
+	 */
+	virtual int		read(int rowsNb, cv::Mat& strip) = 0;
+};
+
+/*!
+	\class MatStripSource
+	\brief MatStripSource gives the strips of a page already in memory, as views on its rows (nothing is copied)
+*/
+class MatStripSource : public StripSource
+{
+	cv::Mat		m_page;
+	int			m_row;
+
+public :
+	/*!
+		\param page page in gray scale (8 bits), shared
+	 */
+	explicit	MatStripSource(cv::Mat const& page);
+	int			getRows() const;
+	int			getCols() const;
+	void		rewind();
+	int			read(int rowsNb, cv::Mat& strip);
+};
+
+/*!
+	\class PgmStripSource
+	\brief PgmStripSource reads the strips of a binary PGM file (magic number P5, 8 bits) directly from the file : only one strip is in memory at a time. Throw std::invalid_argument if the file can't be read or is not such a PGM, and std::runtime_error if it ends before its last row
+*/
+class PgmStripSource : public StripSource
+{
+	std::ifstream	m_file;
+	std::string		m_path;
+	std::streamoff	m_dataStart;
+	int				m_rows;
+	int				m_cols;
+	int				m_row;
+
+public :
+	/*!
+		\param path path of the PGM file, its header is read at once
+	 */
+	explicit		PgmStripSource(std::string const& path);
+	int				getRows() const;
+	int				getCols() const;
+	void			rewind();
+	int				read(int rowsNb, cv::Mat& strip);
+	/*!
+		whether the file starts with the magic number of the files read by PgmStripSource
+	 */
+	static bool		isPgmFile(std::string const& path);
+};
+
+#endif
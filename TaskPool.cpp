@@ -0,0 +1,285 @@
+#include "TaskPool.hpp"
+#include <algorithm>
+#include <exception>
+
+/*!
+	\brief
+	Number of chunks of a loop of parallelFor for every worker : a loop is split in more chunks than workers so that the workers stealing them stay busy until its end
+*/
+static int const	CHUNKS_PER_WORKER = 4;
+
+/*!
+	\brief
+	Pool of the worker running on the calling thread (nullptr out of the workers)
+*/
+static thread_local TaskPool*	currentPool = nullptr;
+
+/*!
+	\brief
+	Queue of the worker running on the calling thread in its pool
+*/
+static thread_local unsigned int	currentWorker = 0;
+
+TaskPool::TaskPool(unsigned int workersNb) :
+	m_workersNb(std::max(workersNb, 1u)),
+	m_queuedNb(0),
+	m_queuedChunksNb(0),
+	m_runningNb(0),
+	m_isStopped(false)
+{
+	// one queue for every worker, then the queue of the tasks submitted from outside the pool, all created before the workers start
+	for(unsigned int i = 0; i <= m_workersNb; ++i)
+	{
+		m_queues.push_back(std::unique_ptr<Queue>(new Queue()));
+	}
+	for(unsigned int i = 0; i < m_workersNb; ++i)
+	{
+		m_workers.push_back(std::thread(&TaskPool::work, this, i));
+	}
+}
+
+TaskPool::~TaskPool()
+{
+	{
+		std::lock_guard<std::mutex>	lock(m_mutex);
+		m_isStopped = true;
+	}
+	m_wakeUp.notify_all();
+	for(auto& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+unsigned int	TaskPool::getWorkersNb() const
+{
+	return m_workersNb;
+}
+
+void	TaskPool::submit(std::function<void()> const& task)
+{
+	push(currentPool == this ? currentWorker : getWorkersNb(), {task, false});
+}
+
+void	TaskPool::parallelFor(cv::Range const& range, cv::ParallelLoopBody const& body)
+{
+	unsigned int			self = (currentPool == this ? currentWorker : getWorkersNb());
+	int						size = range.end - range.start;
+	int						chunksNb = std::min(size, CHUNKS_PER_WORKER * static_cast<int>(getWorkersNb()));
+	int						remainingNb = chunksNb;
+	std::exception_ptr		error;
+	std::mutex				loopMutex;
+	std::condition_variable	done;
+	int						chunkStart = 0;
+	int						chunkEnd = 0;
+	bool					isChunkRun = false;
+
+	for(int c = 0; c < chunksNb; ++c)
+	{
+		chunkStart = range.start + static_cast<int>(static_cast<long long>(size) * c / chunksNb);
+		chunkEnd = range.start + static_cast<int>(static_cast<long long>(size) * (c + 1) / chunksNb);
+		push(self, {[&body, &remainingNb, &error, &loopMutex, &done, chunkStart, chunkEnd]()
+		{
+			std::exception_ptr	chunkError;
+
+			try
+			{
+				body(cv::Range(chunkStart, chunkEnd));
+			}
+			catch(...)
+			{
+				chunkError = std::current_exception();
+			}
+			// the last access to the state of the loop, which ends with the call of parallelFor : the caller cannot leave its wait before the lock is released
+			std::lock_guard<std::mutex>	lock(loopMutex);
+			if(chunkError && !error)
+			{
+				error = chunkError;
+			}
+			if(--remainingNb == 0)
+			{
+				done.notify_one();
+			}
+		}, true});
+	}
+	// the caller runs the chunks too, the last pushed first, and only chunks : another page would delay the end of the loop. It sleeps only once no chunk is left to take, until the last chunk running elsewhere is over
+	{
+		std::unique_lock<std::mutex>	lock(loopMutex);
+
+		while(remainingNb > 0)
+		{
+			lock.unlock();
+			isChunkRun = runOne(self, true);
+			lock.lock();
+			if(!isChunkRun)
+			{
+				done.wait(lock, [&remainingNb]() { return remainingNb <= 0; });
+			}
+		}
+	}
+	if(error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+void	TaskPool::runChunksUntil(std::function<bool()> const& isDone)
+{
+	unsigned int	self = (currentPool == this ? currentWorker : getWorkersNb());
+	bool			isOver = false;
+
+	while(!(isOver = isDone()))
+	{
+		if(!runOne(self, true))
+		{
+			std::unique_lock<std::mutex>	lock(m_mutex);
+
+			m_wakeUp.wait(lock, [this, &isDone, &isOver]() { return (isOver = isDone()) || m_queuedChunksNb.load() > 0; });
+			if(isOver)
+			{
+				break;
+			}
+		}
+	}
+}
+
+void	TaskPool::wakeUp()
+{
+	// the lock orders the condition made true with the test of a worker going to sleep
+	{
+		std::lock_guard<std::mutex>	lock(m_mutex);
+	}
+	m_wakeUp.notify_all();
+}
+
+void	TaskPool::wait()
+{
+	std::unique_lock<std::mutex>	lock(m_mutex);
+
+	m_idle.wait(lock, [this]() { return m_queuedNb.load() == 0 && m_runningNb.load() == 0; });
+}
+
+TaskPool*	TaskPool::getCurrent()
+{
+	return currentPool;
+}
+
+void	TaskPool::work(unsigned int self)
+{
+	currentPool = this;
+	currentWorker = self;
+	while(true)
+	{
+		if(!runOne(self, false))
+		{
+			std::unique_lock<std::mutex>	lock(m_mutex);
+
+			m_wakeUp.wait(lock, [this]() { return m_queuedNb.load() > 0 || m_isStopped; });
+			if(m_isStopped && m_queuedNb.load() == 0)
+			{
+				break;
+			}
+		}
+	}
+}
+
+void	TaskPool::push(unsigned int queue, Task const& task)
+{
+	{
+		std::lock_guard<std::mutex>	lock(m_queues.at(queue)->mutex);
+		m_queues.at(queue)->tasks.push_back(task);
+	}
+	if(task.isChunk)
+	{
+		++m_queuedChunksNb;
+	}
+	++m_queuedNb;
+	// the lock orders the new task with the test of a worker going to sleep. Any sleeping worker runs a chunk, only the idle workers (out of runChunksUntil) run the other tasks
+	{
+		std::lock_guard<std::mutex>	lock(m_mutex);
+	}
+	if(task.isChunk)
+	{
+		m_wakeUp.notify_one();
+	}
+	else
+	{
+		m_wakeUp.notify_all();
+	}
+}
+
+bool	TaskPool::runOne(unsigned int self, bool isChunkOnly)
+{
+	unsigned int	workersNb = getWorkersNb();
+	unsigned int	victim = 0;
+	Task			task;
+	bool			isFound = false;
+
+	// own queue first, the last task pushed (the most recent chunks, whose data is still in the cache). A task submitted by a chunk is pushed after the chunks of its loop : the chunks under it are still taken by a worker waiting for its loop
+	{
+		Queue&							queue = *m_queues.at(self);
+		std::lock_guard<std::mutex>		lock(queue.mutex);
+
+		for(std::size_t k = queue.tasks.size(); k > 0 && !isFound; --k)
+		{
+			if(!isChunkOnly || queue.tasks.at(k - 1).isChunk)
+			{
+				task = queue.tasks.at(k - 1);
+				queue.tasks.erase(queue.tasks.begin() + (k - 1));
+				isFound = true;
+			}
+		}
+	}
+	// then the oldest task submitted from outside the pool, then the oldest task of another worker (the oldest chunk for a worker waiting for a loop)
+	for(unsigned int k = 0; k <= workersNb && !isFound; ++k)
+	{
+		victim = (k == 0 ? workersNb : (self + k) % (workersNb + 1));
+		if(victim != self)
+		{
+			Queue&							queue = *m_queues.at(victim);
+			std::lock_guard<std::mutex>		lock(queue.mutex);
+
+			// a worker waiting for a loop skips the tasks that are not chunks
+			for(std::size_t i = 0; i < queue.tasks.size() && !isFound; ++i)
+			{
+				if(!isChunkOnly || queue.tasks.at(i).isChunk)
+				{
+					task = queue.tasks.at(i);
+					queue.tasks.erase(queue.tasks.begin() + i);
+					isFound = true;
+				}
+			}
+		}
+	}
+	if(isFound)
+	{
+		// counted as running before it is no longer counted as queued, so that wait never sees the pool idle in between
+		++m_runningNb;
+		if(task.isChunk)
+		{
+			--m_queuedChunksNb;
+		}
+		--m_queuedNb;
+		task.run();
+		if(--m_runningNb == 0 && m_queuedNb.load() == 0)
+		{
+			std::lock_guard<std::mutex>	lock(m_mutex);
+			m_idle.notify_all();
+		}
+	}
+	return isFound;
+}
+
+void	parallelFor(cv::Range const& range, cv::ParallelLoopBody const& body)
+{
+	TaskPool*	pool = TaskPool::getCurrent();
+
+	if(pool != nullptr)
+	{
+		pool->parallelFor(range, body);
+	}
+	else
+	{
+		cv::parallel_for_(range, body);
+	}
+}
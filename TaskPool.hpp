@@ -0,0 +1,118 @@
+#ifndef TASK_POOL_HPP
+#define TASK_POOL_HPP
+#include <opencv2/core/core.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+	\class TaskPool
+	\brief TaskPool runs tasks on a fixed set of workers with work stealing : every worker has its own queue, takes the last task it pushed first and, when its queue is empty, takes the oldest task submitted from outside the pool, then steals the oldest task of another worker. The loops of a page run on a worker (see parallelFor) are split into tasks of its own queue, so the workers done with their pages help on the staves of the others
+*/
+class TaskPool
+{
+	/*!
+		\struct Task
+		\brief Task stores a task of a queue
+	 */
+	struct Task
+	{
+		std::function<void()>	run;
+		bool					isChunk;	///< part of a loop of parallelFor, the only tasks run by a worker waiting for its loop
+	};
+
+	/*!
+		\struct Queue
+		\brief Queue stores the tasks of a worker, or the tasks submitted from outside the pool
+	 */
+	struct Queue
+	{
+		std::deque<Task>	tasks;
+		std::mutex			mutex;
+	};
+
+	unsigned int						m_workersNb;
+	std::vector<std::unique_ptr<Queue>>	m_queues;
+	std::vector<std::thread>			m_workers;
+	std::atomic<int>					m_queuedNb;
+	std::atomic<int>					m_queuedChunksNb;
+	std::atomic<int>					m_runningNb;
+	std::mutex							m_mutex;
+	std::condition_variable				m_wakeUp;
+	std::condition_variable				m_idle;
+	bool								m_isStopped;
+
+public :
+	/*!
+		\param workersNb number of workers (at least 1)
+	 */
+	explicit	TaskPool(unsigned int workersNb);
+	/*!
+		run all the tasks left, then stop the workers
+	 */
+				~TaskPool();
+	unsigned int	getWorkersNb() const;
+	/*!
+		queue a task, run by the worker calling submit or by any worker when it is called from outside the pool (the tasks submitted from outside are started in their order). An exception thrown by the task is lost : it should catch what it throws
+	 */
+	void		submit(std::function<void()> const& task);
+	/*!
+		run body on the chunks of range in parallel and return once they are all done. The chunks are pushed in the queue of the calling worker, which runs them with the idle workers stealing them. The first exception thrown by a chunk is thrown again once all the chunks are done
+
+		\param range range of the loop
+		\param body body of the loop
+	 */
+	void		parallelFor(cv::Range const& range, cv::ParallelLoopBody const& body);
+	/*!
+		run the chunks of the loops of parallelFor until isDone returns true, for a task waiting for something else than its own loop (see runBatch) : the worker sleeps while there is no chunk to run, until a chunk is pushed or wakeUp is called
+
+		\param isDone condition of the end of the wait, called under the lock of the pool until it returns true and never after (it may take what it waits for). The thread making it true calls wakeUp
+	 */
+	void		runChunksUntil(std::function<bool()> const& isDone);
+	/*!
+		wake the workers sleeping in runChunksUntil to test their condition again
+	 */
+	void		wakeUp();
+	/*!
+		wait for all the submitted tasks to be done (called from outside the pool)
+	 */
+	void		wait();
+	/*!
+		pool of the calling worker, nullptr if the calling thread is not a worker
+	 */
+	static TaskPool*	getCurrent();
+
+private :
+	/*!
+		loop of a worker
+	 */
+	void		work(unsigned int self);
+	/*!
+		push a task in a queue and wake up a worker
+	 */
+	void		push(unsigned int queue, Task const& task);
+	/*!
+		run one task taken in the queues : the last task of the queue self, the first task submitted from outside, then the first task of the other workers
+
+		\param self queue of the calling worker
+		\param isChunkOnly only the chunks of parallelFor are taken (the worker waits for the end of its loop)
+		\return false if there was no task to run
+	 */
+	bool		runOne(unsigned int self, bool isChunkOnly);
+};
+
+/*!
+	\brief
+	cv::parallel_for_ that runs on the pool of the calling thread when it is a worker of a TaskPool (see TaskPool::parallelFor), so that the tasks of the staves of a page can be stolen by the other workers of a batch
+
+	\param range range of the loop
+	\param body body of the loop
+*/
+void	parallelFor(cv::Range const& range, cv::ParallelLoopBody const& body);
+
+#endif
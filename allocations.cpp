@@ -0,0 +1,56 @@
+#include "allocations.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef COUNT_HEAP_ALLOCATIONS
+/*!
+	\brief
+	Number of calls to the global operator new (the other forms of new call it)
+*/
+static std::atomic<std::size_t>	heapAllocationsNb(0);
+
+void*	operator new(std::size_t size)
+{
+	void*				memory = nullptr;
+	std::new_handler	handler = nullptr;
+
+	heapAllocationsNb.fetch_add(1, std::memory_order_relaxed);
+	// as the operator new of the library : the new handler is called until the memory is found, std::bad_alloc is thrown when there is none
+	while((memory = std::malloc(size == 0 ? 1 : size)) == nullptr)
+	{
+		handler = std::get_new_handler();
+		if(handler == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+	return memory;
+}
+
+void	operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+bool			isCountingHeapAllocations()
+{
+	return true;
+}
+
+std::size_t		getHeapAllocationsNb()
+{
+	return heapAllocationsNb.load(std::memory_order_relaxed);
+}
+#else
+bool			isCountingHeapAllocations()
+{
+	return false;
+}
+
+std::size_t		getHeapAllocationsNb()
+{
+	return 0;
+}
+#endif
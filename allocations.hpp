@@ -0,0 +1,17 @@
+#ifndef ALLOCATIONS_HPP
+#define ALLOCATIONS_HPP
+#include <cstddef>
+
+/*!
+	\brief
+	Whether the heap allocations are counted : the global operator new of the program is only replaced when it is built with COUNT_HEAP_ALLOCATIONS ('make ALLOCATIONS=count'), so that the program shipped keeps the one of the library
+*/
+bool			isCountingHeapAllocations();
+
+/*!
+	\brief
+	Number of heap allocations made with new since the start of the program, by all the threads : the global operator new of the program counts them (see allocations.cpp), 0 if they are not counted (see isCountingHeapAllocations). The pixels of the images are allocated by OpenCV out of new, see PageWorkspace for them
+*/
+std::size_t		getHeapAllocationsNb();
+
+#endif
@@ -0,0 +1,781 @@
+#include "batch.hpp"
+#include <opencv2/highgui/highgui.hpp>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include "Staves.hpp"
+#include "PageQueue.hpp"
+#include "ResultSink.hpp"
+#include "TaskPool.hpp"
+
+/*!
+	\brief
+	Bytes of memory of a page for every pixel of its image while its staves are set up : the page in gray scale, its binarized and corrected copies and the sub images of the staves corrected from their residual slope
+*/
+static std::size_t const	PAGE_BYTES_PER_PIXEL = 6;
+
+/*!
+	\struct StageCounters
+	\brief StageCounters stores the waits of the workers of a stage of runBatch while they run (see StageStatistics)
+*/
+struct StageCounters
+{
+	std::atomic<std::size_t>	inputStalls;
+	std::atomic<std::size_t>	outputStalls;
+	std::atomic<long long>		stalledTicks;
+
+	StageCounters();
+};
+
+/*!
+	\struct Batch
+	\brief Batch stores the state of runBatch shared by the workers of its stages
+*/
+struct Batch
+{
+	std::vector<std::string> const&	pages;
+	BinarizationMode				mode;
+	TrackingMode					trackingMode;
+	ResultSink&						sink;
+	unsigned int					decodersNb;
+	unsigned int					analysersNb;
+	unsigned int					writersNb;
+	std::size_t						memoryBudget;
+	std::vector<PageReport>			reports;
+	std::vector<std::size_t>		footprints;
+	std::vector<std::size_t>		order;				///< pages left to decode, from the biggest
+	std::size_t						usedMemory;			///< sum of the footprints of the pages decoded and not written yet
+	std::mutex						memoryMutex;
+	std::condition_variable			released;
+	PageQueue						decodedPages;
+	PageQueue						analysedPages;
+	TaskPool*						analysers;			///< pool of the analysers, woken when a queue changes (see pushPage)
+	std::atomic<unsigned int>		runningDecodersNb;
+	std::atomic<unsigned int>		runningAnalysersNb;
+	StageCounters					decoding;
+	StageCounters					analysis;
+	StageCounters					writing;
+
+	Batch(std::vector<std::string> const& pages, BatchSettings const& settings, BinarizationMode mode, TrackingMode trackingMode, ResultSink& sink);
+};
+
+/*!
+	\brief
+	Loop of a decoder of runBatch : decode the next page that fits in the memory budget and push it to the analysers, until no page is left
+
+	\param batch state of the batch
+*/
+static void		decodePages(Batch& batch);
+
+/*!
+	\brief
+	Loop of an analyser of runBatch : set up the staves of the decoded pages and push them to the writers. The analyser runs the tasks of the staves of the other pages while no page is decoded. Its pages share the same workspace, so that a page reuses the buffers and the pixels left by the previous one (see PageWorkspace)
+
+	\param batch state of the batch
+*/
+static void		analysePages(Batch& batch);
+
+/*!
+	\brief
+	Loop of a writer of runBatch : give the geometry of the pages set up to the sink, then give their memory back
+
+	\param batch state of the batch
+*/
+static void		writePages(Batch& batch);
+
+/*!
+	\brief
+	Take the next page to decode : the first page of the order that fits in the memory left, any page when no page is in progress. The decoder waits for the writers to give memory back when no page fits
+
+	\param batch state of the batch
+	\param page page taken
+	\return false if no page is left
+*/
+static bool		takePage(Batch& batch, std::size_t& page);
+
+/*!
+	\brief
+	Give back the memory of a page that is over (written or failed)
+
+	\param batch state of the batch
+	\param page page over
+*/
+static void		releasePage(Batch& batch, std::size_t page);
+
+/*!
+	\brief
+	Push a page to the next stage, waiting while its queue is full : an analyser runs the tasks of the staves of the other pages while it waits and sleeps in its pool when there is none, the other workers sleep in the queue. The analysers sleeping in their pool are woken once the page is pushed
+
+	\param batch state of the batch
+	\param queue queue of the next stage
+	\param item page to push
+	\param counters counters of the stage pushing, the time running the tasks of the other pages is counted as stalled
+*/
+static void		pushPage(Batch& batch, PageQueue& queue, PageItem& item, StageCounters& counters);
+
+/*!
+	\brief
+	Pop a page from the previous stage, waiting while its queue is empty as pushPage waits while it is full
+
+	\param batch state of the batch
+	\param queue queue of the stage
+	\param item page popped
+	\param counters counters of the stage popping, see pushPage
+*/
+static void		popPage(Batch& batch, PageQueue& queue, PageItem& item, StageCounters& counters);
+
+/*!
+	\brief
+	Statistics of a stage once it is over
+
+	\param name see StageStatistics
+	\param workersNb see StageStatistics
+	\param queue queue read by the stage, nullptr for the decoding
+	\param counters counters of the stage
+*/
+static StageStatistics	getStageStatistics(std::string const& name, unsigned int workersNb, PageQueue const* queue, StageCounters const& counters);
+
+/*!
+	\brief
+	Milliseconds elapsed since the tick count start
+
+	\param start tick count
+*/
+static double	getElapsedMs(long long start);
+
+/*!
+	\brief
+	Whether a file of a directory is an image, from its extension
+
+	\param path path of the file
+*/
+static bool		isImageFile(std::string const& path);
+
+/*!
+	\brief
+	Size of an image read in the header of its file (see getPageFootprint), false if the format is not known or the header can't be read
+
+	\param path path of the image
+	\param rows number of rows of the image
+	\param cols number of columns of the image
+*/
+static bool		readImageSize(std::string const& path, int& rows, int& cols);
+
+/*!
+	\brief
+	Size of a JPEG image, in the first SOF segment (the segments before it are skipped with their length)
+
+	\param file file of the image
+	\param rows see readImageSize
+	\param cols see readImageSize
+*/
+static bool		readJpegSize(std::ifstream& file, int& rows, int& cols);
+
+/*!
+	\brief
+	Size of a TIFF image, in the tags ImageWidth and ImageLength of its first IFD
+
+	\param file file of the image
+	\param isBigEndian the file begins with "MM" (else "II")
+	\param rows see readImageSize
+	\param cols see readImageSize
+*/
+static bool		readTiffSize(std::ifstream& file, bool isBigEndian, int& rows, int& cols);
+
+/*!
+	\brief
+	Read size bytes of a file from offset
+
+	\param file file to read
+	\param offset position of the first byte in the file
+	\param size number of bytes
+	\param bytes buffer of size bytes
+*/
+static bool		readBytes(std::ifstream& file, std::streamoff offset, std::size_t size, unsigned char* bytes);
+
+/*!
+	\brief
+	Unsigned integer of size bytes (at most 4)
+
+	\param bytes bytes of the integer
+	\param size number of bytes
+	\param isBigEndian the first byte is the most significant one
+*/
+static std::uint32_t	getUnsigned(unsigned char const* bytes, int size, bool isBigEndian);
+
+std::vector<std::string>	listPages(std::string const& source)
+{
+	std::vector<std::string>	pages;
+	std::vector<std::string>	files;
+	std::ifstream				listFile;
+	std::string					line;
+	struct stat					info;
+
+	if(stat(source.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+	{
+		cv::glob(source, files, false);
+		for(auto const& file : files)
+		{
+			if(isImageFile(file))
+			{
+				pages.push_back(file);
+			}
+		}
+	}
+	else if(source.find_first_of("*?[") != std::string::npos)
+	{
+		cv::glob(source, pages, false);
+	}
+	else
+	{
+		listFile.open(source);
+		if(!listFile)
+		{
+			throw std::invalid_argument("'" + source + "' can't be read");
+		}
+		while(std::getline(listFile, line))
+		{
+			// the blanks at the end of a line (the '\r' of a file written on Windows) are not a part of its path
+			while(!line.empty() && std::isspace(static_cast<unsigned char>(line.back())))
+			{
+				line.pop_back();
+			}
+			if(!line.empty())
+			{
+				pages.push_back(line);
+			}
+		}
+	}
+	return pages;
+}
+
+std::size_t		getPageFootprint(std::string const& path)
+{
+	int		rows = 0;
+	int		cols = 0;
+
+	if(!readImageSize(path, rows, cols))
+	{
+		return 0;
+	}
+	return static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols) * PAGE_BYTES_PER_PIXEL;
+}
+
+std::vector<PageReport>		runBatch(std::vector<std::string> const& pages, BatchSettings const& settings, BinarizationMode mode, TrackingMode trackingMode, ResultSink& sink, std::vector<StageStatistics>& statistics)
+{
+	Batch						batch(pages, settings, mode, trackingMode, sink);
+	TaskPool					analysers(batch.analysersNb);
+	std::vector<std::thread>	decoders;
+	std::vector<std::thread>	writers;
+
+	// the writers wake the analysers until their last page : the pool is given up once the writers are over
+	batch.analysers = &analysers;
+	// an analyser runs on every worker of the pool until the decoders are over
+	for(unsigned int i = 0; i < batch.analysersNb; ++i)
+	{
+		analysers.submit([&batch]() { analysePages(batch); });
+	}
+	for(unsigned int i = 0; i < batch.decodersNb; ++i)
+	{
+		decoders.push_back(std::thread(decodePages, std::ref(batch)));
+	}
+	for(unsigned int i = 0; i < batch.writersNb; ++i)
+	{
+		writers.push_back(std::thread(writePages, std::ref(batch)));
+	}
+	for(auto& decoder : decoders)
+	{
+		decoder.join();
+	}
+	analysers.wait();
+	for(auto& writer : writers)
+	{
+		writer.join();
+	}
+	statistics.clear();
+	statistics.push_back(getStageStatistics("decoding", batch.decodersNb, nullptr, batch.decoding));
+	statistics.push_back(getStageStatistics("setup", batch.analysersNb, &batch.decodedPages, batch.analysis));
+	statistics.push_back(getStageStatistics("writing", batch.writersNb, &batch.analysedPages, batch.writing));
+	return batch.reports;
+}
+
+void	printBatchReport(std::vector<PageReport> const& reports, std::ostream& stream)
+{
+	unsigned int	failedNb = 0;
+
+	for(auto const& report : reports)
+	{
+		stream << report.path << " : ";
+		if(report.isDone)
+		{
+			stream << report.stavesNb << " staves, interline " << report.interline;
+		}
+		else
+		{
+			stream << "failed, " << report.error;
+			++failedNb;
+		}
+		stream << " (" << report.ms << " ms)" << std::endl;
+	}
+	stream << reports.size() - failedNb << " pages set up, " << failedNb << " failed" << std::endl;
+}
+
+void	printStageStatistics(std::vector<StageStatistics> const& statistics, std::ostream& stream)
+{
+	for(auto const& stage : statistics)
+	{
+		stream << stage.name << " : " << stage.workersNb << " workers, ";
+		if(stage.queueCapacity > 0)
+		{
+			stream << "up to " << stage.maxQueueDepth << " of " << stage.queueCapacity << " pages waiting, ";
+		}
+		stream << stage.inputStalls << " input stalls, " << stage.outputStalls << " output stalls, " << stage.stalledMs << " ms stalled" << std::endl;
+	}
+}
+
+StageCounters::StageCounters() :
+	inputStalls(0),
+	outputStalls(0),
+	stalledTicks(0)
+{
+
+}
+
+Batch::Batch(std::vector<std::string> const& pages, BatchSettings const& settings, BinarizationMode mode, TrackingMode trackingMode, ResultSink& sink) :
+	pages(pages),
+	mode(mode),
+	trackingMode(trackingMode),
+	sink(sink),
+	decodersNb(std::max(settings.decodersNb, 1u)),
+	analysersNb(std::max(settings.analysersNb, 1u)),
+	writersNb(std::max(settings.writersNb, 1u)),
+	memoryBudget(settings.memoryBudget),
+	reports(pages.size(), {"", false, "", 0, 0, 0.0}),
+	footprints(pages.size(), 0),
+	order(pages.size(), 0),
+	usedMemory(0),
+	decodedPages(settings.queueCapacity),
+	analysedPages(settings.queueCapacity),
+	analysers(nullptr),
+	runningDecodersNb(decodersNb),
+	runningAnalysersNb(analysersNb)
+{
+	for(std::size_t i = 0; i < pages.size(); ++i)
+	{
+		reports.at(i).path = pages.at(i);
+		// a page whose size is unknown takes the whole budget : it runs alone
+		footprints.at(i) = getPageFootprint(pages.at(i));
+		if(footprints.at(i) == 0 || footprints.at(i) > memoryBudget)
+		{
+			footprints.at(i) = memoryBudget;
+		}
+	}
+	// the biggest pages first : the last pages of the batch are the shortest ones, the analysers without a page steal the tasks of their staves
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return footprints.at(a) > footprints.at(b); });
+}
+
+static void		decodePages(Batch& batch)
+{
+	PageItem		item;
+	std::size_t		page = 0;
+	long long		start = 0;
+
+	while(takePage(batch, page))
+	{
+		start = cv::getTickCount();
+		item.page = page;
+		try
+		{
+			item.score = cv::imread(batch.pages.at(page), cv::IMREAD_GRAYSCALE);
+			if(item.score.empty())
+			{
+				batch.reports.at(page).error = "'" + batch.pages.at(page) + "' can't be read";
+			}
+		}
+		catch(std::exception& e)
+		{
+			item.score = cv::Mat();
+			batch.reports.at(page).error = e.what();
+		}
+		batch.reports.at(page).ms += getElapsedMs(start);
+		if(item.score.empty())
+		{
+			releasePage(batch, page);
+		}
+		else
+		{
+			pushPage(batch, batch.decodedPages, item, batch.decoding);
+		}
+	}
+	// the last decoder tells every analyser that no page will follow
+	if(--batch.runningDecodersNb == 0)
+	{
+		for(unsigned int i = 0; i < batch.analysersNb; ++i)
+		{
+			item.page = PAGE_ITEM_END;
+			item.score = cv::Mat();
+			pushPage(batch, batch.decodedPages, item, batch.decoding);
+		}
+	}
+}
+
+static void		analysePages(Batch& batch)
+{
+	PageItem		item;
+	PageWorkspace	workspace;
+	long long		start = 0;
+
+	while(true)
+	{
+		popPage(batch, batch.decodedPages, item, batch.analysis);
+		if(item.page == PAGE_ITEM_END)
+		{
+			break;
+		}
+		start = cv::getTickCount();
+		item.staves.reset(new Staves());
+		try
+		{
+			item.staves->setup(item.score, workspace, batch.mode, batch.trackingMode);
+		}
+		catch(std::exception& e)
+		{
+			batch.reports.at(item.page).error = e.what();
+			item.staves.reset();
+		}
+		// the staves keep the binarized page, the page in gray scale is no longer needed
+		item.score = cv::Mat();
+		batch.reports.at(item.page).ms += getElapsedMs(start);
+		pushPage(batch, batch.analysedPages, item, batch.analysis);
+	}
+	// the last analyser tells every writer that no page will follow
+	if(--batch.runningAnalysersNb == 0)
+	{
+		for(unsigned int i = 0; i < batch.writersNb; ++i)
+		{
+			item.page = PAGE_ITEM_END;
+			item.staves.reset();
+			pushPage(batch, batch.analysedPages, item, batch.analysis);
+		}
+	}
+}
+
+static void		writePages(Batch& batch)
+{
+	PageItem	item;
+	long long	start = 0;
+
+	while(true)
+	{
+		popPage(batch, batch.analysedPages, item, batch.writing);
+		if(item.page == PAGE_ITEM_END)
+		{
+			break;
+		}
+		PageReport&		report = batch.reports.at(item.page);
+
+		start = cv::getTickCount();
+		if(item.staves)
+		{
+			try
+			{
+				batch.sink.putGeometry(report.path, *item.staves);
+				report.isDone = true;
+				report.stavesNb = item.staves->getStavesNb();
+				report.interline = item.staves->getInterline();
+			}
+			catch(std::exception& e)
+			{
+				report.error = e.what();
+			}
+		}
+		item.staves.reset();
+		report.ms += getElapsedMs(start);
+		releasePage(batch, item.page);
+	}
+}
+
+static bool		takePage(Batch& batch, std::size_t& page)
+{
+	std::unique_lock<std::mutex>		lock(batch.memoryMutex);
+	std::vector<std::size_t>::iterator	next;
+	long long							start = 0;
+	auto								isReady = [&batch, &next]()
+	{
+		next = std::find_if(batch.order.begin(), batch.order.end(), [&batch](std::size_t i) { return batch.usedMemory == 0 || batch.usedMemory + batch.footprints.at(i) <= batch.memoryBudget; });
+		return batch.order.empty() || next != batch.order.end();
+	};
+
+	if(!isReady())
+	{
+		++batch.decoding.inputStalls;
+		start = cv::getTickCount();
+		batch.released.wait(lock, isReady);
+		batch.decoding.stalledTicks += cv::getTickCount() - start;
+	}
+	if(batch.order.empty())
+	{
+		return false;
+	}
+	page = *next;
+	batch.order.erase(next);
+	batch.usedMemory += batch.footprints.at(page);
+	return true;
+}
+
+static void		releasePage(Batch& batch, std::size_t page)
+{
+	{
+		std::lock_guard<std::mutex>	lock(batch.memoryMutex);
+		batch.usedMemory -= batch.footprints.at(page);
+	}
+	batch.released.notify_all();
+}
+
+static void		pushPage(Batch& batch, PageQueue& queue, PageItem& item, StageCounters& counters)
+{
+	long long	start = 0;
+
+	if(!queue.tryPush(item))
+	{
+		++counters.outputStalls;
+		start = cv::getTickCount();
+		// an analyser works on the staves of the other pages rather than sleeping
+		if(TaskPool::getCurrent() == batch.analysers)
+		{
+			batch.analysers->runChunksUntil([&queue, &item]() { return queue.tryPush(item); });
+		}
+		else
+		{
+			queue.push(item);
+		}
+		counters.stalledTicks += cv::getTickCount() - start;
+	}
+	batch.analysers->wakeUp();
+}
+
+static void		popPage(Batch& batch, PageQueue& queue, PageItem& item, StageCounters& counters)
+{
+	long long	start = 0;
+
+	if(!queue.tryPop(item))
+	{
+		++counters.inputStalls;
+		start = cv::getTickCount();
+		// an analyser works on the staves of the other pages rather than sleeping
+		if(TaskPool::getCurrent() == batch.analysers)
+		{
+			batch.analysers->runChunksUntil([&queue, &item]() { return queue.tryPop(item); });
+		}
+		else
+		{
+			queue.pop(item);
+		}
+		counters.stalledTicks += cv::getTickCount() - start;
+	}
+	batch.analysers->wakeUp();
+}
+
+static StageStatistics	getStageStatistics(std::string const& name, unsigned int workersNb, PageQueue const* queue, StageCounters const& counters)
+{
+	StageStatistics		statistics;
+
+	statistics.name = name;
+	statistics.workersNb = workersNb;
+	statistics.queueCapacity = (queue != nullptr ? queue->getCapacity() : 0);
+	statistics.maxQueueDepth = (queue != nullptr ? queue->getMaxDepth() : 0);
+	statistics.inputStalls = counters.inputStalls.load();
+	statistics.outputStalls = counters.outputStalls.load();
+	statistics.stalledMs = static_cast<double>(counters.stalledTicks.load()) * 1000.0 / cv::getTickFrequency();
+	return statistics;
+}
+
+static double	getElapsedMs(long long start)
+{
+	return static_cast<double>(cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+static bool		isImageFile(std::string const& path)
+{
+	static char const* const	EXTENSIONS[] = {"png", "jpg", "jpeg", "tif", "tiff", "pgm", "pbm", "ppm", "pnm", "bmp"};
+	std::size_t					dot = path.find_last_of('.');
+	std::string					extension;
+
+	if(dot == std::string::npos)
+	{
+		return false;
+	}
+	for(char c : path.substr(dot + 1))
+	{
+		extension.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+	}
+	return std::find(std::begin(EXTENSIONS), std::end(EXTENSIONS), extension) != std::end(EXTENSIONS);
+}
+
+static bool		readImageSize(std::string const& path, int& rows, int& cols)
+{
+	std::ifstream	file(path, std::ios::binary);
+	unsigned char	header[26] = {0};
+	bool			isRead = false;
+
+	if(!file || !readBytes(file, 0, 2, header))
+	{
+		return false;
+	}
+	if(header[0] == 0x89 && header[1] == 'P' && readBytes(file, 0, 24, header))
+	{
+		// PNG : the chunk IHDR comes first, its width and height follow its type
+		cols = getUnsigned(header + 16, 4, true);
+		rows = getUnsigned(header + 20, 4, true);
+		isRead = true;
+	}
+	else if(header[0] == 0xFF && header[1] == 0xD8)
+	{
+		isRead = readJpegSize(file, rows, cols);
+	}
+	else if((header[0] == 'I' && header[1] == 'I') || (header[0] == 'M' && header[1] == 'M'))
+	{
+		isRead = readTiffSize(file, header[0] == 'M', rows, cols);
+	}
+	else if(header[0] == 'B' && header[1] == 'M' && readBytes(file, 0, 26, header))
+	{
+		// BMP : the height is negative when the rows are stored from the top
+		cols = static_cast<std::int32_t>(getUnsigned(header + 18, 4, false));
+		rows = std::abs(static_cast<std::int32_t>(getUnsigned(header + 22, 4, false)));
+		isRead = true;
+	}
+	else if(header[0] == 'P' && header[1] >= '1' && header[1] <= '6')
+	{
+		// PNM : the width and the height are the first numbers after the magic number, between blanks and comments
+		file.clear();
+		file.seekg(2);
+		for(int* value : {&cols, &rows})
+		{
+			while(file && (std::isspace(file.peek()) || file.peek() == '#'))
+			{
+				if(file.get() == '#')
+				{
+					file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+				}
+			}
+			file >> *value;
+		}
+		isRead = !file.fail();
+	}
+	return isRead && rows > 0 && cols > 0;
+}
+
+static bool		readJpegSize(std::ifstream& file, int& rows, int& cols)
+{
+	unsigned char	segment[9] = {0};
+	std::streamoff	offset = 2;
+	int				marker = 0;
+
+	while(readBytes(file, offset, 4, segment) && segment[0] == 0xFF)
+	{
+		marker = segment[1];
+		if(marker == 0xFF)
+		{
+			// fill byte before a marker
+			++offset;
+		}
+		else if(marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+		{
+			// markers without a segment
+			offset += 2;
+		}
+		else if(marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+		{
+			// start of frame : length, precision, height and width
+			if(!readBytes(file, offset, 9, segment))
+			{
+				return false;
+			}
+			rows = getUnsigned(segment + 5, 2, true);
+			cols = getUnsigned(segment + 7, 2, true);
+			return true;
+		}
+		else if(marker == 0xDA || marker == 0xD9)
+		{
+			// the image data begins (or ends) before any frame
+			return false;
+		}
+		else
+		{
+			offset += 2 + getUnsigned(segment + 2, 2, true);
+		}
+	}
+	return false;
+}
+
+static bool		readTiffSize(std::ifstream& file, bool isBigEndian, int& rows, int& cols)
+{
+	unsigned char	bytes[12] = {0};
+	std::streamoff	ifdOffset = 0;
+	int				entriesNb = 0;
+	int				tag = 0;
+	int				value = 0;
+
+	if(!readBytes(file, 4, 4, bytes))
+	{
+		return false;
+	}
+	ifdOffset = getUnsigned(bytes, 4, isBigEndian);
+	if(!readBytes(file, ifdOffset, 2, bytes))
+	{
+		return false;
+	}
+	entriesNb = getUnsigned(bytes, 2, isBigEndian);
+	rows = 0;
+	cols = 0;
+	for(int e = 0; e < entriesNb && (rows == 0 || cols == 0); ++e)
+	{
+		// an entry is its tag, its type, its count and its value (a SHORT is in the first 2 bytes of the value)
+		if(!readBytes(file, ifdOffset + 2 + 12 * e, 12, bytes))
+		{
+			return false;
+		}
+		tag = getUnsigned(bytes, 2, isBigEndian);
+		value = (getUnsigned(bytes + 2, 2, isBigEndian) == 3 ? getUnsigned(bytes + 8, 2, isBigEndian) : getUnsigned(bytes + 8, 4, isBigEndian));
+		if(tag == 256)
+		{
+			cols = value;
+		}
+		else if(tag == 257)
+		{
+			rows = value;
+		}
+	}
+	return rows > 0 && cols > 0;
+}
+
+static bool		readBytes(std::ifstream& file, std::streamoff offset, std::size_t size, unsigned char* bytes)
+{
+	file.clear();
+	file.seekg(offset);
+	file.read(reinterpret_cast<char*>(bytes), size);
+	return static_cast<std::size_t>(file.gcount()) == size;
+}
+
+static std::uint32_t	getUnsigned(unsigned char const* bytes, int size, bool isBigEndian)
+{
+	std::uint32_t	value = 0;
+
+	for(int i = 0; i < size; ++i)
+	{
+		value |= static_cast<std::uint32_t>(bytes[i]) << (8 * (isBigEndian ? size - 1 - i : i));
+	}
+	return value;
+}
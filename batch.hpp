@@ -0,0 +1,104 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+#include <opencv2/core/core.hpp>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "tools.hpp"
+#include "StaveTracker.hpp"
+
+class ResultSink;
+
+/*!
+	\struct PageReport
+	\brief PageReport stores the result of a page of a batch (see runBatch)
+*/
+struct PageReport
+{
+	std::string		path;		///< path of the image of the page
+	bool			isDone;		///< the staves of the page are set up
+	std::string		error;		///< why the page failed when it is not done
+	unsigned int	stavesNb;	///< number of staves found on the page
+	int				interline;	///< interline of the page
+	double			ms;			///< time spent on the page by the stages (decoding, setup and writing), without its waits in the queues
+};
+
+/*!
+	\struct BatchSettings
+	\brief BatchSettings stores the sizes of the stages of runBatch
+*/
+struct BatchSettings
+{
+	unsigned int	decodersNb;		///< number of workers decoding the images of the pages
+	unsigned int	analysersNb;	///< number of workers setting up the staves of the pages (the workers of the TaskPool)
+	unsigned int	writersNb;		///< number of workers giving the geometry of the pages to the sink
+	std::size_t		queueCapacity;	///< number of pages between 2 stages (see PageQueue)
+	std::size_t		memoryBudget;	///< bound of the sum of the footprints of the pages in progress, in bytes (see getPageFootprint)
+};
+
+/*!
+	\struct StageStatistics
+	\brief StageStatistics stores how a stage of runBatch waited, to size the stages : a stage that often finds its input empty waits for the stage before it, a stage that often finds its output full waits for the stage after it
+*/
+struct StageStatistics
+{
+	std::string		name;			///< name of the stage
+	unsigned int	workersNb;		///< number of workers of the stage
+	std::size_t		queueCapacity;	///< capacity of the queue read by the stage (0 for the decoding, which reads the list of the pages)
+	std::size_t		maxQueueDepth;	///< most pages seen in that queue
+	std::size_t		inputStalls;	///< times a worker found nothing to read (for the decoding : no room left in the memory budget for the next page)
+	std::size_t		outputStalls;	///< times a worker found the queue of the next stage full
+	double			stalledMs;		///< time spent by the workers of the stage waiting, summed over the workers
+};
+
+/*!
+	\brief
+	Paths of the pages of a batch : the images of a directory (sorted by name), the files matching a pattern with wildcards (see cv::glob), or else the paths listed in a file, one per line. Throw std::invalid_argument if the list file can't be read
+
+	\param source directory, pattern or list file
+*/
+std::vector<std::string>	listPages(std::string const& source);
+
+/*!
+	\brief
+	Memory needed to set up the staves of a page, estimated from the size of its image read in the header of the file (PNG, JPEG, TIFF, PNM and BMP) without decoding it. 0 if the size can't be read
+
+	\param path path of the image
+*/
+std::size_t					getPageFootprint(std::string const& path);
+
+/*!
+	\brief
+	Set up the staves of every page with a pipeline of 3 stages linked by bounded queues (see PageQueue) : the decoders read the images of the pages, the analysers set up their staves and the writers give their geometry to sink, so that the decoding and the writing overlap with the setup. A stage whose output queue is full waits for the next one (backpressure).
+	The analysers are the workers of a TaskPool : the tasks of the staves of a page can be stolen by the analysers that have no page left, or that wait for the decoders. The pages are decoded from the biggest to the smallest so that the end of the batch is made of small pages, a page is only decoded once the footprints of the pages in progress leave room for its own in the memory budget (the next smaller page that fits is decoded first when the next one does not), its memory is given back once it is written. A page whose footprint is unknown or bigger than the budget runs alone
+
+	\param pages paths of the pages (see listPages)
+	\param settings sizes of the stages
+	\param mode see Staves::setup
+	\param trackingMode see Staves::setup
+	\param sink see ResultSink::putGeometry, it is called by several writers at the same time when there are several
+	\param statistics waits of the decoding, the setup and the writing
+	\return the report of every page, in the order of pages
+*/
+std::vector<PageReport>		runBatch(std::vector<std::string> const& pages, BatchSettings const& settings, BinarizationMode mode, TrackingMode trackingMode, ResultSink& sink, std::vector<StageStatistics>& statistics);
+
+/*!
+	\brief
+	Write one line for every page (its staves or its error) and a line of summary
+
+	\param reports see runBatch
+	\param stream stream of the lines
+*/
+void						printBatchReport(std::vector<PageReport> const& reports, std::ostream& stream);
+
+/*!
+	\brief
+	Write one line for every stage of a batch with its waits
+
+	\param statistics see runBatch
+	\param stream stream of the lines
+*/
+void						printStageStatistics(std::vector<StageStatistics> const& statistics, std::ostream& stream);
+
+#endif
@@ -0,0 +1,1684 @@
+#include "benchmark.hpp"
+#include "tools.hpp"
+#include "staveDetection.hpp"
+#include "preprocessing.hpp"
+#include "profiles.hpp"
+#include "runLengths.hpp"
+#include "SlopeModel.hpp"
+#include "Staves.hpp"
+#include "PageWorkspace.hpp"
+#include "allocations.hpp"
+#include "StripSource.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*!
+	\brief
+	Number of iterations of every timed function, the reported time is the average one
+*/
+static int const	ITERATIONS_NB = 3;
+
+/*!
+	\brief
+	Width in pixels of an A4 page scanned at 600 dpi, the page of the benchmark is scaled to it to time the line thickness histogram on the largest pages
+*/
+static int const	HIGH_RESOLUTION_COLS = 4960;
+
+/*!
+	\brief
+	Milliseconds elapsed since the tick count start
+*/
+static double	getElapsedMs(long long start);
+
+/*!
+	\brief
+	Print the times of a reference implementation and of its optimized version, and whether their results are the same
+*/
+static void		printComparison(std::string const& name, double referenceMs, double optimizedMs, bool isSameResult);
+
+/*!
+	\brief
+	Pixel by pixel implementation of correlation() kept as the reference of the bit packed one
+
+	\param binaryImg binarized image of the page of score
+*/
+static int		scalarCorrelation(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Compare scalarCorrelation() and correlation()
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkCorrelation(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Compare the exhaustive search of correlation() with the coarse to fine one of estimateSlope()
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkSlopeEstimation(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Number of rows of the band of the page given to benchmarkSmallSlopeEstimation, too few to be decimated by estimateSlope
+*/
+static int const	SMALL_SLOPE_ROWS = 400;
+
+/*!
+	\brief
+	Pixel by pixel search of the estimate of estimateSlope over the whole range of shifts [-range; range], kept as the reference of the images that are not decimated : the best shift (the smallest one for equal correlations), its correlation and the vertex of the parabola through the correlations around it
+
+	\param binaryImg binarized image
+	\param range half size of the range of shifts
+*/
+static SlopeEstimate	scalarSlopeEstimate(cv::Mat const& binaryImg, int range);
+
+/*!
+	\brief
+	Compare scalarSlopeEstimate() and estimateSlope() on a band of SMALL_SLOPE_ROWS rows around the middle of the page (the size of the band of a stave)
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkSmallSlopeEstimation(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Time correlation() and estimateSlope() from 1 thread to the number of CPUs, compared with 1 thread (the bands of rows of the page are compared in parallel, the result must not depend on the number of threads)
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkSlopeScaling(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Time Staves::setup on 1 thread, then on 2 and up to the number of cores, and check that the staves are the ones set up on 1 thread
+
+	\param score image of one page of score in gray scale
+*/
+static void		benchmarkSetupScaling(cv::Mat const& score);
+
+/*!
+	\brief
+	true if both 8 bits images have the same size and the same pixels
+*/
+static bool		isSameImage(cv::Mat const& img1, cv::Mat const& img2);
+
+/*!
+	\brief
+	Pixel by pixel implementation of correctSlope() kept as the reference of the shear one
+
+	\param binaryImg binarized image of the page of score
+	\param hMax see correlation
+*/
+static cv::Mat	scalarCorrectSlope(cv::Mat const& binaryImg, int hMax);
+
+/*!
+	\brief
+	Compare scalarCorrectSlope() and correctSlope(), in a new image and in place
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkCorrectSlope(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Compare the successive binarize, correctSlope and getHorizontalProfile with preprocessScore()
+
+	\param score image of one page of score in gray scale
+*/
+static void		benchmarkPreprocessing(cv::Mat const& score);
+
+/*!
+	\brief
+	Compare scalarLineThicknessHistogram() with getLineThicknessHistogram() on the bit plane of the page, the one of Staves::setup
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkBitPlane(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Column by column implementation of getLineThicknessHistogram() kept as its reference (a run also stops at the bottom of the page)
+
+	\param middleLineAbscs see getLineThicknessHistogram
+	\param heightSize see getLineThicknessHistogram
+	\param binaryImg binarized image of the page of score
+*/
+static std::vector<int>	scalarLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Compare scalarLineThicknessHistogram() with getLineThicknessHistogram() on the 8 bits page (packed on every call)
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkLineThickness(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	benchmarkBitPlane and benchmarkLineThickness on the page scaled to HIGH_RESOLUTION_COLS columns (its lines of stave are as thick as on a page scanned at 600 dpi)
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkHighResolution(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Pixel by pixel implementation of getHorizontalProfile() kept as the reference of getRowProfile(), with the image of the profile it built on every call
+
+	\param binaryImg binarized image of the page of score
+*/
+static std::vector<int>	scalarRowProfile(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Column by column implementation of a vertical profile (the loop of getVerticalProfile()) kept as the reference of getColProfile()
+
+	\param binaryImg binarized image of the page of score
+*/
+static std::vector<int>	scalarColProfile(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Compare scalarRowProfile() and scalarColProfile() with getRowProfile() and getColProfile() on the 8 bits page and on its bit plane
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkProfiles(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Compare findInterline() followed by getLineThicknessHistogram() with getRunStatistics() (same result if both find the same interline and thickness0)
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkRunStatistics(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Loop of 15 taps with bounds checks on every row (the former getStavesProfileVect()) kept as the reference of CombFilter
+
+	\param profileVect see getStavesProfileVect
+	\param interline see getStavesProfileVect
+*/
+static std::vector<int>	scalarStavesProfile(std::vector<int> const& profileVect, int interline);
+
+/*!
+	\brief
+	Compare scalarStavesProfile() with getStavesProfileVect() on the horizontal profile of the page
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkStavesProfile(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Scan of the former getLocMaxima() kept as the reference of findPeaks() : every candidate greater than the current maximum re-reads its window of 2 * range values
+
+	\param data see getStavesProfileVect
+	\param range minimum range between 2 local maxima
+*/
+static std::vector<int>	scalarLocMaxima(std::vector<int> const& data, int range);
+
+/*!
+	\brief
+	Compare scalarLocMaxima() with detectMiddleLineAbsc() on the stave profile of the page corrected from its slope
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkPeaks(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Check scalarLocMaxima() and getLocMaxima() on fixed stave profiles whose maxima are known : the ones where both agree and the ones where the former scan depends on its order
+
+	\return whether every profile gives the expected maxima
+*/
+static bool		checkFixedPeaks();
+
+/*!
+	\brief
+	Count of the black pixels of one column on the 5 lines of a stave for every vertical shift (the former getMaxDeltaOrdProfile()) kept as the reference of getStaveExtentProfile()
+
+	\param interline see getStaveExtentProfile
+	\param subImgCenter see getStaveExtentProfile
+	\param subImg see getStaveExtentProfile
+	\param thickness0 see getStaveExtentProfile
+	\param col considered column
+*/
+static bool		checkFixedPeaks()
+{
+	struct FixedProfile
+	{
+		std::vector<int>	data;
+		int					range;
+		std::vector<int>	formerMaxima;
+		std::vector<int>	maxima;
+	};
+	// the former scan and getLocMaxima differ on the last 3 profiles only : the former scan keeps the first candidate and skips the higher one range away, then a candidate rejected by this skipped one raises the maximum and hides the next stave
+	std::vector<FixedProfile> const	profiles =
+	{
+		// 3 staves and noise
+		{{0, 1, 0, 2, 0, 1, 9, 1, 0, 2, 1, 0, 0, 1, 8, 2, 0, 1, 0, 2, 1, 0, 9, 1, 0, 1, 0}, 4, {6, 14, 22}, {6, 14, 22}},
+		// a lower candidate before a stave within range
+		{{0, 0, 0, 1, 2, 6, 1, 0, 9, 2, 1, 0, 0, 0, 0, 1, 0, 0, 0, 8, 1, 0, 0, 0, 0}, 4, {8, 19}, {8, 19}},
+		// plateaus : the first index of equal maxima
+		{{0, 0, 1, 0, 0, 7, 7, 1, 0, 0, 1, 0, 0, 8, 1, 0, 0, 0, 1, 0, 7, 7, 7, 0, 0, 0, 0}, 4, {5, 13, 20}, {5, 13, 20}},
+		// the maxima closer than range to the borders are left out
+		{{9, 5, 1, 0, 0, 1, 0, 8, 1, 0, 0, 0, 0, 1, 0, 0, 0, 1, 7, 1, 0, 0, 0, 9}, 4, {7, 18}, {7, 18}},
+		// a maximum lower than a third of the global maximum is not a stave
+		{{0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 4, {14}, {14}},
+		// a maximum on a shoulder of a higher one, more than range away, is kept
+		{{0, 0, 0, 0, 9, 8, 8, 8, 8, 7, 8, 8, 0, 0, 0, 0, 0, 0, 0, 0}, 4, {4, 10}, {4, 10}},
+		// the edge of a black band on the border : the former scan keeps the first row it reads, getLocMaxima the first row more than range after the border
+		{{9, 9, 9, 9, 9, 9, 8, 7, 6, 1, 0, 1, 0, 0, 0, 1, 9, 1, 0, 0, 0, 0, 1, 0, 0, 0}, 4, {4, 16}, {5, 16}},
+		// a higher maximum range away after a candidate
+		{{0, 0, 0, 0, 0, 6, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0}, 4, {5, 18}, {9, 18}},
+		// the same, then a stave as high as the candidate rejected after the skip
+		{{0, 0, 0, 0, 0, 5, 0, 0, 0, 9, 0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0}, 4, {5}, {9, 20}}
+	};
+	bool	isExpected = true;
+
+	for(auto const& profile : profiles)
+	{
+		isExpected = isExpected && scalarLocMaxima(profile.data, profile.range) == profile.formerMaxima && getLocMaxima(profile.data, profile.range) == profile.maxima;
+	}
+	return isExpected;
+}
+
+static int		scalarMaxDeltaOrdProfile(int interline, int subImgCenter, cv::Mat const& subImg, int thickness0, int col);
+
+/*!
+	\brief
+	Former getLeftOrd() of getStaveOrds() for one threshold, its window of 2 interlines is stopped at the right border
+
+	\param profile see getStaveExtentProfile
+	\param thresh threshold of the profile
+	\param interline see getStavesProfileVect
+*/
+static int		scalarLeftOrd(std::vector<int> const& profile, int thresh, int interline);
+
+/*!
+	\brief
+	Former getRightOrd() of getStaveOrds() for one threshold
+*/
+static int		scalarRightOrd(std::vector<int> const& profile, int thresh, int interline);
+
+/*!
+	\brief
+	Compare scalarMaxDeltaOrdProfile() on every column with getStaveExtentProfile() on the sub images of the staves of the page, then the decreasing thresholds of scalarLeftOrd() and scalarRightOrd() with getStaveOrds()
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkStaveExtent(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Former getMiddleLineAbsc() : correlation of the mask of the stave with every pixel of the sub image in doubles, the rows out of the sub image are white
+
+	\param middleLineAbsc see getMiddleLineAbsc
+	\param interline see getMiddleLineAbsc
+	\param thickness0 see getMiddleLineAbsc
+	\param subImgI see getMiddleLineAbsc
+	\param leftOrd see getMiddleLineAbsc
+	\param rightOrd see getMiddleLineAbsc
+*/
+static std::vector<int>	scalarMiddleLineAbsc(int middleLineAbsc, int interline, int thickness0, cv::Mat const& subImgI, int leftOrd, int rightOrd);
+
+/*!
+	\brief
+	Compare scalarMiddleLineAbsc() with getMiddleLineAbsc() on the staves of the page
+
+	\param binaryImg binarized image of the page of score
+*/
+static void		benchmarkMiddleLine(cv::Mat const& binaryImg);
+
+/*!
+	\brief
+	Former loop of Staves::erase() on one stave : the vertical black segment is followed pixel by pixel from the line, the rows out of the image are white
+
+	\param staveImg copy of the image of the stave, the lines are erased in it
+	\param stave stave whose lines are erased
+	\param thicknessThresh see Staves::erase
+*/
+static void		scalarEraseStave(cv::Mat& staveImg, Stave const& stave, int thicknessThresh);
+
+/*!
+	\brief
+	Compare scalarEraseStave() on every stave with Staves::erase()
+
+	\param score image of the page of score in gray scale
+*/
+static void		benchmarkErase(cv::Mat const& score);
+
+/*!
+	\brief
+	Compare Staves::setup() on a new instance for every iteration with Staves::setup() of the same instance on a workspace kept from one iteration to another, and print how many heap allocations and pixel buffers the setup on the warm workspace made on a single thread (the scheduling of the tasks allocates memory)
+
+	\param score image of the page of score in gray scale
+*/
+static void		benchmarkWorkspace(cv::Mat const& score);
+
+/*!
+	\brief
+	Number of rows of the strips read by benchmarkStreaming
+*/
+static int const	STREAM_STRIP_ROWS = 256;
+
+/*!
+	\brief
+	Whether 2 pages have the same staves : the same ordinates, lines and images
+
+	\param referenceStaves staves of a page
+	\param staves staves of the same page set up another way
+*/
+static bool		isSameStaves(Staves const& referenceStaves, Staves const& staves);
+
+/*!
+	\brief
+	Compare Staves::setup() of a page in memory with Staves::setup() of the same page read by strips of STREAM_STRIP_ROWS rows (the staves keep their images to be compared), both on a warm workspace
+
+	\param score image of the page of score in gray scale
+*/
+static void		benchmarkStreaming(cv::Mat const& score);
+
+/*!
+	\brief
+	Staves of the synthetic pages of benchmarkLighting : 5 lines of LIGHTING_THICKNESS rows every LIGHTING_INTERLINE rows, one stave every LIGHTING_STAVE_SPACING rows, going down by LIGHTING_DROP rows from their left end to their right one
+*/
+static int const	LIGHTING_STAVES_NB = 6;
+static int const	LIGHTING_INTERLINE = 16;
+static int const	LIGHTING_THICKNESS = 2;
+static int const	LIGHTING_STAVE_SPACING = 200;
+static int const	LIGHTING_DROP = 20;
+
+/*!
+	\brief
+	Synthetic page of LIGHTING_STAVES_NB black staves on a white background, lit evenly or by a gradient going from full light in the top left corner to 40% of it in the bottom right one (as a photo taken with a lamp on one side) : the background falls below the fixed threshold on most of the page
+
+	\param isLitByGradient the page is lit by the gradient, else evenly
+*/
+static cv::Mat	getSyntheticScore(bool isLitByGradient);
+
+/*!
+	\brief
+	Staves::setup of a synthetic page lit by a gradient with the fixed threshold and with the adaptive ones, compared with the slope and the number of staves of the same page lit evenly
+
+	\return whether the adaptive binarizations find the slope and the staves of the page lit evenly
+*/
+static bool		checkLighting();
+
+void	benchmark(cv::Mat const& score)
+{
+	cv::Mat	binaryImg = binarize(score, 220);
+
+	std::cout << "benchmark on a page of " << score.cols << " x " << score.rows << " pixels (" << ITERATIONS_NB << " iterations)" << std::endl;
+	benchmarkCorrelation(binaryImg);
+	benchmarkSlopeEstimation(binaryImg);
+	benchmarkSmallSlopeEstimation(binaryImg);
+	benchmarkSlopeScaling(binaryImg);
+	benchmarkCorrectSlope(binaryImg);
+	benchmarkPreprocessing(score);
+	benchmarkBitPlane(binaryImg);
+	benchmarkLineThickness(binaryImg);
+	benchmarkHighResolution(binaryImg);
+	benchmarkProfiles(binaryImg);
+	benchmarkRunStatistics(binaryImg);
+	benchmarkStavesProfile(binaryImg);
+	benchmarkPeaks(binaryImg);
+	std::cout << "getLocMaxima on fixed profiles : " << (checkFixedPeaks() ? "expected maxima" : "UNEXPECTED MAXIMA") << std::endl;
+	benchmarkStaveExtent(binaryImg);
+	benchmarkMiddleLine(binaryImg);
+	benchmarkErase(score);
+	benchmarkWorkspace(score);
+	benchmarkStreaming(score);
+	std::cout << "Staves::setup of a page lit by a gradient : " << (checkLighting() ? "same slope and staves as lit evenly" : "DIFFERENT SLOPE OR STAVES") << std::endl;
+}
+
+static double	getElapsedMs(long long start)
+{
+	return static_cast<double>(cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+static void		printComparison(std::string const& name, double referenceMs, double optimizedMs, bool isSameResult)
+{
+	std::cout << name << " : reference " << referenceMs << " ms, optimized " << optimizedMs << " ms";
+	if(optimizedMs > 0.0)
+	{
+		std::cout << " (x" << referenceMs / optimizedMs << ")";
+	}
+	std::cout << (isSameResult ? ", same result" : ", DIFFERENT RESULT") << std::endl;
+}
+
+static int		scalarCorrelation(cv::Mat const& binaryImg)
+{
+	std::vector<double>	vectCor;
+	double				maxCor = 0.0;
+	int					hMax = 0;
+	int					hRangeMax = 60;
+	int					indexRowShifted = 0;
+	int 				leftPixelValue = 1;
+	int 				rightPixelValue = 1;
+	int					halfImgWidth = std::round(binaryImg.cols / 2.0);
+
+	vectCor.assign(hRangeMax, 0);
+	for(int h = 0; h < hRangeMax; ++h)
+	{
+		for(int i = 0; i < binaryImg.rows; ++i)
+		{
+			for(int j = 0; j < binaryImg.cols / 2; ++j)
+			{
+				indexRowShifted = i - h + round(hRangeMax / 2.0);
+				if((indexRowShifted < 0) || (indexRowShifted >= binaryImg.rows))
+				{
+					continue;
+				}
+				leftPixelValue = 1;
+				rightPixelValue = 1;
+				if(binaryImg.at<unsigned char>(i, j) == 0)
+				{
+					leftPixelValue = -1;
+				}
+				if(binaryImg.at<unsigned char>(indexRowShifted, j + halfImgWidth) == 0)
+				{
+					rightPixelValue = -1;
+				}
+				vectCor.at(h) += (leftPixelValue * rightPixelValue);
+			}
+		}
+		vectCor.at(h) *= 2.0;
+	    vectCor.at(h) /= static_cast<double>(binaryImg.cols * binaryImg.rows);
+		if(vectCor.at(h) > maxCor)
+		{
+			maxCor = vectCor.at(h);
+			hMax = h - hRangeMax / 2;
+		}
+	}
+	return hMax;
+}
+
+static void		benchmarkCorrelation(cv::Mat const& binaryImg)
+{
+	int			referenceHMax = 0;
+	int			hMax = 0;
+	long long	start = 0;
+	double		referenceMs = 0.0;
+	double		optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		referenceHMax = scalarCorrelation(binaryImg);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		hMax = correlation(binaryImg);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("correlation (hMax = " + std::to_string(hMax) + ")", referenceMs, optimizedMs, referenceHMax == hMax);
+}
+
+static void		benchmarkSlopeEstimation(cv::Mat const& binaryImg)
+{
+	int				referenceHMax = 0;
+	SlopeEstimate	estimate = {0, 0.0, 0.0, 0.0};
+	long long		start = 0;
+	double			referenceMs = 0.0;
+	double			optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		referenceHMax = correlation(binaryImg);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		estimate = estimateSlope(binaryImg);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("estimateSlope (hMax = " + std::to_string(estimate.hMax) + ", sub pixel hMax = " + std::to_string(estimate.hMaxSub) + ")", referenceMs, optimizedMs, referenceHMax == estimate.hMax);
+}
+
+static SlopeEstimate	scalarSlopeEstimate(cv::Mat const& binaryImg, int range)
+{
+	SlopeEstimate		estimate = {0, 0.0, 0.0, 0.0};
+	std::vector<double>	agreements;
+	int					halfImgWidth = std::round(binaryImg.cols / 2.0);
+	int					shiftedRow = 0;
+	double				before = 0.0;
+	double				peak = 0.0;
+	double				after = 0.0;
+	double				denominator = 0.0;
+
+	// the shifts -range - 1 and range + 1 are the neighbours of a peak on the border
+	agreements.assign(2 * range + 3, 0.0);
+	for(int h = 0; h < 2 * range + 3; ++h)
+	{
+		for(int i = 0; i < binaryImg.rows; ++i)
+		{
+			shiftedRow = i - (h - range - 1);
+			if(shiftedRow < 0 || shiftedRow >= binaryImg.rows)
+			{
+				continue;
+			}
+			for(int j = 0; j < binaryImg.cols / 2; ++j)
+			{
+				agreements.at(h) += ((binaryImg.at<unsigned char>(i, j) == 0) == (binaryImg.at<unsigned char>(shiftedRow, j + halfImgWidth) == 0)) ? 1.0 : -1.0;
+			}
+		}
+	}
+	for(int h = 1; h <= 2 * range + 1; ++h)
+	{
+		if(h == 1 || agreements.at(h) > agreements.at(estimate.hMax + range + 1))
+		{
+			estimate.hMax = h - range - 1;
+		}
+	}
+	before = agreements.at(estimate.hMax + range);
+	peak = agreements.at(estimate.hMax + range + 1);
+	after = agreements.at(estimate.hMax + range + 2);
+	estimate.maxCor = 2.0 * peak / static_cast<double>(binaryImg.total());
+	estimate.hMaxSub = estimate.hMax;
+	denominator = before - 2.0 * peak + after;
+	if(denominator < 0.0)
+	{
+		estimate.hMaxSub += std::max(-0.5, std::min(0.5, 0.5 * (before - after) / denominator));
+	}
+	return estimate;
+}
+
+static void		benchmarkSmallSlopeEstimation(cv::Mat const& binaryImg)
+{
+	int				rows = std::min(binaryImg.rows, SMALL_SLOPE_ROWS);
+	cv::Mat			band = binaryImg.rowRange((binaryImg.rows - rows) / 2, (binaryImg.rows - rows) / 2 + rows);
+	SlopeEstimate	referenceEstimate = {0, 0.0, 0.0, 0.0};
+	SlopeEstimate	estimate = {0, 0.0, 0.0, 0.0};
+	long long		start = 0;
+	double			referenceMs = 0.0;
+	double			optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		// the range of estimateSlope (see SLOPE_RANGE_RATIO)
+		referenceEstimate = scalarSlopeEstimate(band, std::max(1, static_cast<int>(std::ceil(rows * 0.02))));
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		estimate = estimateSlope(band);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("estimateSlope of " + std::to_string(rows) + " rows (hMax = " + std::to_string(estimate.hMax) + ", sub pixel hMax = " + std::to_string(estimate.hMaxSub) + ")", referenceMs, optimizedMs, referenceEstimate.hMax == estimate.hMax && std::abs(referenceEstimate.hMaxSub - estimate.hMaxSub) < 1e-9 && std::abs(referenceEstimate.maxCor - estimate.maxCor) < 1e-9);
+}
+
+static void		benchmarkSlopeScaling(cv::Mat const& binaryImg)
+{
+	int				threadsNb = cv::getNumThreads();
+	int				maxThreadsNb = std::max(cv::getNumberOfCPUs(), threadsNb);
+	int				referenceHMax = 0;
+	int				hMax = 0;
+	SlopeEstimate	referenceEstimate = {0, 0.0, 0.0, 0.0};
+	SlopeEstimate	estimate = {0, 0.0, 0.0, 0.0};
+	long long		start = 0;
+	double			correlationReferenceMs = 0.0;
+	double			slopeReferenceMs = 0.0;
+	double			correlationMs = 0.0;
+	double			slopeMs = 0.0;
+
+	for(int t = 1; t <= maxThreadsNb; ++t)
+	{
+		cv::setNumThreads(t);
+		start = cv::getTickCount();
+		for(int i = 0; i < ITERATIONS_NB; ++i)
+		{
+			hMax = correlation(binaryImg);
+		}
+		correlationMs = getElapsedMs(start) / ITERATIONS_NB;
+		start = cv::getTickCount();
+		for(int i = 0; i < ITERATIONS_NB; ++i)
+		{
+			estimate = estimateSlope(binaryImg);
+		}
+		slopeMs = getElapsedMs(start) / ITERATIONS_NB;
+		if(t == 1)
+		{
+			referenceHMax = hMax;
+			referenceEstimate = estimate;
+			correlationReferenceMs = correlationMs;
+			slopeReferenceMs = slopeMs;
+		}
+		printComparison("correlation on " + std::to_string(t) + " threads / 1", correlationReferenceMs, correlationMs, referenceHMax == hMax);
+		printComparison("estimateSlope on " + std::to_string(t) + " threads / 1", slopeReferenceMs, slopeMs, referenceEstimate.hMax == estimate.hMax && referenceEstimate.hMaxSub == estimate.hMaxSub && referenceEstimate.maxCor == estimate.maxCor && referenceEstimate.confidence == estimate.confidence);
+	}
+	cv::setNumThreads(threadsNb);
+}
+
+void	benchmarkScaling(cv::Mat const& score)
+{
+	std::cout << "scaling on a page of " << score.cols << " x " << score.rows << " pixels (" << ITERATIONS_NB << " iterations, up to " << std::max(cv::getNumberOfCPUs(), cv::getNumThreads()) << " threads)" << std::endl;
+	benchmarkSlopeScaling(binarize(score, 220));
+	benchmarkSetupScaling(score);
+}
+
+static void		benchmarkSetupScaling(cv::Mat const& score)
+{
+	int			threadsNb = cv::getNumThreads();
+	int			maxThreadsNb = std::max(cv::getNumberOfCPUs(), threadsNb);
+	Staves		referenceStaves;
+	Staves		staves;
+	long long	start = 0;
+	double		referenceMs = 0.0;
+	double		setupMs = 0.0;
+
+	for(int t = 1; t <= maxThreadsNb; ++t)
+	{
+		cv::setNumThreads(t);
+		start = cv::getTickCount();
+		for(int i = 0; i < ITERATIONS_NB; ++i)
+		{
+			staves.setup(score);
+		}
+		setupMs = getElapsedMs(start) / ITERATIONS_NB;
+		if(t == 1)
+		{
+			referenceStaves = staves;
+			referenceMs = setupMs;
+		}
+		printComparison("Staves::setup on " + std::to_string(t) + " threads / 1", referenceMs, setupMs, referenceStaves.getSlopeModel().getPageEstimate().hMax == staves.getSlopeModel().getPageEstimate().hMax && referenceStaves.getInterline() == staves.getInterline() && isSameStaves(referenceStaves, staves));
+	}
+	cv::setNumThreads(threadsNb);
+}
+
+static bool		isSameImage(cv::Mat const& img1, cv::Mat const& img2)
+{
+	if(img1.size() != img2.size())
+	{
+		return false;
+	}
+	for(int i = 0; i < img1.rows; ++i)
+	{
+		for(int j = 0; j < img1.cols; ++j)
+		{
+			if(img1.at<unsigned char>(i, j) != img2.at<unsigned char>(i, j))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static cv::Mat	scalarCorrectSlope(cv::Mat const& binaryImg, int hMax)
+{
+	int		index = 0;
+	cv::Mat	correctedImg;
+
+	correctedImg = cv::Mat::zeros(binaryImg.rows, binaryImg.cols, CV_8UC1);
+	for(int i = 0; i < binaryImg.rows; ++i)
+	{
+		for(int j = 0; j < binaryImg.cols; ++j)
+		{
+			index = i - (2 * hMax * j / binaryImg.cols);
+			if(index >= 0 && index < binaryImg.rows)
+			{
+				correctedImg.at<unsigned char>(i, j) = binaryImg.at<unsigned char>(index, j);
+			}
+		}
+	}
+	return correctedImg;
+}
+
+static void		benchmarkCorrectSlope(cv::Mat const& binaryImg)
+{
+	int			hMax = estimateSlope(binaryImg).hMax;
+	cv::Mat		referenceImg;
+	cv::Mat		correctedImg;
+	cv::Mat		inPlaceImg;
+	long long	start = 0;
+	double		referenceMs = 0.0;
+	double		optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		referenceImg = scalarCorrectSlope(binaryImg, hMax);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		correctedImg = correctSlope(binaryImg, hMax);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("correctSlope", referenceMs, optimizedMs, isSameImage(referenceImg, correctedImg));
+	inPlaceImg = binaryImg.clone();
+	start = cv::getTickCount();
+	correctSlope(inPlaceImg, static_cast<double>(hMax), inPlaceImg);
+	optimizedMs = getElapsedMs(start);
+	printComparison("correctSlope in place", referenceMs, optimizedMs, isSameImage(referenceImg, inPlaceImg));
+}
+
+static void		benchmarkPreprocessing(cv::Mat const& score)
+{
+	SlopeModel			slopeModel;
+	cv::Mat				referenceImg;
+	cv::Mat				binaryImg;
+	std::vector<int>	referenceProfileVect;
+	std::vector<int>	profileVect;
+	long long			start = 0;
+	double				referenceMs = 0.0;
+	double				optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		referenceImg = binarize(score.clone(), 220);
+		referenceImg = correctSlope(referenceImg, estimateSlope(referenceImg).hMax);
+		referenceProfileVect = getHorizontalProfile(referenceImg);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		preprocessScore(score, 220, slopeModel, binaryImg, profileVect);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("preprocessScore", referenceMs, optimizedMs, isSameImage(referenceImg, binaryImg) && referenceProfileVect == profileVect);
+}
+
+static void		benchmarkBitPlane(cv::Mat const& binaryImg)
+{
+	BitPlane			binaryPlane = BitPlane::fromMat(binaryImg);
+	std::vector<int>	profileVect = getHorizontalProfile(binaryPlane);
+	std::vector<int>	referenceHistogram;
+	std::vector<int>	histogram;
+	std::vector<int>	middleLineAbscs;
+	int					interline = findInterline(profileVect);
+	long long			start = 0;
+	double				referenceMs = 0.0;
+	double				optimizedMs = 0.0;
+
+	middleLineAbscs = detectMiddleLineAbsc(profileVect, interline);
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		referenceHistogram = scalarLineThicknessHistogram(middleLineAbscs, 6 * interline, binaryImg);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		histogram = getLineThicknessHistogram(middleLineAbscs, 6 * interline, binaryPlane);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("getLineThicknessHistogram on a bit plane", referenceMs, optimizedMs, referenceHistogram == histogram);
+}
+
+static std::vector<int>	scalarLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, cv::Mat const& binaryImg)
+{
+	std::vector<int>	histogram(heightSize, 0);
+	int					halfHeightSize = std::round(heightSize / 2.0);
+	int					thickness = 0;
+
+	for(int j = 0; j < binaryImg.cols; ++j)
+	{
+		for(auto line = middleLineAbscs.begin(); line != middleLineAbscs.end(); ++line)
+		{
+			for(int i = std::max(0, *line - halfHeightSize); i < std::min(binaryImg.rows, *line + halfHeightSize); ++i)
+			{
+				if(binaryImg.at<unsigned char>(i, j) == 0)
+				{
+					thickness = 1;
+					while(++i < std::min(binaryImg.rows, *line + halfHeightSize) && binaryImg.at<unsigned char>(i, j) == 0)
+					{
+						++thickness;
+					}
+					if(thickness < heightSize)
+					{
+						++histogram.at(thickness);
+					}
+				}
+			}
+		}
+	}
+	return histogram;
+}
+
+static void		benchmarkLineThickness(cv::Mat const& binaryImg)
+{
+	std::vector<int>	profileVect = getHorizontalProfile(binaryImg);
+	std::vector<int>	referenceHistogram;
+	std::vector<int>	histogram;
+	std::vector<int>	middleLineAbscs;
+	int					interline = findInterline(profileVect);
+	long long			start = 0;
+	double				referenceMs = 0.0;
+	double				optimizedMs = 0.0;
+
+	middleLineAbscs = detectMiddleLineAbsc(profileVect, interline);
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		referenceHistogram = scalarLineThicknessHistogram(middleLineAbscs, 6 * interline, binaryImg);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		histogram = getLineThicknessHistogram(middleLineAbscs, 6 * interline, binaryImg);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("getLineThicknessHistogram on the 8 bits page", referenceMs, optimizedMs, referenceHistogram == histogram);
+}
+
+static void		benchmarkHighResolution(cv::Mat const& binaryImg)
+{
+	cv::Mat	highResolutionImg;
+
+	cv::resize(binaryImg, highResolutionImg, cv::Size(HIGH_RESOLUTION_COLS, static_cast<int>(std::round(binaryImg.rows * static_cast<double>(HIGH_RESOLUTION_COLS) / binaryImg.cols))), 0, 0, cv::INTER_NEAREST);
+	std::cout << "page scaled to " << highResolutionImg.cols << " x " << highResolutionImg.rows << " pixels (600 dpi) :" << std::endl;
+	benchmarkBitPlane(highResolutionImg);
+	benchmarkLineThickness(highResolutionImg);
+}
+
+static std::vector<int>	scalarRowProfile(cv::Mat const& binaryImg)
+{
+	std::vector<int> profileVect;
+
+	profileVect.assign(binaryImg.rows, 0);
+	for(int i = 0; i < binaryImg.rows; ++i)
+	{
+		for(int j = 0; j < binaryImg.cols; ++j)
+		{
+			auto pixColor = binaryImg.at<unsigned char>(i, j);
+			profileVect.at(i) += ((pixColor / 255) + 1) % 2;
+		}
+	}
+	cv::Mat profile(binaryImg.rows, binaryImg.cols, CV_8UC1, cv::Scalar(255));
+	for(int i = 0; i < binaryImg.rows; ++i)
+	{
+		for(int j = 0; j < binaryImg.cols; ++j)
+		{
+			if(profileVect.at(i) >= j)
+			{
+				profile.at<unsigned char>(i, j) = 0;
+			}
+		}
+	}
+	return profileVect;
+}
+
+static std::vector<int>	scalarColProfile(cv::Mat const& binaryImg)
+{
+	std::vector<int>	profileVect;
+
+	profileVect.assign(binaryImg.cols, 0);
+	for(int j = 0; j < binaryImg.cols; ++j)
+	{
+		for(int i = 0; i < binaryImg.rows; ++i)
+		{
+			if(binaryImg.at<unsigned char>(i, j) == 0)
+			{
+				++profileVect.at(j);
+			}
+		}
+	}
+	return profileVect;
+}
+
+static void		benchmarkProfiles(cv::Mat const& binaryImg)
+{
+	BitPlane			binaryPlane = BitPlane::fromMat(binaryImg);
+	std::vector<int>	referenceProfileVect;
+	std::vector<int>	profileVect;
+	std::vector<int>	planeProfileVect;
+	long long			start = 0;
+	double				referenceMs = 0.0;
+	double				optimizedMs = 0.0;
+	double				planeMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		referenceProfileVect = scalarRowProfile(binaryImg);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		getRowProfile(binaryImg, profileVect);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		getRowProfile(binaryPlane, planeProfileVect);
+	}
+	planeMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("getRowProfile", referenceMs, optimizedMs, referenceProfileVect == profileVect);
+	printComparison("getRowProfile on a bit plane", referenceMs, planeMs, referenceProfileVect == planeProfileVect);
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		referenceProfileVect = scalarColProfile(binaryImg);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		getColProfile(binaryImg, profileVect);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		getColProfile(binaryPlane, planeProfileVect);
+	}
+	planeMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("getColProfile", referenceMs, optimizedMs, referenceProfileVect == profileVect);
+	printComparison("getColProfile on a bit plane", referenceMs, planeMs, referenceProfileVect == planeProfileVect);
+}
+
+static void		benchmarkRunStatistics(cv::Mat const& binaryImg)
+{
+	BitPlane			binaryPlane = correctSlope(BitPlane::fromMat(binaryImg), estimateSlope(binaryImg).hMax);
+	RunStatistics		statistics;
+	std::vector<int>	histogram;
+	int					interline = 0;
+	long long			start = 0;
+	double				referenceMs = 0.0;
+	double				optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		std::vector<int>	profileVect = getHorizontalProfile(binaryPlane);
+
+		interline = findInterline(profileVect);
+		histogram = getLineThicknessHistogram(detectMiddleLineAbsc(profileVect, interline), 6 * interline, binaryPlane);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		statistics = getRunStatistics(binaryPlane);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("getRunStatistics (interline = " + std::to_string(statistics.interline) + " / " + std::to_string(interline) + ", thickness0 = " + std::to_string(statistics.thickness0) + " / " + std::to_string(getMaxIndex(histogram)) + ")", referenceMs, optimizedMs, interline == statistics.interline && getMaxIndex(histogram) == statistics.thickness0);
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		statistics = getRunStatistics(binaryPlane, 4);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("getRunStatistics on 1 column out of 4", referenceMs, optimizedMs, interline == statistics.interline && getMaxIndex(histogram) == statistics.thickness0);
+}
+
+static std::vector<int>	scalarStavesProfile(std::vector<int> const& profileVect, int interline)
+{
+	std::vector<int>	stavesProfileVect(profileVect.size(), 0);
+	int					profileVectSize = static_cast<int>(profileVect.size());
+	int					indexLineRow = 0;
+
+	for(int x = 0; x < profileVectSize; ++x)
+	{
+		for(int i = -2; i <= 2; ++i)
+		{
+			for(int j = -1; j <= 1; ++j)
+			{
+				indexLineRow = x + i * interline + j;
+				if(indexLineRow < profileVectSize && indexLineRow >= 0)
+				{
+					stavesProfileVect.at(x) += profileVect.at(indexLineRow);
+				}
+			}
+		}
+	}
+	return stavesProfileVect;
+}
+
+static void		benchmarkStavesProfile(cv::Mat const& binaryImg)
+{
+	std::vector<int>	profileVect = getHorizontalProfile(binaryImg);
+	int					interline = findInterline(profileVect);
+	std::vector<int>	reference;
+	std::vector<int>	optimized;
+	long long			start = 0;
+	double				referenceMs = 0.0;
+	double				optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		reference = scalarStavesProfile(profileVect, interline);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		optimized = getStavesProfileVect(profileVect, interline);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("getStavesProfileVect", referenceMs, optimizedMs, reference == optimized);
+}
+
+static std::vector<int>	scalarLocMaxima(std::vector<int> const& data, int range)
+{
+	std::vector<int>	locMaxima;
+	int					sizeData = static_cast<int>(data.size());
+	int					initMax = std::round(getMax(data) / 3.0);
+	int					max = initMax;
+	int					indexMax = 0;
+
+	for(int i = range; i < sizeData - range; ++i)
+	{
+		if(data.at(i) > max)
+		{
+			max = data.at(i);
+			indexMax = i;
+			for(int r = i - range; r < i + range; ++r)
+			{
+				if(data.at(r) > max)
+				{
+					indexMax = -1;
+					break;
+				}
+			}
+			if(indexMax == i)
+			{
+				locMaxima.push_back(i);
+				i = i + range;
+				max = initMax;
+			}
+		}
+	}
+	return locMaxima;
+}
+
+static void		benchmarkPeaks(cv::Mat const& binaryImg)
+{
+	BitPlane			binaryPlane = correctSlope(BitPlane::fromMat(binaryImg), estimateSlope(binaryImg).hMax);
+	std::vector<int>	profileVect = getHorizontalProfile(binaryPlane);
+	int					interline = getRunStatistics(binaryPlane).interline;
+	std::vector<int>	reference;
+	std::vector<int>	optimized;
+	long long			start = 0;
+	double				referenceMs = 0.0;
+	double				optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		reference = scalarLocMaxima(getStavesProfileVect(profileVect, interline), 2 * interline);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int i = 0; i < ITERATIONS_NB; ++i)
+	{
+		optimized = detectMiddleLineAbsc(profileVect, interline);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("detectMiddleLineAbsc (" + std::to_string(optimized.size()) + " staves / " + std::to_string(reference.size()) + ")", referenceMs, optimizedMs, reference == optimized);
+}
+
+static int		scalarMaxDeltaOrdProfile(int interline, int subImgCenter, cv::Mat const& subImg, int thickness0, int col)
+{
+	int		profileDeltaXP = 0;
+	int		maxProfile = 0;
+	int 	deltaXRange = std::floor(static_cast<double>(thickness0) / 2.0) + 1;
+	int		deltaXPRange = std::round(interline / 2.0);
+	int		index = 0;
+
+	for(int deltaXP = -deltaXPRange; deltaXP <= deltaXPRange; ++deltaXP)
+	{
+		profileDeltaXP = 0;
+		for(int k = -2; k <= 2; ++k)
+		{
+			for(int deltaX = -deltaXRange; deltaX <= deltaXRange; ++deltaX)
+			{
+				index = subImgCenter + k * interline + deltaX + deltaXP;
+				if(index >= 0 && index < subImg.rows && subImg.at<unsigned char>(index, col) == 0)
+				{
+					profileDeltaXP += 1;
+				}
+			}
+		}
+		maxProfile = std::max(maxProfile, profileDeltaXP);
+	}
+	return maxProfile;
+}
+
+static int		scalarLeftOrd(std::vector<int> const& profile, int thresh, int interline)
+{
+	int	width = static_cast<int>(profile.size());
+
+	for(int y = 1; y < width; ++y)
+	{
+		if(profile.at(y) > thresh)
+		{
+			for(int yAfter = y + 1; yAfter < y + interline * 2 && yAfter < width; ++yAfter)
+			{
+				if(profile.at(yAfter) < thresh)
+				{
+					break;
+				}
+				else if(yAfter == y + interline * 2 - 1)
+				{
+					return y;
+				}
+			}
+		}
+	}
+	return -1;
+}
+
+static int		scalarRightOrd(std::vector<int> const& profile, int thresh, int interline)
+{
+	int	width = static_cast<int>(profile.size());
+	int	rightOrd = -1;
+
+	for(int y = interline + 1; y < width; ++y)
+	{
+		if(profile.at(y) > thresh)
+		{
+			for(int yBefore = y - interline; yBefore < y; ++yBefore)
+			{
+				if(profile.at(yBefore) < thresh)
+				{
+					break;
+				}
+				else if(yBefore == y - 1)
+				{
+					rightOrd = y;
+				}
+			}
+		}
+	}
+	return rightOrd;
+}
+
+static void		benchmarkStaveExtent(cv::Mat const& binaryImg)
+{
+	BitPlane				binaryPlane = correctSlope(BitPlane::fromMat(binaryImg), estimateSlope(binaryImg).hMax);
+	cv::Mat					correctedImg = binaryPlane.toMat();
+	RunStatistics			statistics = getRunStatistics(binaryPlane);
+	SlopeModel				slopeModel;
+	std::vector<int>		profileVect = getHorizontalProfile(binaryPlane);
+	std::vector<int>		subImgOrigins;
+	std::vector<int>		subImgCenters;
+	std::vector<cv::Mat>	subImages;
+	std::vector<int>		reference;
+	std::vector<int>		optimized;
+	std::vector<int>		leftOrds;
+	std::vector<int>		rightOrds;
+	std::vector<int>		optimizedLeftOrds;
+	std::vector<int>		optimizedRightOrds;
+	int						originThresh = std::round(2.5 * statistics.thicknessAvg);
+	int						thresh = 0;
+	bool					isSameResult = true;
+	long long				start = 0;
+	double					referenceMs = 0.0;
+	double					optimizedMs = 0.0;
+
+	slopeModel.setupPage(correctedImg);
+	subImages = extractSubImages(correctedImg, detectMiddleLineAbsc(profileVect, statistics.interline), statistics.interline, slopeModel, subImgOrigins);
+	for(std::size_t i = 0; i < subImages.size(); ++i)
+	{
+		getRowProfile(subImages.at(i), profileVect);
+		subImgCenters.push_back(detectMiddleLineAbscInSub(profileVect, statistics.interline));
+	}
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		for(std::size_t i = 0; i < subImages.size(); ++i)
+		{
+			reference.resize(subImages.at(i).cols);
+			for(int col = 0; col < subImages.at(i).cols; ++col)
+			{
+				reference.at(col) = scalarMaxDeltaOrdProfile(statistics.interline, subImgCenters.at(i), subImages.at(i), statistics.thickness0, col);
+			}
+		}
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		for(std::size_t i = 0; i < subImages.size(); ++i)
+		{
+			optimized = getStaveExtentProfile(subImages.at(i), subImgCenters.at(i), statistics.interline, statistics.thickness0);
+		}
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	for(std::size_t i = 0; i < subImages.size(); ++i)
+	{
+		reference.resize(subImages.at(i).cols);
+		for(int col = 0; col < subImages.at(i).cols; ++col)
+		{
+			reference.at(col) = scalarMaxDeltaOrdProfile(statistics.interline, subImgCenters.at(i), subImages.at(i), statistics.thickness0, col);
+		}
+		isSameResult = isSameResult && reference == getStaveExtentProfile(subImages.at(i), subImgCenters.at(i), statistics.interline, statistics.thickness0);
+	}
+	printComparison("getStaveExtentProfile (" + std::to_string(subImages.size()) + " staves)", referenceMs, optimizedMs, isSameResult);
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		leftOrds.assign(subImages.size(), -1);
+		rightOrds.assign(subImages.size(), -1);
+		for(std::size_t i = 0; i < subImages.size(); ++i)
+		{
+			optimized = getStaveExtentProfile(subImages.at(i), subImgCenters.at(i), statistics.interline, statistics.thickness0);
+			for(thresh = originThresh; leftOrds.at(i) == -1 && thresh >= 0; --thresh)
+			{
+				leftOrds.at(i) = scalarLeftOrd(optimized, thresh, statistics.interline);
+			}
+			for(thresh = originThresh; rightOrds.at(i) == -1 && thresh >= 0; --thresh)
+			{
+				rightOrds.at(i) = scalarRightOrd(optimized, thresh, statistics.interline);
+			}
+		}
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		optimizedLeftOrds.assign(subImages.size(), -1);
+		optimizedRightOrds.assign(subImages.size(), -1);
+		for(std::size_t i = 0; i < subImages.size(); ++i)
+		{
+			getStaveOrds(subImages.at(i), statistics.thicknessAvg, statistics.thickness0, statistics.interline, subImgCenters.at(i), optimizedLeftOrds.at(i), optimizedRightOrds.at(i));
+		}
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	printComparison("getStaveOrds", referenceMs, optimizedMs, optimizedLeftOrds == leftOrds && optimizedRightOrds == rightOrds);
+}
+
+static std::vector<int>	scalarMiddleLineAbsc(int middleLineAbsc, int interline, int thickness0, cv::Mat const& subImgI, int leftOrd, int rightOrd)
+{
+	std::vector<int>	improvedCenterLineAbsc;
+	std::vector<int>	mask;
+	cv::Mat				maskImgCorrelation;
+	double				staveHeight = 2.0 * floor(2.5 * interline);
+	int					halfStaveHeight = std::round(staveHeight / 2.0);
+	int					xShiftedRange = floor(interline / 2.0);
+	int					deltaB = floor(thickness0 / 2.0);
+	int					row = 0;
+	int					whitePix = 0;
+	int					shift = 0;
+	int					startY = leftOrd - 1;
+	double				maxCor = -1.0;
+	double				alpha = 0.98;
+	double				pixValue = 0.0;
+
+	if(leftOrd < 0 || rightOrd < 0 || subImgI.empty() || middleLineAbsc <= 0 || interline <= 0 || thickness0 <= 0)
+	{
+		return improvedCenterLineAbsc;
+	}
+	improvedCenterLineAbsc.assign(rightOrd - leftOrd + 1, middleLineAbsc);
+	mask.assign(2 * halfStaveHeight, -1);
+	for(int k = -2; k < 3; ++k)
+	{
+		for(int i = -deltaB; i < thickness0 - deltaB; ++i)
+		{
+			if(halfStaveHeight + k * interline + i >= 0 && halfStaveHeight + k * interline + i < 2 * halfStaveHeight)
+			{
+				mask.at(halfStaveHeight + k * interline + i) = 1;
+			}
+		}
+	}
+	do
+	{
+		++startY;
+		whitePix = 0;
+		for(int h = -halfStaveHeight; h < halfStaveHeight; ++h)
+		{
+			row = h + middleLineAbsc;
+			whitePix += (row < 0 || row >= subImgI.rows || subImgI.at<unsigned char>(row, startY) == 255);
+		}
+	}
+	while(2 * whitePix <= 2 * halfStaveHeight && startY <= std::round(subImgI.cols / 3.0));
+	maskImgCorrelation = cv::Mat::zeros(2 * xShiftedRange + 1, rightOrd + 1, CV_64F);
+	for(int y = startY; y <= rightOrd; ++y)
+	{
+		for(int xShifted = -xShiftedRange; xShifted <= xShiftedRange; ++xShifted)
+		{
+			for(int h = -halfStaveHeight; h < halfStaveHeight; ++h)
+			{
+				row = h + middleLineAbsc + xShifted;
+				pixValue = (row >= 0 && row < subImgI.rows && subImgI.at<unsigned char>(row, y) == 0) ? 1.0 : -1.0;
+				maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) += mask.at(h + halfStaveHeight) * pixValue;
+			}
+			maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) /= staveHeight;
+			if(y == startY && maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) > maxCor)
+			{
+				maxCor = maskImgCorrelation.at<double>(xShifted + xShiftedRange, y);
+				shift = xShifted;
+				for(int yShift = leftOrd; yShift < startY; ++yShift)
+				{
+					maskImgCorrelation.at<double>(xShifted + xShiftedRange, yShift) = maxCor;
+				}
+			}
+		}
+	}
+	improvedCenterLineAbsc.at(0) += shift;
+	for(int y = leftOrd + 1; y <= rightOrd; ++y)
+	{
+		maxCor = 0.0;
+		for(int xShifted = -xShiftedRange; xShifted <= xShiftedRange; ++xShifted)
+		{
+			maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) *= (1.0 - alpha);
+			maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) += (maskImgCorrelation.at<double>(xShifted + xShiftedRange, y - 1) * alpha);
+			if(maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) > maxCor)
+			{
+				maxCor = maskImgCorrelation.at<double>(xShifted + xShiftedRange, y);
+				shift = xShifted;
+			}
+		}
+		improvedCenterLineAbsc.at(y - leftOrd) += shift;
+	}
+	return improvedCenterLineAbsc;
+}
+
+static void		benchmarkMiddleLine(cv::Mat const& binaryImg)
+{
+	BitPlane				binaryPlane = correctSlope(BitPlane::fromMat(binaryImg), estimateSlope(binaryImg).hMax);
+	cv::Mat					correctedImg = binaryPlane.toMat();
+	RunStatistics			statistics = getRunStatistics(binaryPlane);
+	SlopeModel				slopeModel;
+	std::vector<int>		profileVect = getHorizontalProfile(binaryPlane);
+	std::vector<int>		subImgOrigins;
+	std::vector<int>		subImgCenters;
+	std::vector<cv::Mat>	subImages;
+	std::vector<int>		reference;
+	std::vector<int>		optimized;
+	std::vector<int>		leftOrds;
+	std::vector<int>		rightOrds;
+	bool					isSameResult = true;
+	long long				start = 0;
+	double					referenceMs = 0.0;
+	double					optimizedMs = 0.0;
+
+	slopeModel.setupPage(correctedImg);
+	subImages = extractSubImages(correctedImg, detectMiddleLineAbsc(profileVect, statistics.interline), statistics.interline, slopeModel, subImgOrigins);
+	for(std::size_t i = 0; i < subImages.size(); ++i)
+	{
+		getRowProfile(subImages.at(i), profileVect);
+		subImgCenters.push_back(detectMiddleLineAbscInSub(profileVect, statistics.interline));
+	}
+	leftOrds.assign(subImages.size(), -1);
+	rightOrds.assign(subImages.size(), -1);
+	for(std::size_t i = 0; i < subImages.size(); ++i)
+	{
+		getStaveOrds(subImages.at(i), statistics.thicknessAvg, statistics.thickness0, statistics.interline, subImgCenters.at(i), leftOrds.at(i), rightOrds.at(i));
+	}
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		for(std::size_t i = 0; i < subImages.size(); ++i)
+		{
+			reference = scalarMiddleLineAbsc(subImgCenters.at(i), statistics.interline, statistics.thickness0, subImages.at(i), leftOrds.at(i), rightOrds.at(i));
+		}
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		for(std::size_t i = 0; i < subImages.size(); ++i)
+		{
+			optimized = getMiddleLineAbsc(subImgCenters.at(i), statistics.interline, statistics.thickness0, subImages.at(i), leftOrds.at(i), rightOrds.at(i));
+		}
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	for(std::size_t i = 0; i < subImages.size(); ++i)
+	{
+		reference = scalarMiddleLineAbsc(subImgCenters.at(i), statistics.interline, statistics.thickness0, subImages.at(i), leftOrds.at(i), rightOrds.at(i));
+		isSameResult = isSameResult && reference == getMiddleLineAbsc(subImgCenters.at(i), statistics.interline, statistics.thickness0, subImages.at(i), leftOrds.at(i), rightOrds.at(i));
+	}
+	printComparison("getMiddleLineAbsc (" + std::to_string(subImages.size()) + " staves)", referenceMs, optimizedMs, isSameResult);
+}
+
+static void		scalarEraseStave(cv::Mat& staveImg, Stave const& stave, int thicknessThresh)
+{
+	int		left = stave.getLeftOrd();
+	int		x = 0;
+	int		xUp = 0;
+	int		xDown = 0;
+
+	for(auto const& staveLine : stave.getStaveLines())
+	{
+		for(int y = left; y <= stave.getRightOrd(); ++y)
+		{
+			x = staveLine.getAbsCoords().at(y - left);
+			xUp = x;
+			xDown = x;
+			while(xUp >= 0 && ((xUp < staveImg.rows && staveImg.at<unsigned char>(xUp, y) == 0) || (xUp - 1 >= 0 && xUp - 1 < staveImg.rows && staveImg.at<unsigned char>(xUp - 1, y) == 0)))
+			{
+				--xUp;
+			}
+			while(xDown < staveImg.rows && ((xDown >= 0 && staveImg.at<unsigned char>(xDown, y) == 0) || (xDown + 1 >= 0 && xDown + 1 < staveImg.rows && staveImg.at<unsigned char>(xDown + 1, y) == 0)))
+			{
+				++xDown;
+			}
+			if(xDown - xUp <= thicknessThresh && xUp > x - thicknessThresh && xDown < x + thicknessThresh)
+			{
+				for(int xErased = std::max(0, xUp); xErased <= std::min(staveImg.rows - 1, xDown); ++xErased)
+				{
+					staveImg.at<unsigned char>(xErased, y) = 255;
+				}
+			}
+		}
+	}
+}
+
+static void		benchmarkErase(cv::Mat const& score)
+{
+	Staves					staves;
+	Staves					erasedStaves;
+	std::vector<cv::Mat>	referenceImgs;
+	int						thicknessThresh = 0;
+	bool					isSameResult = true;
+	long long				start = 0;
+	double					referenceMs = 0.0;
+	double					optimizedMs = 0.0;
+
+	staves.setup(score);
+	thicknessThresh = round(staves.getThicknessMoy()) + 2;
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		referenceImgs.clear();
+		for(auto const& stave : staves.getStaves())
+		{
+			referenceImgs.push_back(stave.getStaveImg().clone());
+			scalarEraseStave(referenceImgs.back(), stave, thicknessThresh);
+		}
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		// the images of the copy are shared with the ones of staves until they are erased
+		erasedStaves = staves;
+		erasedStaves.erase();
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	for(std::size_t i = 0; i < referenceImgs.size(); ++i)
+	{
+		isSameResult = isSameResult && isSameImage(referenceImgs.at(i), erasedStaves.getStaves().at(i).getStaveImg());
+	}
+	printComparison("Staves::erase (" + std::to_string(referenceImgs.size()) + " staves)", referenceMs, optimizedMs, isSameResult);
+}
+
+static void		benchmarkWorkspace(cv::Mat const& score)
+{
+	Staves			referenceStaves;
+	Staves			staves;
+	PageWorkspace	workspace;
+	std::size_t		createdMatsNb = 0;
+	std::size_t		reusedMatsNb = 0;
+	std::size_t		heapAllocationsNb = 0;
+	int				threadsNb = cv::getNumThreads();
+	bool			isSameResult = true;
+	long long		start = 0;
+	double			referenceMs = 0.0;
+	double			optimizedMs = 0.0;
+
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		referenceStaves = Staves();
+		referenceStaves.setup(score);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	// the first pages make the workspace grow to the size of the page : the staves of a page share its pixels until the next one is set up, so the pool holds the pixels of 2 pages
+	staves.setup(score, workspace);
+	staves.setup(score, workspace);
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		staves.setup(score, workspace);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	createdMatsNb = workspace.getCreatedMatsNb();
+	reusedMatsNb = workspace.getReusedMatsNb();
+	cv::setNumThreads(1);
+	heapAllocationsNb = getHeapAllocationsNb();
+	staves.setup(score, workspace);
+	heapAllocationsNb = getHeapAllocationsNb() - heapAllocationsNb;
+	cv::setNumThreads(threadsNb);
+	isSameResult = isSameStaves(referenceStaves, staves);
+	printComparison("Staves::setup on a workspace", referenceMs, optimizedMs, isSameResult);
+	std::cout << "Staves::setup on a warm workspace : ";
+	if(isCountingHeapAllocations())
+	{
+		std::cout << heapAllocationsNb << " heap allocations, ";
+	}
+	else
+	{
+		std::cout << "heap allocations not counted (build with 'make re ALLOCATIONS=count'), ";
+	}
+	std::cout << workspace.getCreatedMatsNb() - createdMatsNb << " pixel buffers allocated, " << workspace.getReusedMatsNb() - reusedMatsNb << " reused" << std::endl;
+}
+
+static bool		isSameStaves(Staves const& referenceStaves, Staves const& staves)
+{
+	bool	isSameResult = (referenceStaves.getStavesNb() == staves.getStavesNb());
+
+	for(unsigned int i = 0; isSameResult && i < staves.getStavesNb(); ++i)
+	{
+		Stave const&	referenceStave = referenceStaves.getStaves().at(i);
+		Stave const&	stave = staves.getStaves().at(i);
+
+		isSameResult = referenceStave.getLeftOrd() == stave.getLeftOrd() && referenceStave.getRightOrd() == stave.getRightOrd() && isSameImage(referenceStave.getStaveImg(), stave.getStaveImg());
+		for(unsigned int j = 0; isSameResult && j < referenceStave.getStaveLines().size(); ++j)
+		{
+			isSameResult = (referenceStave.getStaveLines().at(j).getAbsCoords() == stave.getStaveLines().at(j).getAbsCoords());
+		}
+	}
+	return isSameResult;
+}
+
+static void		benchmarkStreaming(cv::Mat const& score)
+{
+	Staves			referenceStaves;
+	Staves			staves;
+	PageWorkspace	referenceWorkspace;
+	PageWorkspace	workspace;
+	MatStripSource	source(score);
+	bool			isSameResult = true;
+	long long		start = 0;
+	double			referenceMs = 0.0;
+	double			optimizedMs = 0.0;
+
+	referenceStaves.setup(score, referenceWorkspace);
+	staves.setup(source, workspace, STREAM_STRIP_ROWS, true);
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		referenceStaves.setup(score, referenceWorkspace);
+	}
+	referenceMs = getElapsedMs(start) / ITERATIONS_NB;
+	start = cv::getTickCount();
+	for(int n = 0; n < ITERATIONS_NB; ++n)
+	{
+		staves.setup(source, workspace, STREAM_STRIP_ROWS, true);
+	}
+	optimizedMs = getElapsedMs(start) / ITERATIONS_NB;
+	isSameResult = referenceStaves.getSlopeModel().getPageEstimate().hMax == staves.getSlopeModel().getPageEstimate().hMax && referenceStaves.getInterline() == staves.getInterline() && isSameStaves(referenceStaves, staves);
+	printComparison("Staves::setup by strips of " + std::to_string(STREAM_STRIP_ROWS) + " rows", referenceMs, optimizedMs, isSameResult);
+}
+
+static cv::Mat	getSyntheticScore(bool isLitByGradient)
+{
+	int			rows = LIGHTING_STAVES_NB * LIGHTING_STAVE_SPACING + LIGHTING_STAVE_SPACING;
+	int			cols = 1000;
+	int			margin = cols / 20;
+	int			row = 0;
+	double		light = 1.0;
+	cv::Mat		page(rows, cols, CV_8UC1, cv::Scalar(255));
+
+	for(int s = 0; s < LIGHTING_STAVES_NB; ++s)
+	{
+		for(int l = 0; l < 5; ++l)
+		{
+			row = LIGHTING_STAVE_SPACING * (s + 1) - 2 * LIGHTING_INTERLINE + l * LIGHTING_INTERLINE;
+			cv::line(page, cv::Point(margin, row), cv::Point(cols - 1 - margin, row + LIGHTING_DROP), cv::Scalar(0), LIGHTING_THICKNESS);
+		}
+	}
+	for(int i = 0; isLitByGradient && i < rows; ++i)
+	{
+		for(int j = 0; j < cols; ++j)
+		{
+			light = 1.0 - 0.3 * (static_cast<double>(i) / rows + static_cast<double>(j) / cols);
+			page.at<unsigned char>(i, j) = cv::saturate_cast<unsigned char>(page.at<unsigned char>(i, j) * light);
+		}
+	}
+	return page;
+}
+
+static bool		checkLighting()
+{
+	Staves		referenceStaves;
+	Staves		staves;
+	cv::Mat		evenPage = getSyntheticScore(false);
+	cv::Mat		litPage = getSyntheticScore(true);
+	int			referenceHMax = 0;
+	bool		isExpected = true;
+
+	referenceStaves.setup(evenPage);
+	referenceHMax = referenceStaves.getSlopeModel().getPageEstimate().hMax;
+	std::cout << "page lit evenly : " << referenceStaves.getStavesNb() << " staves / " << LIGHTING_STAVES_NB << ", hMax " << referenceHMax << std::endl;
+	for(BinarizationMode mode : {BinarizationMode::FIXED, BinarizationMode::SAUVOLA, BinarizationMode::NIBLACK})
+	{
+		std::string	name = (mode == BinarizationMode::FIXED ? "fixed threshold" : (mode == BinarizationMode::SAUVOLA ? "sauvola" : "niblack"));
+
+		// the fixed threshold may find no stave at all on this page
+		try
+		{
+			staves.setup(litPage, mode);
+			std::cout << "page lit by a gradient, " << name << " : " << staves.getStavesNb() << " staves, hMax " << staves.getSlopeModel().getPageEstimate().hMax << std::endl;
+			if(mode != BinarizationMode::FIXED)
+			{
+				isExpected = isExpected && staves.getStavesNb() == referenceStaves.getStavesNb() && std::abs(staves.getSlopeModel().getPageEstimate().hMax - referenceHMax) <= 1;
+			}
+		}
+		catch(std::exception const& e)
+		{
+			std::cout << "page lit by a gradient, " << name << " : " << e.what() << std::endl;
+			isExpected = isExpected && mode == BinarizationMode::FIXED;
+		}
+	}
+	return isExpected && referenceStaves.getStavesNb() == LIGHTING_STAVES_NB;
+}
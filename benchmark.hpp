@@ -0,0 +1,25 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/core/core.hpp>
+
+/*!
+	\brief
+	Time the optimized stages of the detection against the straightforward implementation they replaced, on a real page of score, and check that both give the same results
+
+	Called by the argument "benchmark" when executing the program
+	\param score image of one page of score in gray scale
+*/
+void	benchmark(cv::Mat const& score);
+
+/*!
+	\brief
+	Time the parallel stages of the detection on 1 thread, then on 2 and up to the number of cores, and check that the results do not depend on the number of threads : the search of the slope and the whole setup of the staves of the page
+
+	Called by the argument "scaling" when executing the program
+	\param score image of one page of score in gray scale
+*/
+void	benchmarkScaling(cv::Mat const& score);
+
+#endif
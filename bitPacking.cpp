@@ -0,0 +1,110 @@
+#include "bitPacking.hpp"
+#include <algorithm>
+#include <cstring>
+
+/*!
+	\brief
+	Mask of the black pixels among 8 consecutive pixels : bit k is set if pixels[k] <= thresh
+
+	\param pixels first of the 8 pixels
+	\param thresh see packRows
+*/
+static unsigned int	getBlackMask8(unsigned char const* pixels, unsigned char thresh);
+
+int		getPackedWordsNb(int width)
+{
+	return (width + 63) / 64;
+}
+
+std::vector<std::uint64_t>	packRows(cv::Mat const& img, int colStart, int width, unsigned char thresh)
+{
+	std::vector<std::uint64_t>	words;
+
+	packRows(img, colStart, width, thresh, words);
+	return words;
+}
+
+void	packRows(cv::Mat const& img, int colStart, int width, unsigned char thresh, std::vector<std::uint64_t>& words)
+{
+	int						wordsNb = getPackedWordsNb(width);
+	int						bitsNb = 0;
+	int						b = 0;
+	unsigned char const*	row = nullptr;
+	std::uint64_t*			packedRow = nullptr;
+	std::uint64_t			word = 0;
+
+	words.assign(static_cast<std::size_t>(img.rows) * wordsNb, 0);
+	for(int i = 0; i < img.rows; ++i)
+	{
+		row = img.ptr<unsigned char>(i) + colStart;
+		packedRow = words.data() + static_cast<std::size_t>(i) * wordsNb;
+		for(int w = 0; w < wordsNb; ++w)
+		{
+			// the bit of a black pixel is set, 8 pixels at a time while the word is complete
+			word = 0;
+			bitsNb = std::min(64, width - 64 * w);
+			b = 0;
+			for(; b + 8 <= bitsNb; b += 8)
+			{
+				word |= static_cast<std::uint64_t>(getBlackMask8(row + b, thresh)) << b;
+			}
+			for(; b < bitsNb; ++b)
+			{
+				word |= static_cast<std::uint64_t>(row[b] <= thresh) << b;
+			}
+			packedRow[w] = word;
+			row += 64;
+		}
+	}
+}
+
+std::uint64_t	getPackedBits(std::uint64_t const* packedRow, int wordsNb, int bitStart)
+{
+	int				w = bitStart / 64;
+	int				shift = bitStart % 64;
+	std::uint64_t	bits = 0;
+
+	if(w < wordsNb)
+	{
+		bits = packedRow[w] >> shift;
+		// the high bits come from the next word unless the bits are aligned on a word
+		if(shift > 0 && w + 1 < wordsNb)
+		{
+			bits |= packedRow[w + 1] << (64 - shift);
+		}
+	}
+	return bits;
+}
+
+static unsigned int	getBlackMask8(unsigned char const* pixels, unsigned char thresh)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	std::uint64_t const	highBits = 0x8080808080808080ULL;
+	std::uint64_t		bytes = 0;
+	std::uint64_t		limits = 0;
+	std::uint64_t		lowGreaterEqual = 0;
+	std::uint64_t		greaterEqual = 0;
+
+	if(thresh == 255)
+	{
+		return 0xff;
+	}
+	std::memcpy(&bytes, pixels, sizeof(bytes));
+	// a pixel is black when it is lower than thresh + 1, repeated in every byte
+	limits = 0x0101010101010101ULL * static_cast<std::uint64_t>(thresh + 1);
+	// the high bit of every byte of the difference is set when the 7 low bits of the pixel are greater or equal to the ones of the limit (the high bit of the pixel is forced to 1 so that no byte borrows from the next one)
+	lowGreaterEqual = (bytes | highBits) - (limits & ~highBits);
+	// pixel >= limit if its high bit is set and not the one of the limit, or if both high bits are equal and the low bits are greater or equal
+	greaterEqual = (bytes & ~limits & highBits) | (~(bytes ^ limits) & lowGreaterEqual & highBits);
+	// gather the 8 high bits of the black pixels in the lowest byte (the bit of the k-th pixel at position k)
+	return static_cast<unsigned int>((((~greaterEqual & highBits) >> 7) * 0x0102040810204080ULL) >> 56);
+#else
+	unsigned int	mask = 0;
+
+	for(int k = 0; k < 8; ++k)
+	{
+		mask |= static_cast<unsigned int>(pixels[k] <= thresh) << k;
+	}
+	return mask;
+#endif
+}
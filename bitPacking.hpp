@@ -0,0 +1,75 @@
+#ifndef BIT_PACKING_HPP
+#define BIT_PACKING_HPP
+#include <opencv2/core/core.hpp>
+#include <cstdint>
+#include <vector>
+
+/*!
+	\brief
+	Number of words of 64 bits taken by a packed row of 'width' pixels
+*/
+int							getPackedWordsNb(int width);
+
+/*!
+	\brief
+	Number of bits set in a word
+*/
+inline int					popCount(std::uint64_t word)
+{
+	return __builtin_popcountll(word);
+}
+
+/*!
+	\brief
+	Index of the lowest bit set in a word (word must not be 0)
+*/
+inline int					getLowestBit(std::uint64_t word)
+{
+	return __builtin_ctzll(word);
+}
+
+/*!
+	\brief
+	High bit of every byte of 8 pixels read in a word set if and only if the pixel is 0 (black in a binarized image), whatever the order of the bytes in the word
+*/
+inline std::uint64_t		getZeroBytes(std::uint64_t bytes)
+{
+	std::uint64_t const	low7Bits = 0x7f7f7f7f7f7f7f7fULL;
+
+	return ~(((bytes & low7Bits) + low7Bits) | bytes | low7Bits);
+}
+
+/*!
+	\brief
+	Pack the columns [colStart; colStart + width[ of every row of an 8 bits image in words of 64 bits : the bit j % 64 of the word j / 64 of a row is set when the pixel is black, that is lower or equal to thresh (the pixels set to 0 by binarize(img, thresh)). Every row takes getPackedWordsNb(width) words and the unused bits of its last word stay equal to 0, so that the rows of 2 packed images of the same width can be compared with a xor
+
+	\param img 8 bits image (a binarized image is packed with thresh = 0)
+	\param colStart first packed column
+	\param width number of packed columns
+	\param thresh highest value of a black pixel
+*/
+std::vector<std::uint64_t>	packRows(cv::Mat const& img, int colStart, int width, unsigned char thresh);
+
+/*!
+	\brief
+	packRows in a buffer given by the caller, whose memory is reused from one call to another
+
+	\param img see packRows
+	\param colStart see packRows
+	\param width see packRows
+	\param thresh see packRows
+	\param words img.rows * getPackedWordsNb(width) words
+*/
+void						packRows(cv::Mat const& img, int colStart, int width, unsigned char thresh, std::vector<std::uint64_t>& words);
+
+/*!
+	\brief
+	The 64 bits of a packed row starting at the bit bitStart (the bits after the end of the row are 0)
+
+	\param packedRow first word of the row
+	\param wordsNb number of words of the row
+	\param bitStart index of the first bit (the column in the packed image)
+*/
+std::uint64_t				getPackedBits(std::uint64_t const* packedRow, int wordsNb, int bitStart);
+
+#endif
@@ -41,12 +41,12 @@ static cv::Mat	getHorizontalSegmentsMap(cv::Mat const& subImg);
 */
 static cv::Mat applyClosingOperation(cv::Mat const& horLinesImg, cv::Mat const& subImg);
 
-void	gatherImages(std::vector<Stave> const& staves)
+void	gatherImages(std::vector<Stave> const& staves, ResultSink& sink)
 {
 	std::vector<cv::Mat>	subImgV;
 	cv::Mat					subImg;
 	int						subImagesNb = static_cast<unsigned int>(staves.size());
-	Stave					previousStave = staves.at(0);
+	Stave const*			previousStave = &staves.at(0);
 	bool					isPairedStaves = false;
 
 	subImgV.reserve(subImagesNb);
@@ -58,18 +58,17 @@ void	gatherImages(std::vector<Stave> const& staves)
 		subImgV.push_back(getVerticalSegmentsMap(subImg));
 		if(i > 0)
 		{
-			int absUp = previousStave.getStaveLines().at(2).getAbsCoords().at(0);	
+			int absUp = previousStave->getStaveLines().at(2).getAbsCoords().at(0);	
 			int absDown = stave.getStaveLines().at(2).getAbsCoords().at(0);
 			bool arePaired = areStavesPaired(subImgV.at(i - 1), subImgV.at(i), absUp, absDown);
 			if(arePaired)
 			{
-				subImg = gatherSubImages(previousStave.getStaveImg(), stave.getStaveImg(), stave.getStaveLines().at(0).getAbsCoords().at(0));
-				cv::imshow("gathered " + std::to_string(i), subImg);
-				cv::waitKey(0);
+				subImg = gatherSubImages(previousStave->getStaveImg(), stave.getStaveImg(), stave.getStaveLines().at(0).getAbsCoords().at(0));
+				sink.putImage("gathered " + std::to_string(i), subImg);
 				isPairedStaves = true;
 			}
 		}
-		previousStave = stave;
+		previousStave = &stave;
 	}
 	if(!isPairedStaves)
 	{
@@ -77,7 +76,7 @@ void	gatherImages(std::vector<Stave> const& staves)
 	}
 }
 
-void	detectCircles(std::vector<Stave> const& staves, int interline)
+void	detectCircles(std::vector<Stave> const& staves, int interline, ResultSink& sink)
 {
 	std::vector<cv::Vec3f>	circles;
 	int						minRadius = std::round(static_cast<double>(interline) / 4.0);
@@ -99,8 +98,7 @@ void	detectCircles(std::vector<Stave> const& staves, int interline)
 			// circle outline
 			cv::circle( subImgRGB, center, radius, cv::Scalar(0,0,255), 1, 8, 0 );
 		}
-		cv::imshow("circles in stave " + std::to_string(i), subImgRGB);
-		cv::waitKey(0);
+		sink.putImage("circles in stave " + std::to_string(i), subImgRGB);
 	}
 }
 
@@ -124,7 +122,7 @@ void	erodeWithEllipseElement(std::vector<Stave> const& staves, int interline)
 }
 
 // this process represents 4 of 6 steps to get the bounding boxes, the rest is not implemented yet
-std::vector<cv::Mat>	highLightVerticals(std::vector<Stave> const& staves)
+std::vector<cv::Mat>	highLightVerticals(std::vector<Stave> const& staves, ResultSink& sink)
 {
 	// erase() has to be applied before entering this function
 	std::vector<cv::Mat>	subImgHInV;
@@ -150,8 +148,7 @@ std::vector<cv::Mat>	highLightVerticals(std::vector<Stave> const& staves)
 		subImgH.push_back(getHorizontalSegmentsMap(subImagesClosed.at(i)));
 		// extract vertical segments on the closed sub image
 		subImgV.push_back(getVerticalSegmentsMap(subImagesClosed.at(i)));
-		cv::imshow("verticals of image " + std::to_string(i), subImgV.at(i));
-		cv::waitKey(0);
+		sink.putImage("verticals of image " + std::to_string(i), subImgV.at(i));
 	}
 	return subImgV;
 }
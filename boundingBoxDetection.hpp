@@ -11,22 +11,28 @@
   Gather the sub images that contains paired staves (linked by curly brackets)
 
   \param staves vector of Stave
+  \param sink receives the gathered images
 */
-void					gatherImages(std::vector<Stave> const& staves);
+void					gatherImages(std::vector<Stave> const& staves, ResultSink& sink);
 
 /*! 
   \brief
   Display the significant vertical segments of every stave (the brightest represent the longest)
 
   \param staves vector of Stave
+  \param sink receives the images of the vertical segments
 */
-std::vector<cv::Mat>	highLightVerticals(std::vector<Stave> const& staves);
+std::vector<cv::Mat>	highLightVerticals(std::vector<Stave> const& staves, ResultSink& sink);
 
 /*!
   \brief
   use the hough transform to detect the circles in sub images
+
+  \param staves vector of Stave
+  \param interline see Staves::getInterline
+  \param sink receives the images of the staves with their circles
 */
-void					detectCircles(std::vector<Stave> const& staves, int interline);
+void					detectCircles(std::vector<Stave> const& staves, int interline, ResultSink& sink);
 
 /*!
  \brief
@@ -6,10 +6,16 @@
 #include <set>
 #include <cmath>
 #include <string>
+#include <memory>
 #include "tools.hpp"
 #include "Staves.hpp"
 #include "staveDetection.hpp"
 #include "boundingBoxDetection.hpp"
+#include "benchmark.hpp"
+#include "ResultSink.hpp"
+#include "batch.hpp"
+#include "StripSource.hpp"
+#include "PageWorkspace.hpp"
 #include <stdexcept>
 
 static std::string const	OPTION_PRINT = "printLines";
@@ -18,6 +24,20 @@ static std::string const	OPTION_ERASE = "eraseLines";
 static std::string const	OPTION_GATHER = "gatherStaves";
 static std::string const	OPTION_VERTICALLINES = "printVerticalLines";
 static std::string const	OPTION_CIRCLES = "printCircles";
+static std::string const	OPTION_BENCHMARK = "benchmark";
+static std::string const	OPTION_SCALING = "scaling";
+static std::string const	OPTION_SAUVOLA = "sauvola";
+static std::string const	OPTION_NIBLACK = "niblack";
+static std::string const	OPTION_VITERBI = "viterbi";
+static std::string const	OPTION_SINK = "sink=";
+static std::string const	OPTION_THREADS = "threads=";
+static std::string const	OPTION_BATCH = "batch";
+static std::string const	OPTION_MEMORY = "memory=";
+static std::string const	OPTION_DECODERS = "decoders=";
+static std::string const	OPTION_WRITERS = "writers=";
+static std::string const	OPTION_QUEUE = "queue=";
+static std::string const	OPTION_STREAM = "stream";
+static std::string const	OPTION_STRIP = "strip=";
 
 std::set<std::string>	makeArgumentSet(int argc, char* argv[])
 {
@@ -35,16 +55,178 @@ bool	isInSet(std::set<std::string> const& arguments, std::string const& argument
 	return (arguments.find(argument) != arguments.end());
 }
 
+std::string	getOptionValue(std::set<std::string> const& arguments, std::string const& option, std::string const& defaultValue)
+{
+	for(auto const& argument : arguments)
+	{
+		if(argument.compare(0, option.size(), option) == 0)
+		{
+			return argument.substr(option.size());
+		}
+	}
+	return defaultValue;
+}
+
+BinarizationMode	getBinarizationMode(std::set<std::string> const& arguments)
+{
+	if(isInSet(arguments, OPTION_SAUVOLA))
+	{
+		return BinarizationMode::SAUVOLA;
+	}
+	else if(isInSet(arguments, OPTION_NIBLACK))
+	{
+		return BinarizationMode::NIBLACK;
+	}
+	return BinarizationMode::FIXED;
+}
+
+TrackingMode	getTrackingMode(std::set<std::string> const& arguments)
+{
+	return (isInSet(arguments, OPTION_VITERBI) ? TrackingMode::VITERBI : TrackingMode::SMOOTHING);
+}
+
+int		getCount(std::set<std::string> const& arguments, std::string const& option, int defaultValue)
+{
+	std::string		count = getOptionValue(arguments, option, "");
+
+	if(count.empty())
+	{
+		return defaultValue;
+	}
+	if(std::stoi(count) < 1)
+	{
+		throw std::invalid_argument("the value of " + option + " must be at least 1");
+	}
+	return std::stoi(count);
+}
+
+int		getThreadsNb(std::set<std::string> const& arguments)
+{
+	// all the threads of OpenCV unless a number is given (1 runs everything in the calling thread, the results are the same)
+	return getCount(arguments, OPTION_THREADS, cv::getNumThreads());
+}
+
+int		processBatch(std::string const& source, std::set<std::string> const& arguments)
+{
+	std::unique_ptr<ResultSink>		sink;
+	std::vector<PageReport>			reports;
+	std::vector<StageStatistics>	statistics;
+	BatchSettings					settings;
+
+	try
+	{
+		// the geometry of the pages is discarded unless a sink is chosen, the windows can't be shown by the workers
+		sink = makeResultSink(getOptionValue(arguments, OPTION_SINK, "null"));
+		settings.decodersNb = getCount(arguments, OPTION_DECODERS, 2);
+		settings.analysersNb = getThreadsNb(arguments);
+		settings.writersNb = getCount(arguments, OPTION_WRITERS, 1);
+		settings.queueCapacity = getCount(arguments, OPTION_QUEUE, 4);
+		settings.memoryBudget = static_cast<std::size_t>(getCount(arguments, OPTION_MEMORY, 2048)) << 20;
+		reports = runBatch(listPages(source), settings, getBinarizationMode(arguments), getTrackingMode(arguments), *sink, statistics);
+		printBatchReport(reports, std::cout);
+		printStageStatistics(statistics, std::cout);
+	}
+	catch(std::exception &e)
+	{
+		std::cout << e.what() << std::endl;
+		return -1;
+	}
+	return 0;
+}
+
+bool	isKeepingStaveImages(std::set<std::string> const& arguments)
+{
+	return isInSet(arguments, OPTION_PRINT) || isInSet(arguments, OPTION_ERASE) || isInSet(arguments, OPTION_GATHER) || isInSet(arguments, OPTION_VERTICALLINES) || isInSet(arguments, OPTION_CIRCLES);
+}
+
+void	processStaves(std::string const& fileName, Staves& staves, std::set<std::string> const& arguments, ResultSink& sink)
+{
+	sink.putGeometry(fileName, staves);
+	if(isInSet(arguments, OPTION_PRINT))
+	{
+		staves.print(sink);
+	}
+	if(isInSet(arguments, OPTION_ERASE))
+	{
+		staves.erase();
+		staves.printErasure(sink);
+	}
+	if(isInSet(arguments, OPTION_GATHER))
+	{
+		gatherImages(staves.getStaves(), sink);
+	}
+	if(isInSet(arguments, OPTION_VERTICALLINES))
+	{
+		std::vector<cv::Mat>	verticalLines = highLightVerticals(staves.getStaves(), sink);
+	}
+	if(isInSet(arguments, OPTION_CIRCLES))
+	{
+		erodeWithEllipseElement(staves.getStaves(), staves.getInterline());
+		detectCircles(staves.getStaves(), staves.getInterline(), sink);
+	}
+}
+
+int		processStream(std::string const& fileName, std::set<std::string> const& arguments)
+{
+	std::unique_ptr<ResultSink>		sink;
+	std::unique_ptr<StripSource>	source;
+	PageWorkspace					workspace;
+	Staves							staves;
+	cv::Mat							score;
+
+	try
+	{
+		if(getBinarizationMode(arguments) != BinarizationMode::FIXED)
+		{
+			throw std::invalid_argument("the pages read by strips are binarized with the fixed threshold only");
+		}
+		sink = makeResultSink(getOptionValue(arguments, OPTION_SINK, "window"));
+		cv::setNumThreads(getThreadsNb(arguments));
+		// a binary PGM file is read strip by strip from the file, the other formats are decoded whole before being given by strips
+		if(PgmStripSource::isPgmFile(fileName))
+		{
+			source.reset(new PgmStripSource(fileName));
+		}
+		else
+		{
+			score = cv::imread(fileName, cv::IMREAD_GRAYSCALE);
+			if(score.empty())
+			{
+				throw std::invalid_argument("'" + fileName + "' can't be found");
+			}
+			source.reset(new MatStripSource(score));
+		}
+		// the images of the staves are only kept for the options showing them
+		staves.setup(*source, workspace, getCount(arguments, OPTION_STRIP, 256), isKeepingStaveImages(arguments), getTrackingMode(arguments));
+		processStaves(fileName, staves, arguments, *sink);
+	}
+	catch(std::exception &e)
+	{
+		std::cout << e.what() << std::endl;
+		return -1;
+	}
+	return 0;
+}
+
 int main(int argc, char* argv[])
 {
 	std::string				fileName;
 	Staves					staves;
+	std::unique_ptr<ResultSink>	sink;
 	cv::Mat					score;
 	std::set<std::string>	arguments = makeArgumentSet(argc, argv);
 
 	if(argc > 1)
 	{
 		fileName = argv[1];
+		if(isInSet(arguments, OPTION_BATCH))
+		{
+			return processBatch(fileName, arguments);
+		}
+		if(isInSet(arguments, OPTION_STREAM))
+		{
+			return processStream(fileName, arguments);
+		}
 		score = cv::imread(fileName, cv::IMREAD_GRAYSCALE);
 
 		if(score.empty())
@@ -56,32 +238,23 @@ int main(int argc, char* argv[])
 		{
 			try
 			{
+				// the images of the stages are displayed in windows unless another sink is chosen
+				sink = makeResultSink(getOptionValue(arguments, OPTION_SINK, "window"));
+				cv::setNumThreads(getThreadsNb(arguments));
 				if(isInSet(arguments, OPTION_RESIZE))
 				{
 					cv::resize(score, score, cv::Size(score.cols / 2, score.rows / 2));
 				}
-				staves.setup(score);
-				if(isInSet(arguments, OPTION_PRINT))
-				{
-					staves.print();
-				}
-				if(isInSet(arguments, OPTION_ERASE))
-				{
-					staves.erase();
-				}
-				if(isInSet(arguments, OPTION_GATHER))
-				{
-					gatherImages(staves.getStaves());
-				}
-				if(isInSet(arguments, OPTION_VERTICALLINES))
+				if(isInSet(arguments, OPTION_BENCHMARK))
 				{
-					std::vector<cv::Mat>	verticalLines = highLightVerticals(staves.getStaves());
+					benchmark(score);
 				}
-				if(isInSet(arguments, OPTION_CIRCLES))
+				if(isInSet(arguments, OPTION_SCALING))
 				{
-					erodeWithEllipseElement(staves.getStaves(), staves.getInterline());
-					detectCircles(staves.getStaves(), staves.getInterline());
+					benchmarkScaling(score);
 				}
+				staves.setup(score, getBinarizationMode(arguments), getTrackingMode(arguments));
+				processStaves(fileName, staves, arguments, *sink);
 			}
 			catch(std::exception &e)
 			{
@@ -0,0 +1,159 @@
+#include "peaks.hpp"
+#include <algorithm>
+
+/*!
+	\brief
+	Minimum of the profile between every index and the nearest greater value before it in the direction of the scan (or the first index of the scan) : the left (step = 1) or right (step = -1) bases of getProminences
+
+	\param data profile
+	\param step 1 to scan the profile from its first index, -1 from its last one
+	\param bases data.size() values
+	\param buffers buffers of the stack
+*/
+static void	getBases(std::vector<int> const& data, int step, std::vector<int>& bases, PeakBuffers& buffers);
+
+void	getSlidingMax(std::vector<int> const& data, int halfWidth, std::vector<int>& maxVect)
+{
+	std::vector<int>	window;
+
+	getSlidingMax(data, halfWidth, maxVect, window);
+}
+
+void	getSlidingMax(std::vector<int> const& data, int halfWidth, std::vector<int>& maxVect, std::vector<int>& window)
+{
+	int		front = 0;
+	int		back = 0;
+	int		dataSize = static_cast<int>(data.size());
+
+	// monotonic deque in a vector : window[front] is the index of the maximum of the window, the values of the indexes behind it decrease
+	window.assign(data.size(), 0);
+	halfWidth = std::max(0, halfWidth);
+	maxVect.assign(data.size(), 0);
+	for(int j = 0; j < dataSize + halfWidth; ++j)
+	{
+		if(j < dataSize)
+		{
+			while(back > front && data[window[back - 1]] <= data[j])
+			{
+				--back;
+			}
+			window[back++] = j;
+		}
+		if(j >= halfWidth)
+		{
+			while(window[front] < j - 2 * halfWidth)
+			{
+				++front;
+			}
+			maxVect[j - halfWidth] = data[window[front]];
+		}
+	}
+}
+
+void	getSlidingMin(std::vector<int> const& data, int width, std::vector<int>& minVect)
+{
+	std::vector<int>	window;
+
+	getSlidingMin(data, width, minVect, window);
+}
+
+void	getSlidingMin(std::vector<int> const& data, int width, std::vector<int>& minVect, std::vector<int>& window)
+{
+	int		front = 0;
+	int		back = 0;
+	int		dataSize = static_cast<int>(data.size());
+
+	// window[front] is the index of the minimum of the window, the values of the indexes behind it increase
+	window.assign(data.size(), 0);
+	width = std::max(1, width);
+	minVect.assign(std::max(0, dataSize - width + 1), 0);
+	for(int j = 0; j < dataSize; ++j)
+	{
+		while(back > front && data[window[back - 1]] >= data[j])
+		{
+			--back;
+		}
+		window[back++] = j;
+		if(j >= width - 1)
+		{
+			while(window[front] <= j - width)
+			{
+				++front;
+			}
+			minVect[j - width + 1] = data[window[front]];
+		}
+	}
+}
+
+std::vector<int>	getProminences(std::vector<int> const& data)
+{
+	std::vector<int>	prominences;
+	PeakBuffers			buffers;
+
+	getProminences(data, prominences, buffers);
+	return prominences;
+}
+
+void	getProminences(std::vector<int> const& data, std::vector<int>& prominences, PeakBuffers& buffers)
+{
+	getBases(data, 1, prominences, buffers);
+	getBases(data, -1, buffers.rightBases, buffers);
+	for(std::size_t i = 0; i < data.size(); ++i)
+	{
+		prominences[i] = data[i] - std::max(prominences[i], buffers.rightBases[i]);
+	}
+}
+
+std::vector<Peak>	findPeaks(std::vector<int> const& data, int minSeparation, int minHeight)
+{
+	std::vector<Peak>	peaks;
+	PeakBuffers			buffers;
+
+	findPeaks(data, minSeparation, minHeight, peaks, buffers);
+	return peaks;
+}
+
+void	findPeaks(std::vector<int> const& data, int minSeparation, int minHeight, std::vector<Peak>& peaks, PeakBuffers& buffers)
+{
+	int		dataSize = static_cast<int>(data.size());
+
+	peaks.clear();
+	getProminences(data, buffers.prominences, buffers);
+	getSlidingMax(data, minSeparation, buffers.maxVect, buffers.window);
+	for(int i = 0; i < dataSize; ++i)
+	{
+		if(data[i] > minHeight && data[i] == buffers.maxVect[i] && (peaks.empty() || i - peaks.back().index > minSeparation))
+		{
+			peaks.push_back({i, data[i], buffers.prominences[i]});
+		}
+	}
+}
+
+static void	getBases(std::vector<int> const& data, int step, std::vector<int>& bases, PeakBuffers& buffers)
+{
+	std::vector<int>&	stack = buffers.stack;
+	std::vector<int>&	stackMins = buffers.stackMins;
+	int					top = 0;
+	int					minimum = 0;
+	int					i = 0;
+	int					dataSize = static_cast<int>(data.size());
+
+	// indexes of decreasing values, each one with the minimum of the profile between the index below it in the stack (excluded) and itself
+	stack.assign(data.size(), 0);
+	stackMins.assign(data.size(), 0);
+	bases.assign(data.size(), 0);
+	for(int k = 0; k < dataSize; ++k)
+	{
+		i = (step > 0) ? k : dataSize - 1 - k;
+		minimum = data[i];
+		while(top > 0 && data[stack[top - 1]] <= data[i])
+		{
+			--top;
+			minimum = std::min(minimum, stackMins[top]);
+		}
+		bases[i] = minimum;
+		stack[top] = i;
+		stackMins[top] = minimum;
+		++top;
+	}
+}
@@ -0,0 +1,112 @@
+#ifndef PEAKS_HPP
+#define PEAKS_HPP
+#include <vector>
+
+/*!
+  	\struct Peak
+	\brief Peak stores a local maximum of a profile found by findPeaks
+*/
+struct Peak
+{
+	int	index;		///< index of the maximum in the profile
+	int	value;		///< value of the profile at index
+	int	prominence;	///< height of the peak above the highest of its 2 bases : the minimum of the profile between the peak and the nearest higher value on each side (or the border)
+};
+
+/*!
+  	\struct PeakBuffers
+	\brief PeakBuffers stores the buffers of findPeaks, reused from one profile to another
+*/
+struct PeakBuffers
+{
+	std::vector<int>	window;			///< monotonic deque of getSlidingMax and getSlidingMin
+	std::vector<int>	stack;			///< monotonic stack of getProminences
+	std::vector<int>	stackMins;		///< minimum of the profile below every index of the stack
+	std::vector<int>	rightBases;		///< right bases of getProminences
+	std::vector<int>	maxVect;		///< see getSlidingMax
+	std::vector<int>	prominences;	///< see getProminences
+};
+
+/*!
+  	\brief
+	Maximum of the profile in the window [i - halfWidth; i + halfWidth] (clamped into the profile) of every index i, with a monotonic deque : every value is pushed and popped once whatever halfWidth is
+
+	\param data profile
+	\param halfWidth half size of the window
+	\param maxVect data.size() values, the buffer of the caller is reused
+*/
+void				getSlidingMax(std::vector<int> const& data, int halfWidth, std::vector<int>& maxVect);
+
+/*!
+  	\brief
+	getSlidingMax with the buffer of the deque given by the caller
+
+	\param data profile
+	\param halfWidth half size of the window
+	\param maxVect see getSlidingMax
+	\param window buffer of the deque, reused from one call to another
+*/
+void				getSlidingMax(std::vector<int> const& data, int halfWidth, std::vector<int>& maxVect, std::vector<int>& window);
+
+/*!
+  	\brief
+	Minimum of every window of width consecutive values of the profile lying inside it, with a monotonic deque as getSlidingMax
+
+	\param data profile
+	\param width number of values of a window
+	\param minVect data.size() - width + 1 values (none if width is greater than data.size()) : minVect[i] is the minimum of data[i; i + width[, the buffer of the caller is reused
+*/
+void				getSlidingMin(std::vector<int> const& data, int width, std::vector<int>& minVect);
+
+/*!
+  	\brief
+	getSlidingMin with the buffer of the deque given by the caller
+
+	\param data profile
+	\param width number of values of a window
+	\param minVect see getSlidingMin
+	\param window buffer of the deque, reused from one call to another
+*/
+void				getSlidingMin(std::vector<int> const& data, int width, std::vector<int>& minVect, std::vector<int>& window);
+
+/*!
+  	\brief
+	Prominence of every value of the profile (see Peak), with a monotonic stack from each side
+
+	\param data profile
+*/
+std::vector<int>	getProminences(std::vector<int> const& data);
+
+/*!
+  	\brief
+	getProminences with the buffers of the caller
+
+	\param data profile
+	\param prominences data.size() values
+	\param buffers buffers of the stacks and of the right bases
+*/
+void				getProminences(std::vector<int> const& data, std::vector<int>& prominences, PeakBuffers& buffers);
+
+/*!
+  	\brief
+	Peaks of a profile in O(n) : an index is a peak if its value is greater than minHeight and is the maximum of the profile at most minSeparation indexes away from it. Equal maxima closer than minSeparation (a plateau) give only their first index, so that 2 peaks are always more than minSeparation apart. The peaks do not depend on the order of the scan
+
+	\param data profile (the stave profile of getStavesProfileVect, a histogram, the vertical profile of the bar lines)
+	\param minSeparation minimum distance between 2 peaks
+	\param minHeight the values lower or equal are not peaks
+*/
+std::vector<Peak>	findPeaks(std::vector<int> const& data, int minSeparation, int minHeight);
+
+/*!
+  	\brief
+	findPeaks with the buffers of the caller
+
+	\param data see findPeaks
+	\param minSeparation see findPeaks
+	\param minHeight see findPeaks
+	\param peaks peaks of the profile, the buffer of the caller is reused
+	\param buffers see PeakBuffers
+*/
+void				findPeaks(std::vector<int> const& data, int minSeparation, int minHeight, std::vector<Peak>& peaks, PeakBuffers& buffers);
+
+#endif
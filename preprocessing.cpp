@@ -0,0 +1,41 @@
+#include "preprocessing.hpp"
+#include "tools.hpp"
+#include "profiles.hpp"
+
+void	preprocessScore(cv::Mat const& score, unsigned char thresh, SlopeModel& slopeModel, BitPlane& binaryPlane, std::vector<int>& profileVect)
+{
+	BitPlane		pagePlane;
+	SlopeBuffers	buffers;
+
+	preprocessScore(score, thresh, slopeModel, binaryPlane, profileVect, pagePlane, buffers);
+}
+
+void	preprocessScore(cv::Mat const& score, unsigned char thresh, SlopeModel& slopeModel, BitPlane& binaryPlane, std::vector<int>& profileVect, BitPlane& pagePlane, SlopeBuffers& buffers)
+{
+	CV_Assert(score.type() == CV_8UC1);
+	// the only pass over the gray page : 1 bit per pixel is 8 times less to stream in the next ones
+	BitPlane::fromMat(score, thresh, pagePlane);
+	slopeModel.setupPage(estimateSlope(pagePlane, buffers));
+	correctSlope(pagePlane, slopeModel.getPageEstimate().hMax, binaryPlane, buffers);
+	getRowProfile(binaryPlane, profileVect);
+}
+
+void	preprocessScoreWithPrior(cv::Mat const& score, unsigned char thresh, SlopeEstimate const& priorEstimate, SlopeModel& slopeModel, BitPlane& binaryPlane, std::vector<int>& profileVect, BitPlane& pagePlane, SlopeBuffers& buffers)
+{
+	SlopeEstimate	estimate = {0, 0.0, 0.0, 0.0};
+
+	CV_Assert(score.type() == CV_8UC1);
+	BitPlane::fromMat(score, thresh, pagePlane);
+	estimate = estimateSlope(pagePlane, buffers);
+	slopeModel.setupPage(estimate.confidence < priorEstimate.confidence ? priorEstimate : estimate);
+	correctSlope(pagePlane, slopeModel.getPageEstimate().hMax, binaryPlane, buffers);
+	getRowProfile(binaryPlane, profileVect);
+}
+
+void	preprocessScore(cv::Mat const& score, unsigned char thresh, SlopeModel& slopeModel, cv::Mat& binaryImg, std::vector<int>& profileVect)
+{
+	BitPlane	binaryPlane;
+
+	preprocessScore(score, thresh, slopeModel, binaryPlane, profileVect);
+	binaryPlane.toMat(binaryImg);
+}
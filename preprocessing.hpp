@@ -0,0 +1,63 @@
+#ifndef PREPROCESSING_HPP
+#define PREPROCESSING_HPP
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "SlopeModel.hpp"
+#include "BitPlane.hpp"
+
+/*!
+	\brief
+	Front end of the detection on bit planes instead of the successive binarize, correctSlope and getHorizontalProfile which all streamed the full 8 bits page : the gray page is read once and thresholded in a bit plane, then the slope of the page is estimated, corrected and profiled on the bit plane
+
+	The results are the ones of binarize(score, thresh), correctSlope(binaryImg, hMax) with the hMax of the page and getHorizontalProfile of the corrected page
+
+	\param score image of one page of score in gray scale (8 bits)
+	\param thresh highest gray level of a black pixel (see binarize)
+	\param slopeModel its page estimate is set (see SlopeModel::setupPage)
+	\param binaryPlane binarized page corrected from its slope
+	\param profileVect number of black pixels of every row of binaryPlane
+*/
+void	preprocessScore(cv::Mat const& score, unsigned char thresh, SlopeModel& slopeModel, BitPlane& binaryPlane, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	preprocessScore with the buffers of the caller : nothing is allocated once they have grown to the size of the page
+
+	\param score see preprocessScore
+	\param thresh see preprocessScore
+	\param slopeModel see preprocessScore
+	\param binaryPlane see preprocessScore, its words are reused when they are not shared
+	\param profileVect see preprocessScore
+	\param pagePlane buffer of the page thresholded before the correction of its slope
+	\param buffers see SlopeBuffers
+*/
+void	preprocessScore(cv::Mat const& score, unsigned char thresh, SlopeModel& slopeModel, BitPlane& binaryPlane, std::vector<int>& profileVect, BitPlane& pagePlane, SlopeBuffers& buffers);
+
+/*!
+	\brief
+	preprocessScore of a page binarized again (adaptively) after a first estimate of its slope : the slope is searched on the page again, the prior estimate is kept only if the new one has a lower confidence (a page whose lighting broke the fixed threshold gives a poor prior, a page whose adaptive binarization is noisy a poor new estimate)
+
+	\param score see preprocessScore
+	\param thresh see preprocessScore
+	\param priorEstimate estimate of the slope of the same page binarized another way
+	\param slopeModel see preprocessScore
+	\param binaryPlane see preprocessScore
+	\param profileVect see preprocessScore
+	\param pagePlane see preprocessScore
+	\param buffers see preprocessScore
+*/
+void	preprocessScoreWithPrior(cv::Mat const& score, unsigned char thresh, SlopeEstimate const& priorEstimate, SlopeModel& slopeModel, BitPlane& binaryPlane, std::vector<int>& profileVect, BitPlane& pagePlane, SlopeBuffers& buffers);
+
+/*!
+	\brief
+	preprocessScore unpacked in an 8 bits image
+
+	\param score see preprocessScore
+	\param thresh see preprocessScore
+	\param slopeModel see preprocessScore
+	\param binaryImg binarized page corrected from its slope, reallocated only if it has not the size of score
+	\param profileVect see preprocessScore
+*/
+void	preprocessScore(cv::Mat const& score, unsigned char thresh, SlopeModel& slopeModel, cv::Mat& binaryImg, std::vector<int>& profileVect);
+
+#endif
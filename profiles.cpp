@@ -0,0 +1,140 @@
+#include "profiles.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "bitPacking.hpp"
+
+/*!
+	\brief
+	Number of pixels equal to 0 among n consecutive pixels, 8 at a time : the high bits set by getZeroBytes are counted with popCount
+
+	\param pixels first pixel
+	\param n number of pixels
+*/
+static int	countBlackPixels(unsigned char const* pixels, int n);
+
+void	getRowProfile(cv::Mat const& binaryImg, cv::Rect const& roi, std::vector<int>& profileVect)
+{
+	CV_Assert(binaryImg.type() == CV_8UC1 && (roi & cv::Rect(0, 0, binaryImg.cols, binaryImg.rows)) == roi);
+	profileVect.assign(roi.height, 0);
+	for(int i = 0; i < roi.height; ++i)
+	{
+		profileVect[i] = countBlackPixels(binaryImg.ptr<unsigned char>(roi.y + i) + roi.x, roi.width);
+	}
+}
+
+void	getRowProfile(cv::Mat const& binaryImg, std::vector<int>& profileVect)
+{
+	getRowProfile(binaryImg, cv::Rect(0, 0, binaryImg.cols, binaryImg.rows), profileVect);
+}
+
+void	getRowProfile(BitPlane const& binaryPlane, cv::Rect const& roi, std::vector<int>& profileVect)
+{
+	CV_Assert((roi & cv::Rect(0, 0, binaryPlane.getCols(), binaryPlane.getRows())) == roi);
+	profileVect.assign(roi.height, 0);
+	for(int i = 0; i < roi.height; ++i)
+	{
+		profileVect[i] = binaryPlane.countBlack(roi.y + i, roi.x, roi.x + roi.width);
+	}
+}
+
+void	getRowProfile(BitPlane const& binaryPlane, std::vector<int>& profileVect)
+{
+	getRowProfile(binaryPlane, cv::Rect(0, 0, binaryPlane.getCols(), binaryPlane.getRows()), profileVect);
+}
+
+void	getColProfile(cv::Mat const& binaryImg, cv::Rect const& roi, std::vector<int>& profileVect)
+{
+	unsigned char const*	row = nullptr;
+	int*					counts = nullptr;
+
+	CV_Assert(binaryImg.type() == CV_8UC1 && (roi & cv::Rect(0, 0, binaryImg.cols, binaryImg.rows)) == roi);
+	profileVect.assign(roi.width, 0);
+	counts = profileVect.data();
+	// row by row so that the image is read in the order of its memory, the loop over the columns has no dependency and is vectorized by the compiler
+	for(int i = 0; i < roi.height; ++i)
+	{
+		row = binaryImg.ptr<unsigned char>(roi.y + i) + roi.x;
+		for(int j = 0; j < roi.width; ++j)
+		{
+			counts[j] += (row[j] == 0);
+		}
+	}
+}
+
+void	getColProfile(cv::Mat const& binaryImg, std::vector<int>& profileVect)
+{
+	getColProfile(binaryImg, cv::Rect(0, 0, binaryImg.cols, binaryImg.rows), profileVect);
+}
+
+void	getColProfile(BitPlane const& binaryPlane, cv::Rect const& roi, std::vector<int>& profileVect)
+{
+	std::uint64_t	bits = 0;
+
+	CV_Assert((roi & cv::Rect(0, 0, binaryPlane.getCols(), binaryPlane.getRows())) == roi);
+	profileVect.assign(roi.width, 0);
+	for(int i = 0; i < roi.height; ++i)
+	{
+		for(int j = 0; j < roi.width; j += 64)
+		{
+			bits = binaryPlane.getBits(roi.y + i, roi.x + j);
+			if(roi.width - j < 64)
+			{
+				bits &= (std::uint64_t(1) << (roi.width - j)) - 1;
+			}
+			while(bits != 0)
+			{
+				++profileVect[j + getLowestBit(bits)];
+				bits &= bits - 1;
+			}
+		}
+	}
+}
+
+void	getColProfile(BitPlane const& binaryPlane, std::vector<int>& profileVect)
+{
+	getColProfile(binaryPlane, cv::Rect(0, 0, binaryPlane.getCols(), binaryPlane.getRows()), profileVect);
+}
+
+cv::Mat	drawRowProfile(std::vector<int> const& profileVect, int width)
+{
+	cv::Mat	profile(static_cast<int>(profileVect.size()), width, CV_8UC1, cv::Scalar(255));
+
+	for(int i = 0; i < profile.rows; ++i)
+	{
+		std::memset(profile.ptr<unsigned char>(i), 0, std::max(0, std::min(width, profileVect.at(i) + 1)));
+	}
+	return profile;
+}
+
+cv::Mat	drawColProfile(std::vector<int> const& profileVect, int height)
+{
+	cv::Mat	profile = cv::Mat::zeros(height, static_cast<int>(profileVect.size()), CV_8UC1);
+
+	for(int j = 0; j < profile.cols; ++j)
+	{
+		for(int i = std::max(0, height - profileVect.at(j)); i < height; ++i)
+		{
+			profile.at<unsigned char>(i, j) = 255;
+		}
+	}
+	return profile;
+}
+
+static int	countBlackPixels(unsigned char const* pixels, int n)
+{
+	std::uint64_t	bytes = 0;
+	int				blackPixelsNb = 0;
+	int				j = 0;
+
+	for(; j + 8 <= n; j += 8)
+	{
+		std::memcpy(&bytes, pixels + j, sizeof(bytes));
+		blackPixelsNb += popCount(getZeroBytes(bytes));
+	}
+	for(; j < n; ++j)
+	{
+		blackPixelsNb += (pixels[j] == 0);
+	}
+	return blackPixelsNb;
+}
@@ -0,0 +1,81 @@
+#ifndef PROFILES_HPP
+#define PROFILES_HPP
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "BitPlane.hpp"
+
+/*!
+	\brief
+	Horizontal projection profile of a binary image : number of black pixels (equal to 0) of every row of the region of interest. profileVect is a buffer of the caller, its memory is reused from one call to another
+
+	\param binaryImg binarized image (8 bits)
+	\param roi region of interest of binaryImg
+	\param profileVect roi.height values
+*/
+void	getRowProfile(cv::Mat const& binaryImg, cv::Rect const& roi, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	getRowProfile of the whole image
+*/
+void	getRowProfile(cv::Mat const& binaryImg, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	getRowProfile of a bit plane, with popcount
+*/
+void	getRowProfile(BitPlane const& binaryPlane, cv::Rect const& roi, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	getRowProfile of a whole bit plane
+*/
+void	getRowProfile(BitPlane const& binaryPlane, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	Vertical projection profile of a binary image : number of black pixels (equal to 0) of every column of the region of interest. The rows are read one after another and added to the counters of all the columns
+
+	\param binaryImg binarized image (8 bits)
+	\param roi region of interest of binaryImg
+	\param profileVect roi.width values
+*/
+void	getColProfile(cv::Mat const& binaryImg, cv::Rect const& roi, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	getColProfile of the whole image
+*/
+void	getColProfile(cv::Mat const& binaryImg, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	getColProfile of a bit plane : only the black pixels of every row are visited
+*/
+void	getColProfile(BitPlane const& binaryPlane, cv::Rect const& roi, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	getColProfile of a whole bit plane
+*/
+void	getColProfile(BitPlane const& binaryPlane, std::vector<int>& profileVect);
+
+/*!
+	\brief
+	Image of a horizontal profile for debugging : the row i is black from the left border on profileVect[i] + 1 pixels
+
+	\param profileVect see getRowProfile
+	\param width width of the image
+*/
+cv::Mat	drawRowProfile(std::vector<int> const& profileVect, int width);
+
+/*!
+	\brief
+	Image of a vertical profile for debugging : the column j is white from the bottom border on profileVect[j] pixels
+
+	\param profileVect see getColProfile
+	\param height height of the image
+*/
+cv::Mat	drawColProfile(std::vector<int> const& profileVect, int height);
+
+#endif
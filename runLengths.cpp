@@ -0,0 +1,145 @@
+#include "runLengths.hpp"
+#include <algorithm>
+#include <cstdint>
+#include "bitPacking.hpp"
+#include "staveDetection.hpp"
+#include "tools.hpp"
+
+/*!
+	\brief
+	Masks of the followed columns of every word of a packed row : the bit k of the word w is set if the column 64 * w + k is a multiple of colStep
+
+	\param cols number of columns of the page
+	\param colStep see getRunStatistics
+	\param columnMasks getPackedWordsNb(cols) masks
+*/
+static void	getColumnMasks(int cols, int colStep, std::vector<std::uint64_t>& columnMasks);
+
+/*!
+	\brief
+	Follow the runs of the columns of getRunStatistics over one more row of the page
+
+	\param strip rows of the page, nullptr for the white row after the last one
+	\param stripRow row of strip
+	\param i row of the page
+	\param statistics see getRunStatistics
+	\param buffers see RunBuffers
+*/
+static void	followRow(BitPlane const* strip, int stripRow, int i, RunStatistics& statistics, RunBuffers& buffers);
+
+RunStatistics	getRunStatistics(BitPlane const& binaryPlane, int colStep)
+{
+	RunStatistics	statistics;
+	RunBuffers		buffers;
+
+	getRunStatistics(binaryPlane, colStep, statistics, buffers);
+	return statistics;
+}
+
+void	getRunStatistics(BitPlane const& binaryPlane, int colStep, RunStatistics& statistics, RunBuffers& buffers)
+{
+	beginRunStatistics(binaryPlane.getRows(), binaryPlane.getCols(), colStep, statistics, buffers);
+	if(binaryPlane.isEmpty())
+	{
+		return;
+	}
+	addRunStatisticsRows(binaryPlane, 0, statistics, buffers);
+	endRunStatistics(binaryPlane.getRows(), statistics, buffers);
+}
+
+void	beginRunStatistics(int rows, int cols, int colStep, RunStatistics& statistics, RunBuffers& buffers)
+{
+	statistics.interline = 0;
+	statistics.thickness0 = 0;
+	statistics.thicknessAvg = -1.0;
+	statistics.blackRunHistogram.clear();
+	statistics.pairHistogram.clear();
+	if(rows == 0 || cols == 0)
+	{
+		return;
+	}
+	getColumnMasks(cols, colStep, buffers.columnMasks);
+	buffers.previousBits.assign(buffers.columnMasks.size(), 0);
+	buffers.blackStarts.assign(cols, 0);
+	buffers.whiteStarts.assign(cols, 0);
+	buffers.lastBlackLengths.assign(cols, 0);
+	statistics.blackRunHistogram.assign(rows + 1, 0);
+	statistics.pairHistogram.assign(rows + 1, 0);
+}
+
+void	addRunStatisticsRows(BitPlane const& strip, int firstRow, RunStatistics& statistics, RunBuffers& buffers)
+{
+	for(int i = 0; i < strip.getRows(); ++i)
+	{
+		followRow(&strip, i, firstRow + i, statistics, buffers);
+	}
+}
+
+void	endRunStatistics(int rows, RunStatistics& statistics, RunBuffers& buffers)
+{
+	if(statistics.blackRunHistogram.empty())
+	{
+		return;
+	}
+	// the row after the last one is white so that the black runs touching the bottom border are over
+	followRow(nullptr, 0, rows, statistics, buffers);
+	statistics.thickness0 = getMaxIndex(statistics.blackRunHistogram);
+	statistics.interline = getMaxIndex(statistics.pairHistogram);
+	if(statistics.thickness0 > 0 && statistics.thickness0 < rows)
+	{
+		statistics.thicknessAvg = getLineThickness(statistics.blackRunHistogram, statistics.thickness0);
+	}
+}
+
+RunStatistics	getRunStatistics(cv::Mat const& binaryImg, int colStep)
+{
+	return getRunStatistics(BitPlane::fromMat(binaryImg), colStep);
+}
+
+static void	getColumnMasks(int cols, int colStep, std::vector<std::uint64_t>& columnMasks)
+{
+	columnMasks.assign(getPackedWordsNb(cols), 0);
+	for(int j = 0; j < cols; j += std::max(1, colStep))
+	{
+		columnMasks.at(j / 64) |= std::uint64_t(1) << (j % 64);
+	}
+}
+
+static void	followRow(BitPlane const* strip, int stripRow, int i, RunStatistics& statistics, RunBuffers& buffers)
+{
+	std::vector<std::uint64_t> const&	columnMasks = buffers.columnMasks;
+	std::vector<std::uint64_t>&			previousBits = buffers.previousBits;
+	std::vector<int>&					blackStarts = buffers.blackStarts;
+	std::vector<int>&					whiteStarts = buffers.whiteStarts;
+	std::vector<int>&					lastBlackLengths = buffers.lastBlackLengths;
+	std::uint64_t						bits = 0;
+	std::uint64_t						changes = 0;
+	int									j = 0;
+
+	for(std::size_t w = 0; w < columnMasks.size(); ++w)
+	{
+		bits = (strip != nullptr) ? strip->getBits(stripRow, 64 * static_cast<int>(w)) & columnMasks.at(w) : 0;
+		changes = bits ^ previousBits.at(w);
+		while(changes != 0)
+		{
+			j = 64 * static_cast<int>(w) + getLowestBit(changes);
+			if((bits >> (j % 64)) & 1)
+			{
+				// a white run is over : it is a gap between 2 black runs unless it started at the top border
+				if(lastBlackLengths.at(j) > 0)
+				{
+					++statistics.pairHistogram.at(lastBlackLengths.at(j) + i - whiteStarts.at(j));
+				}
+				blackStarts.at(j) = i;
+			}
+			else
+			{
+				lastBlackLengths.at(j) = i - blackStarts.at(j);
+				++statistics.blackRunHistogram.at(lastBlackLengths.at(j));
+				whiteStarts.at(j) = i;
+			}
+			changes &= changes - 1;
+		}
+		previousBits.at(w) = bits;
+	}
+}
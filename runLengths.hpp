@@ -0,0 +1,96 @@
+#ifndef RUN_LENGTHS_HPP
+#define RUN_LENGTHS_HPP
+#include <opencv2/core/core.hpp>
+#include <cstdint>
+#include <vector>
+#include "BitPlane.hpp"
+
+/*!
+  	\struct RunStatistics
+	\brief RunStatistics stores the histograms of the vertical runs of a binarized page and the sizes of the staves read in them : on a page of score, most of the black runs of a column cross a line of stave and most of the white runs separate 2 lines of the same stave
+*/
+struct RunStatistics
+{
+	int					interline;			///< most frequent length of a black run plus the white run below it (the distance between 2 lines of stave, as findInterline)
+	int					thickness0;			///< most frequent length of a black run (the thickness of a line of stave)
+	double				thicknessAvg;		///< average of the lengths around thickness0 (see getLineThickness)
+	std::vector<int>	blackRunHistogram;	///< number of black runs of every length
+	std::vector<int>	pairHistogram;		///< number of black runs followed by a white run for every sum of their lengths
+};
+
+/*!
+  	\struct RunBuffers
+	\brief RunBuffers stores the state of every column followed by getRunStatistics, reused from one page to another
+*/
+struct RunBuffers
+{
+	std::vector<std::uint64_t>	columnMasks;		///< followed columns of every word of a packed row
+	std::vector<std::uint64_t>	previousBits;		///< bits of the row above, for every word
+	std::vector<int>			blackStarts;		///< first row of the current black run of every column
+	std::vector<int>			whiteStarts;		///< first row of the current white run of every column
+	std::vector<int>			lastBlackLengths;	///< length of the last black run of every column
+};
+
+/*!
+  	\brief
+	Interline and thickness of the lines of the staves in a single pass over the rows of the page : only the pixels whose color differs from the one above them are visited, where a run ends and the next one starts. There is no limit on the interline but the height of the page. The runs touching the top and bottom borders are counted as if the page were surrounded by white
+
+	\param binaryPlane binarized page of score (corrected from its slope)
+	\param colStep only one column every colStep columns is followed (1 to follow all of them)
+*/
+RunStatistics	getRunStatistics(BitPlane const& binaryPlane, int colStep = 1);
+
+/*!
+  	\brief
+	getRunStatistics in statistics given by the caller (their histograms keep their memory), with the buffers of the caller
+
+	\param binaryPlane binarized page of score (corrected from its slope)
+	\param colStep see getRunStatistics
+	\param statistics statistics of the runs of the page
+	\param buffers see RunBuffers
+*/
+void			getRunStatistics(BitPlane const& binaryPlane, int colStep, RunStatistics& statistics, RunBuffers& buffers);
+
+/*!
+  	\brief
+	Start getRunStatistics on a page given by strips of rows (see addRunStatisticsRows and endRunStatistics), so that the page never has to be held whole
+
+	\param rows number of rows of the page
+	\param cols number of columns of the page
+	\param colStep see getRunStatistics
+	\param statistics statistics of the runs of the page
+	\param buffers see RunBuffers
+*/
+void			beginRunStatistics(int rows, int cols, int colStep, RunStatistics& statistics, RunBuffers& buffers);
+
+/*!
+  	\brief
+	Follow the runs over the rows [firstRow; firstRow + strip.getRows()[ of the page, given just after the rows of the previous call
+
+	\param strip rows of the binarized page (corrected from its slope)
+	\param firstRow row of the page of the first row of strip
+	\param statistics see beginRunStatistics
+	\param buffers see beginRunStatistics
+*/
+void			addRunStatisticsRows(BitPlane const& strip, int firstRow, RunStatistics& statistics, RunBuffers& buffers);
+
+/*!
+  	\brief
+	End the runs at the bottom border once all the rows are given and read the interline and the thicknesses in the histograms
+
+	\param rows number of rows of the page
+	\param statistics see beginRunStatistics
+	\param buffers see beginRunStatistics
+*/
+void			endRunStatistics(int rows, RunStatistics& statistics, RunBuffers& buffers);
+
+/*!
+  	\brief
+	getRunStatistics of an 8 bits binarized page
+
+	\param binaryImg binarized page of score (corrected from its slope)
+	\param colStep see getRunStatistics
+*/
+RunStatistics	getRunStatistics(cv::Mat const& binaryImg, int colStep = 1);
+
+#endif
@@ -0,0 +1,183 @@
+#include "shear.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/*!
+	\brief
+	Copy the row srcRow of the columns of the run in the row dstRow, or fill it with 0 when srcRow is out of the image (memmove because src and dst may be the same image)
+*/
+static void	moveRunRow(cv::Mat const& src, cv::Mat& dst, ShearRun const& run, int srcRow, int dstRow);
+
+std::vector<int>	getShearOffsets(int cols, int hMax)
+{
+	std::vector<int>	offsets;
+
+	offsets.assign(cols, 0);
+	for(int j = 0; j < cols; ++j)
+	{
+		offsets.at(j) = 2 * hMax * j / cols;
+	}
+	return offsets;
+}
+
+std::vector<int>	getShearOffsets(int cols, double hMax)
+{
+	std::vector<int>	offsets;
+
+	getShearOffsets(cols, hMax, offsets);
+	return offsets;
+}
+
+void	getShearOffsets(int cols, double hMax, std::vector<int>& offsets)
+{
+	int		intHMax = static_cast<int>(hMax);
+
+	offsets.assign(cols, 0);
+	for(int j = 0; j < cols; ++j)
+	{
+		// an integer hMax keeps the integer division of the integer version
+		offsets[j] = (hMax == std::floor(hMax)) ? 2 * intHMax * j / cols : static_cast<int>(2.0 * hMax * j / cols);
+	}
+}
+
+void	shearColumns(cv::Mat const& src, cv::Mat& dst, std::vector<int> const& offsets)
+{
+	std::vector<ShearRun>	runs;
+
+	shearColumns(src, dst, offsets, runs);
+}
+
+void	shearColumns(cv::Mat const& src, cv::Mat& dst, std::vector<int> const& offsets, std::vector<ShearRun>& runs)
+{
+	bool	isInPlace = (dst.data == src.data && dst.size() == src.size() && dst.type() == src.type());
+
+	CV_Assert(src.type() == CV_8UC1 && static_cast<int>(offsets.size()) == src.cols);
+	getShearRuns(offsets, runs);
+	if(!isInPlace)
+	{
+		dst.create(src.rows, src.cols, CV_8UC1);
+		// row by row, every run is a contiguous chunk of the destination row
+		for(int i = 0; i < src.rows; ++i)
+		{
+			for(std::size_t r = 0; r < runs.size(); ++r)
+			{
+				moveRunRow(src, dst, runs.at(r), i - runs.at(r).offset, i);
+			}
+		}
+	}
+	else
+	{
+		// the rows of a run shifted down are moved from the bottom so that no source row is overwritten before it is read, and from the top for a run shifted up
+		for(std::size_t r = 0; r < runs.size(); ++r)
+		{
+			ShearRun const&	run = runs.at(r);
+
+			if(run.offset > 0)
+			{
+				for(int i = src.rows - 1; i >= 0; --i)
+				{
+					moveRunRow(src, dst, run, i - run.offset, i);
+				}
+			}
+			else if(run.offset < 0)
+			{
+				for(int i = 0; i < src.rows; ++i)
+				{
+					moveRunRow(src, dst, run, i - run.offset, i);
+				}
+			}
+		}
+	}
+}
+
+void	shearColumns(BitPlane const& src, BitPlane& dst, std::vector<int> const& offsets)
+{
+	std::vector<ShearRun>	runs;
+
+	shearColumns(src, dst, offsets, runs);
+}
+
+void	shearColumns(BitPlane const& src, BitPlane& dst, std::vector<int> const& offsets, std::vector<ShearRun>& runs)
+{
+	int		srcRow = 0;
+	int		bitsNb = 0;
+
+	CV_Assert(static_cast<int>(offsets.size()) == src.getCols());
+	getShearRuns(offsets, runs);
+	if(dst.getRows() != src.getRows() || dst.getCols() != src.getCols() || (!src.isEmpty() && dst.getRow(0) == src.getRow(0)))
+	{
+		dst.create(src.getRows(), src.getCols());
+	}
+	for(int i = 0; i < src.getRows(); ++i)
+	{
+		for(std::size_t r = 0; r < runs.size(); ++r)
+		{
+			srcRow = i - runs.at(r).offset;
+			for(int j = runs.at(r).start; j < runs.at(r).end; j += 64)
+			{
+				bitsNb = std::min(64, runs.at(r).end - j);
+				dst.setBits(i, j, (srcRow >= 0 && srcRow < src.getRows()) ? src.getBits(srcRow, j) : ~std::uint64_t(0), bitsNb);
+			}
+		}
+	}
+}
+
+void	shearRows(BitPlane const& src, int srcFirstRow, int pageRows, int firstRow, BitPlane& dst, std::vector<ShearRun> const& runs)
+{
+	int		srcRow = 0;
+	int		bitsNb = 0;
+
+	CV_Assert(src.getCols() == dst.getCols());
+	for(int i = 0; i < dst.getRows(); ++i)
+	{
+		for(std::size_t r = 0; r < runs.size(); ++r)
+		{
+			srcRow = firstRow + i - runs.at(r).offset;
+			CV_Assert(srcRow < 0 || srcRow >= pageRows || (srcRow >= srcFirstRow && srcRow < srcFirstRow + src.getRows()));
+			for(int j = runs.at(r).start; j < runs.at(r).end; j += 64)
+			{
+				bitsNb = std::min(64, runs.at(r).end - j);
+				dst.setBits(i, j, (srcRow >= 0 && srcRow < pageRows) ? src.getBits(srcRow - srcFirstRow, j) : ~std::uint64_t(0), bitsNb);
+			}
+		}
+	}
+}
+
+std::vector<ShearRun>	getShearRuns(std::vector<int> const& offsets)
+{
+	std::vector<ShearRun>	runs;
+
+	getShearRuns(offsets, runs);
+	return runs;
+}
+
+void	getShearRuns(std::vector<int> const& offsets, std::vector<ShearRun>& runs)
+{
+	int		cols = static_cast<int>(offsets.size());
+	int		start = 0;
+
+	runs.clear();
+	for(int j = 1; j <= cols; ++j)
+	{
+		if(j == cols || offsets.at(j) != offsets.at(start))
+		{
+			runs.push_back({start, j, offsets.at(start)});
+			start = j;
+		}
+	}
+}
+
+static void	moveRunRow(cv::Mat const& src, cv::Mat& dst, ShearRun const& run, int srcRow, int dstRow)
+{
+	unsigned char*	dstPix = dst.ptr<unsigned char>(dstRow) + run.start;
+
+	if(srcRow >= 0 && srcRow < src.rows)
+	{
+		std::memmove(dstPix, src.ptr<unsigned char>(srcRow) + run.start, run.end - run.start);
+	}
+	else
+	{
+		std::memset(dstPix, 0, run.end - run.start);
+	}
+}
@@ -0,0 +1,122 @@
+#ifndef SHEAR_HPP
+#define SHEAR_HPP
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "BitPlane.hpp"
+
+/*!
+	\brief
+	ShearRun stores a range of consecutive columns [start; end[ sharing the same vertical offset
+*/
+struct ShearRun
+{
+	int	start;
+	int	end;
+	int	offset;
+};
+
+/*!
+	\brief
+	Vertical shift of every column of an image of 'cols' columns to correct the slope given by hMax : the column j is shifted down by 2 * hMax * j / cols rows (integer division, as correctSlope always did)
+
+	\param cols number of columns of the image
+	\param hMax vertical shift between the left and right halves of the image
+*/
+std::vector<int>	getShearOffsets(int cols, int hMax);
+
+/*!
+	\brief
+	Fractional version of getShearOffsets for a sub pixel hMax : the offset of a column is 2 * hMax * j / cols truncated toward 0, so that an integer hMax gives the same offsets as the integer version
+
+	\param cols number of columns of the image
+	\param hMax sub pixel vertical shift between the left and right halves of the image
+*/
+std::vector<int>	getShearOffsets(int cols, double hMax);
+
+/*!
+	\brief
+	getShearOffsets of a sub pixel hMax in a buffer given by the caller, whose memory is reused from one call to another
+
+	\param cols number of columns of the image
+	\param hMax sub pixel vertical shift between the left and right halves of the image
+	\param offsets cols offsets
+*/
+void				getShearOffsets(int cols, double hMax, std::vector<int>& offsets);
+
+/*!
+	\brief
+	Group the consecutive columns with the same offset in runs
+
+	\param offsets see shearColumns
+*/
+std::vector<ShearRun>	getShearRuns(std::vector<int> const& offsets);
+
+/*!
+	\brief
+	getShearRuns in a buffer given by the caller, whose memory is reused from one call to another
+
+	\param offsets see shearColumns
+	\param runs runs of the columns
+*/
+void					getShearRuns(std::vector<int> const& offsets, std::vector<ShearRun>& runs);
+
+/*!
+	\brief
+	Shear of an 8 bits image : dst(i, j) = src(i - offsets[j], j), or 0 when the row i - offsets[j] is out of the image. The consecutive columns sharing the same offset are moved together, row chunk by row chunk with memcpy, instead of pixel by pixel
+
+	dst is (re)allocated only if it has not the size and the type of src, so a buffer given by the caller is reused. dst may be src itself : the image is then sheared in place
+
+	\param src 8 bits image
+	\param dst sheared image
+	\param offsets vertical shift of every column of src (see getShearOffsets)
+*/
+void				shearColumns(cv::Mat const& src, cv::Mat& dst, std::vector<int> const& offsets);
+
+/*!
+	\brief
+	shearColumns with the buffer of the runs of columns given by the caller (see getShearRuns)
+
+	\param src 8 bits image
+	\param dst sheared image
+	\param offsets see shearColumns
+	\param runs buffer of the runs, reused from one call to another
+*/
+void				shearColumns(cv::Mat const& src, cv::Mat& dst, std::vector<int> const& offsets, std::vector<ShearRun>& runs);
+
+/*!
+	\brief
+	shearColumns of a bit plane : the runs of columns are moved 64 pixels at a time. The pixels shifted from out of the plane are black, as the ones of the 8 bits version are 0
+
+	dst is (re)allocated if it has not the size of src or if it shares its data
+
+	\param src bit plane
+	\param dst sheared bit plane
+	\param offsets see shearColumns
+*/
+void				shearColumns(BitPlane const& src, BitPlane& dst, std::vector<int> const& offsets);
+
+/*!
+	\brief
+	shearColumns of a bit plane with the buffer of the runs of columns given by the caller. dst keeps its words when it only has to be resized (see BitPlane::create)
+
+	\param src bit plane
+	\param dst sheared bit plane
+	\param offsets see shearColumns
+	\param runs buffer of the runs, reused from one call to another
+*/
+void				shearColumns(BitPlane const& src, BitPlane& dst, std::vector<int> const& offsets, std::vector<ShearRun>& runs);
+
+/*!
+	\brief
+	Rows [firstRow; firstRow + dst.getRows()[ of shearColumns of a page of pageRows rows of which only the rows [srcFirstRow; srcFirstRow + src.getRows()[ are given : the page can be sheared strip by strip, as it is read (see StripDeskewer). The source rows of dst must be in src unless they are out of the page, then they are black as in shearColumns
+
+	\param src rows of the page from srcFirstRow
+	\param srcFirstRow row of the page of the first row of src
+	\param pageRows number of rows of the page
+	\param firstRow row of the sheared page of the first row of dst
+	\param dst rows of the sheared page, its size is kept
+	\param runs see getShearRuns
+*/
+void				shearRows(BitPlane const& src, int srcFirstRow, int pageRows, int firstRow, BitPlane& dst, std::vector<ShearRun> const& runs);
+
+#endif
@@ -1,135 +1,477 @@
 #include "staveDetection.hpp"
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
 #include "tools.hpp"
+#include "SlopeModel.hpp"
+#include "shear.hpp"
+#include "bitPacking.hpp"
+#include "CombFilter.hpp"
+#include "peaks.hpp"
+#include "StaveTracker.hpp"
+#include "TaskPool.hpp"
+#include "PageWorkspace.hpp"
 #include <iostream>
 
 /*!
-  	\brief
-	Get the local maxima in the profile where maxima represent the middle line of every stave (the range of every considered maximum has to be near of the height of a stave : [-2 * interline ; 2 * interline])
+	\brief
+	Ratio between the half size of the range of vertical shifts searched by estimateSlope and the height of the image (2% of the height, that is about 60 rows on a page of 3000 rows)
+*/
+static double const	SLOPE_RANGE_RATIO = 0.02;
 
-	\param data vector of data where local maxima have to be found
-	\param range minimum range between 2 local maxima
+/*!
+	\brief
+	Maximum number of vertical decimations of the page in estimateSlope (the rows of a level l are decimated by 2^l)
 */
-static std::vector<int>	getLocMaxima(std::vector<int> const& data, int range);
+static int const	SLOPE_LEVELS_MAX = 2;
 
 /*!
-  \brief
-  Get the best value of the vertical profile of one considered column by getting the maximum value of the vertical profile around the theoretical abscissa of the lines according to middleLineAbscs shifted in the range [-thickness0 / 2; thickness0 / 2].
-  Called by getOrdsPosition
+	\brief
+	Minimum number of rows of the coarsest level of estimateSlope, smaller images are not decimated any more
+*/
+static int const	SLOPE_LEVEL_MIN_ROWS = 256;
 
-  \param interline see getStavesProfileVect
-  \param middleLineAbsc abscissa of the third line of the considered stave
-  \param subImg sub image of one stave of the score
-  \param thickness0 most represented value in the histogram of the thicknesses of line
-  \param col considered column
+/*!
+	\brief
+	Half size of the window of shifts searched at a level of estimateSlope around the shift found at the coarser level
+*/
+static int const	SLOPE_REFINEMENT_RANGE = 1;
+
+/*!
+	\brief
+	Number of local maxima of the coarsest level of estimateSlope that are refined up to the full resolution
+*/
+static int const	SLOPE_CANDIDATES_NB = 3;
+
+/*!
+	\brief
+	Number of rows of the left half of the bands of getShiftAgreements : a band is compared with the rows of the right half it meets for all the shifts, while they are in the cache
+*/
+static int const	SLOPE_BAND_ROWS = 64;
+
+/*!
+	\brief
+	Number of columns (a multiple of 64) of the strips of a band of stave followed by a task of addLineThicknessHistogram
 */
-static int	getMaxDeltaOrdProfile(int interline, int subImgCenter, cv::Mat const& subImg, int thickness0, int col);
+static int const	THICKNESS_STRIP_COLS = 512;
+
+/*!
+	\brief
+	Number of lines of a stave
+*/
+static int const	STAVE_LINES_NB = 5;
+
+/*!
+	\brief
+	Variation of the interline between the lines of a stave tolerated by getStavesProfileVect
+*/
+static int const	INTERLINE_EPSILON = 1;
+
+/*!
+	\brief
+	Number of columns of a stave correlated together with the mask by getMiddleLineAbsc
+*/
+static int const	TRACKING_BLOCK_COLS = 256;
 
 /*!
   \brief
-  Find the left ordinate of the stave by running through every column of the sub image and keeping the one with a corresponding horizontal profile above the threshold and every values of the profile of the next columns (on a width of 2 interlines) greater than the same threshold
+  Find the left ordinate of the stave : the first column (but the column 0) whose profile is above the threshold while the profile of the next columns (on a width of 2 interlines) is not below it, for the highest threshold in [0; originThresh] giving such a column.
+  Every column is visited once : the highest threshold at which a column qualifies is the minimum of its profile minus 1 and of the minimum of the profile on the next columns (see getSlidingMin), so the best threshold is the highest of these thresholds
 
-  \param profile vertical profile of the stave
-  \param thresh minimum number of black pixel corresponding to the thickness of 5 lines of staves
-  \param subImgWidth width of the image of the stave
+  \param profile vertical profile of the stave (see getStaveExtentProfile)
+  \param originThresh highest threshold, the minimum number of black pixel corresponding to the thickness of 5 lines of staves
   \param interline see getStavesProfileVect
+  \param buffers buffers of the minimums of the profile
 */
-static int	getLeftOrd(std::vector<double> profile, int thresh, int subImgWidth, int interline);
+static int	getLeftOrd(std::vector<int> const& profile, int originThresh, int interline, DetectionBuffers& buffers);
 
 /*!
    \brief
-   Transpose getLeftOrd
+   Transpose getLeftOrd : the last column whose profile is above the threshold while the profile of the interline columns before it is not below it
 
 */
-static int	getRightOrd(std::vector<double> profile, int thresh, int subImgWidth, int interline);
+static int	getRightOrd(std::vector<int> const& profile, int originThresh, int interline, DetectionBuffers& buffers);
 
 /*!
   	\brief
 	mask is a vector which length is the same as the considered stave and which takes the value 1 when a line is supposed to be printed at this row, and -1 otherwise
 
 	\param interline see getStavesProfileVect
-	\param thickness0 see getMaxDeltaOrdProfile
+	\param thickness0 see getStaveExtentProfile
 	\param staveHeight heigth of the sub image of the stave
+	\param mask staveHeight values
 */
-static std::vector<int>	getMask(int interline, int thickness0, int staveHeight);
+static void	getMask(int interline, int thickness0, int staveHeight, std::vector<int>& mask);
 
 /*!
   	\brief
 	Find the startY ordinate which pixels are no more all equal to 0 (avoid the first black vertical line before the keys to initialize the correlation process)
 
 	\param staveHeight height of the sub image of the stave
-	\param subImgI see subImg in getMaxDeltaOrdProfile
+	\param subImgI see subImg in getStaveExtentProfile
 	\param startY first ordinate of the sub image of stave after the vertical bar before the key. This param is reprocessed in this function
-	\param middleLineAbsc see getMaxDeltaOrdProfile
+	\param middleLineAbsc see subImgCenter in getStaveExtentProfile
 */
 static void	findStartY(double staveHeight, cv::Mat const& subImgI, int& startY, int middleLineAbsc);
 
 /*!
   	\brief
-	Process the correlation beetwen the mask and the subImgI
+	Process the correlation beetwen the mask and the columns [firstCol; endCol[ of the subImgI, in integers : the correlation of a column for a shift is the sum over the rows of the mask of +1 when the pixel has the sign of the mask (black for 1) and -1 otherwise, that is 4 * (black pixels under the 1 of the mask) - 2 * (black pixels under the mask) - (sum of the mask). The black pixels of a run of the mask are counted with 2 lookups in the prefix sums of the columns, all the columns of a shift are processed together. The rows out of subImgI are white. The correlation normalized as before is the value divided by staveHeight (see StaveTracker)
 
-	\param startY see findStartY
-	\param leftOrd see getMask
-	\param rightOrd see getMask
+	\param firstCol first column of the block
+	\param endCol column after the last one of the block
 	\param xShiftedRange equals to interline / 2
+	\param middleLineAbsc see subImgCenter in getStaveExtentProfile
+	\param mask see getMask
+	\param maskRuns see getMaskRuns
+	\param subImgI see subImg in getStaveExtentProfile
+	\param prefixSums buffer of the prefix sums, reused from one block to another
+	\param maskImgCorrelation 2 * xShiftedRange + 1 rows (from the shift -xShiftedRange) of endCol - firstCol correlations, the buffer keeps its columns when it has more of them
+*/
+static void	processMaskImgCorrelation(int firstCol, int endCol, int xShiftedRange, int middleLineAbsc, std::vector<int> const& mask, std::vector<cv::Range> const& maskRuns, cv::Mat const& subImgI, std::vector<int>& prefixSums, cv::Mat& maskImgCorrelation);
+
+/*!
+  	\brief
+	Shift maximizing the correlation at startY, and the correlations of the first column of the stave : the columns before startY (the black vertical line at the begining of the stave) keep the correlation of startY for the shifts which have been the best one so far, and 0 for the others
+
+	\param maskImgCorrelation see processMaskImgCorrelation, at startY
 	\param staveHeight see getMiddleLineAbsc
-	\param middleLineAbsc see getMaxDeltaOrdProfile
-	\param interline see getStavesProfileVect
-	\param shift equals 0. Modified in this function. Represents the vertical shift to add to get the maximum of correlation between the mask and the image of stave
-	\param thickness0 see getMaxDeltaOrdProfile
-	\param subImgI see subImg in getMaxDeltaOrdProfile
+	\param isStartYFirst startY is the first column of the stave (its correlations are kept for all the shifts)
+	\param startColumn 2 * xShiftedRange + 1 correlations of the first column of the stave
 */
-static cv::Mat	processMaskImgCorrelation(int startY, int leftOrd, int rightOrd, int xShiftedRange, double staveHeight, int middleLineAbsc, int interline, int& shift, int thickness0, cv::Mat const& subImgI);
+static int	getStartShift(cv::Mat const& maskImgCorrelation, double staveHeight, bool isStartYFirst, std::vector<int>& startColumn);
+
+/*!
+  	\brief
+	Runs [start; end[ of the indexes of the mask equal to 1
+
+	\param mask see getMask
+	\param maskRuns runs of the mask
+*/
+static void	getMaskRuns(std::vector<int> const& mask, std::vector<cv::Range>& maskRuns);
+
+/*!
+  	\brief
+	Pack the left half [0; cols / 2[ and the right half [round(cols / 2); round(cols / 2) + cols / 2[ of a binary image (the halves compared by correlation)
+
+	\param binaryImg binarized image
+	\param halves packed halves, their words are reused
+*/
+static void	packHalves(cv::Mat const& binaryImg, PackedHalves& halves);
+
+/*!
+  	\brief
+	Extract the halves compared by correlation from a bit plane (same halves as packHalves)
+
+	\param binaryPlane binarized image
+	\param halves packed halves, their words are reused
+*/
+static void	extractHalves(BitPlane const& binaryPlane, PackedHalves& halves);
+
+/*!
+  	\brief
+	Level of the pyramid of the buffers, added if the pyramid has less levels
+
+	\param buffers see SlopeBuffers
+	\param level 0 for the halves of the image
+*/
+static PackedHalves&	getPyramidLevel(SlopeBuffers& buffers, int level);
+
+/*!
+  	\brief
+	Exhaustive search of correlation on the packed halves of the level 0 of the pyramid of the buffers
+
+	\param buffers see SlopeBuffers
+	\param pixelsNb number of pixels of the image (the normalization of correlation)
+*/
+static int	searchCorrelation(SlopeBuffers& buffers, std::size_t pixelsNb);
+
+/*!
+  	\brief
+	Coarse to fine search of estimateSlope on the packed halves of the level 0 of the pyramid of the buffers
+
+	\param buffers see SlopeBuffers
+	\param pixelsNb number of pixels of the image (the normalization of correlation)
+*/
+static SlopeEstimate	searchSlope(SlopeBuffers& buffers, std::size_t pixelsNb);
+
+/*!
+  	\brief
+	Search of estimateSlopeAround on the packed halves of the level 0 of the pyramid of the buffers
+
+	\param buffers see SlopeBuffers
+	\param pixelsNb see searchSlope
+	\param priorHMax see estimateSlopeAround
+	\param residualRange see estimateSlopeAround
+*/
+static SlopeEstimate	searchSlopeAround(SlopeBuffers& buffers, std::size_t pixelsNb, int priorHMax, int residualRange);
+
+/*!
+  	\brief
+	Get the agreements of the packed halves for every shift of [shiftMin; shiftMax] and return the shift with the best one (the smallest shift for equal agreements)
+
+	\param halves see packHalves
+	\param shiftMin first tested shift
+	\param shiftMax last tested shift
+	\param agreements filled with the agreement of every tested shift, the one of 'shift' being at index shift - shiftMin
+	\param bandAgreements see getShiftAgreements
+*/
+static int	searchShifts(PackedHalves const& halves, int shiftMin, int shiftMax, std::vector<long long>& agreements, std::vector<std::vector<long long>>& bandAgreements);
+
+/*!
+  	\brief
+	Set the normalized correlation (maxCor) and the sub pixel shift (hMaxSub) of the estimate at estimate.hMax
+
+	\param halves see packHalves
+	\param agreements see searchShifts
+	\param shiftMin shift of the first element of agreements
+	\param pixelsNb number of pixels of the image (the normalization of correlation)
+	\param buffers buffers of the agreements of the neighbours of the peak
+	\param estimate estimate whose hMax is set
+*/
+static void	setPeak(PackedHalves const& halves, std::vector<long long> const& agreements, int shiftMin, std::size_t pixelsNb, SlopeBuffers& buffers, SlopeEstimate& estimate);
+
+/*!
+  	\brief
+	Contrast of a peak among the tested shifts in [0; 1] : (peak - mean) / (peak - min) is close to 1 for a sharp isolated peak, about 0.5 for a linear slope and 0 for flat agreements
+
+	\param agreements see searchShifts
+	\param peakIndex index of the peak in agreements
+*/
+static double	getPeakConfidence(std::vector<long long> const& agreements, int peakIndex);
+
+/*!
+  	\brief
+	Indexes of the highest local maxima of data, sorted from the highest one
+
+	\param data values in which the maxima are searched
+	\param maximaNb maximum number of indexes
+	\param maxima indexes of the maxima, the buffer of the caller is reused
+*/
+static void	getBestLocalMaxima(std::vector<long long> const& data, int maximaNb, std::vector<int>& maxima);
+
+/*!
+  	\brief
+	Agreements between the left and the right packed halves of an image for every vertical shift of [shiftMin; shiftMax] : sum over the pixels of the left half of 1 if it has the color of the pixel of the right half shifted by 'shift' rows and -1 if not (row i of the left half is compared to row i - shift of the right half). The bands of SLOPE_BAND_ROWS rows are compared in parallel, each one into its own agreements, summed once all the bands are over : the sums are integers, so the result does not depend on the number of threads
+
+	\param halves see packHalves
+	\param shiftMin first shift
+	\param shiftMax last shift
+	\param agreements filled with the agreement of every shift, the one of 'shift' being at index shift - shiftMin
+	\param bandAgreements agreements of every band, grown to the number of bands if it has less of them
+*/
+static void	getShiftAgreements(PackedHalves const& halves, int shiftMin, int shiftMax, std::vector<long long>& agreements, std::vector<std::vector<long long>>& bandAgreements);
+
+/*!
+  	\brief
+	Half size of the range of vertical shifts searched by estimateSlope for an image of 'rows' rows
+*/
+static int	getSlopeSearchRange(int rows);
+
+/*!
+  	\brief
+	Vertical decimation by 2 of packed halves : a pixel is black if one of the 2 pixels it replaces is black (the columns are kept because only the vertical shift is searched)
+
+	\param halves see packHalves
+	\param decimatedHalves halves.rows / 2 rows, their words are reused
+*/
+static void	decimate(PackedHalves const& halves, PackedHalves& decimatedHalves);
+
+/*!
+	\class ShiftAgreementBody
+	\brief Agreements of a range of bands of rows for parallelFor (see getShiftAgreements) : all the shifts are compared on a band before the next one, so the page is read from the memory once instead of once for every shift (a band and the rows of the right half around it fit in the cache)
+*/
+class ShiftAgreementBody : public cv::ParallelLoopBody
+{
+	PackedHalves const&						m_halves;
+	int										m_shiftMin;
+	int										m_shiftMax;
+	std::vector<std::vector<long long>>&	m_bandAgreements;
+
+public :
+	/*!
+		\param bandAgreements one vector of agreements for every band, filled as by getShiftAgreements
+	 */
+	ShiftAgreementBody(PackedHalves const& halves, int shiftMin, int shiftMax, std::vector<std::vector<long long>>& bandAgreements);
+	void	operator()(cv::Range const& bands) const;
+};
+
+/*!
+	\class ThicknessHistogramBody
+	\brief Histogram of the vertical black runs of a range of tasks for parallelFor : a task is a strip of THICKNESS_STRIP_COLS columns of the band of rows around one stave, read row by row 64 columns at a time with the length of the current run of every column. Every task fills its own histogram, the histograms are summed once all the tasks are over
+*/
+class ThicknessHistogramBody : public cv::ParallelLoopBody
+{
+	BitPlane const&					m_binaryPlane;
+	std::vector<int> const&			m_middleLineAbscs;
+	std::vector<std::vector<int>>&	m_histograms;
+	int								m_heightSize;
+	int								m_halfHeightSize;
+	int								m_stripsNb;
+
+public :
+	/*!
+		\param histograms one histogram for every task (middleLineAbscs.size() * stripsNb tasks), set to heightSize values by the task
+	 */
+	ThicknessHistogramBody(BitPlane const& binaryPlane, std::vector<int> const& middleLineAbscs, int heightSize, int stripsNb, std::vector<std::vector<int>>& histograms);
+	void	operator()(cv::Range const& tasks) const;
+};
+
+/*!
+	\class SubImageBody
+	\brief Extraction of a range of sub images of staves for parallelFor : the residual slope of every stave is recorded in its slot of the slope model and corrected in its own image, with buffers of the workspace held by the task
+*/
+class SubImageBody : public cv::ParallelLoopBody
+{
+	cv::Mat const&			m_binaryImg;
+	int						m_imgOrigin;
+	std::vector<int> const&	m_subImgOrigins;
+	std::vector<int> const&	m_subImgHeights;
+	SlopeModel&				m_slopeModel;
+	unsigned int			m_firstSlot;
+	PageWorkspace&			m_workspace;
+	std::vector<cv::Mat>&	m_subImages;
+
+public :
+	/*!
+		\param binaryImg rows of the page from imgOrigin
+		\param imgOrigin row of the page of the first row of binaryImg
+		\param firstSlot slot of the slope model of the first stave (see SlopeModel::reserveStaves)
+		\param workspace buffers of the tasks and pool of the corrected sub images
+		\param subImages one preallocated sub image for every stave
+	 */
+	SubImageBody(cv::Mat const& binaryImg, int imgOrigin, std::vector<int> const& subImgOrigins, std::vector<int> const& subImgHeights, SlopeModel& slopeModel, unsigned int firstSlot, PageWorkspace& workspace, std::vector<cv::Mat>& subImages);
+	void	operator()(cv::Range const& staves) const;
+};
 
 int		correlation(cv::Mat const& binaryImg)
 {
-	std::vector<double>	vectCor;
-	double				maxCor = 0.0;
-	int					hMax = 0;
-	int					hRangeMax = 60;
-	int					indexRowShifted = 0;
-	int 				leftPixelValue = 1;
-	int 				rightPixelValue = 1;
-	int					halfImgWidth = std::round(binaryImg.cols / 2.0);
+	SlopeBuffers	buffers;
+
+	packHalves(binaryImg, getPyramidLevel(buffers, 0));
+	return searchCorrelation(buffers, binaryImg.total());
+}
+
+int		correlation(BitPlane const& binaryPlane)
+{
+	SlopeBuffers	buffers;
+
+	extractHalves(binaryPlane, getPyramidLevel(buffers, 0));
+	return searchCorrelation(buffers, static_cast<std::size_t>(binaryPlane.getRows()) * binaryPlane.getCols());
+}
+
+SlopeEstimate	estimateSlope(cv::Mat const& binaryImg)
+{
+	SlopeBuffers	buffers;
 
-	vectCor.assign(hRangeMax, 0);
+	return estimateSlope(binaryImg, buffers);
+}
+
+SlopeEstimate	estimateSlope(BitPlane const& binaryPlane)
+{
+	SlopeBuffers	buffers;
+
+	return estimateSlope(binaryPlane, buffers);
+}
+
+SlopeEstimate	estimateSlope(cv::Mat const& binaryImg, SlopeBuffers& buffers)
+{
+	if(binaryImg.empty())
+	{
+		return {0, 0.0, 0.0, 0.0};
+	}
+	packHalves(binaryImg, getPyramidLevel(buffers, 0));
+	return searchSlope(buffers, binaryImg.total());
+}
+
+SlopeEstimate	estimateSlope(BitPlane const& binaryPlane, SlopeBuffers& buffers)
+{
+	if(binaryPlane.isEmpty())
+	{
+		return {0, 0.0, 0.0, 0.0};
+	}
+	extractHalves(binaryPlane, getPyramidLevel(buffers, 0));
+	return searchSlope(buffers, static_cast<std::size_t>(binaryPlane.getRows()) * binaryPlane.getCols());
+}
+
+void	addStripHalves(cv::Mat const& strip, unsigned char thresh, bool isFirstStrip, SlopeBuffers& buffers)
+{
+	PackedHalves&	halves = getPyramidLevel(buffers, 0);
+
+	CV_Assert(strip.type() == CV_8UC1);
+	if(isFirstStrip)
+	{
+		halves.rows = 0;
+		halves.width = strip.cols / 2;
+		halves.leftWords.clear();
+		halves.rightWords.clear();
+	}
+	// the same columns as packHalves, the words of the strip follow the ones of the rows above it
+	packRows(strip, 0, halves.width, thresh, buffers.stripWords);
+	halves.leftWords.insert(halves.leftWords.end(), buffers.stripWords.begin(), buffers.stripWords.end());
+	packRows(strip, static_cast<int>(std::round(strip.cols / 2.0)), halves.width, thresh, buffers.stripWords);
+	halves.rightWords.insert(halves.rightWords.end(), buffers.stripWords.begin(), buffers.stripWords.end());
+	halves.rows += strip.rows;
+}
+
+SlopeEstimate	estimateSlopeOfHalves(int cols, SlopeBuffers& buffers)
+{
+	if(buffers.pyramid.empty() || buffers.pyramid.at(0).rows == 0 || cols == 0)
+	{
+		return {0, 0.0, 0.0, 0.0};
+	}
+	return searchSlope(buffers, static_cast<std::size_t>(buffers.pyramid.at(0).rows) * cols);
+}
+
+SlopeEstimate	estimateSlopeAround(cv::Mat const& binaryImg, int priorHMax, int residualRange)
+{
+	SlopeBuffers	buffers;
+
+	return estimateSlopeAround(binaryImg, priorHMax, residualRange, buffers);
+}
+
+SlopeEstimate	estimateSlopeAround(BitPlane const& binaryPlane, int priorHMax, int residualRange)
+{
+	SlopeBuffers	buffers;
+
+	if(binaryPlane.isEmpty())
+	{
+		return {priorHMax, static_cast<double>(priorHMax), 0.0, 0.0};
+	}
+	extractHalves(binaryPlane, getPyramidLevel(buffers, 0));
+	return searchSlopeAround(buffers, static_cast<std::size_t>(binaryPlane.getRows()) * binaryPlane.getCols(), priorHMax, residualRange);
+}
+
+SlopeEstimate	estimateSlopeAround(cv::Mat const& binaryImg, int priorHMax, int residualRange, SlopeBuffers& buffers)
+{
+	if(binaryImg.empty())
+	{
+		return {priorHMax, static_cast<double>(priorHMax), 0.0, 0.0};
+	}
+	packHalves(binaryImg, getPyramidLevel(buffers, 0));
+	return searchSlopeAround(buffers, binaryImg.total(), priorHMax, residualRange);
+}
+
+static int	searchCorrelation(SlopeBuffers& buffers, std::size_t pixelsNb)
+{
+	double						maxCor = 0.0;
+	double						cor = 0.0;
+	int							hMax = 0;
+	int							hRangeMax = 60;
+
+	// the 'left image' [0;  width / 2] is compared with the 'right image' [width / 2; width] shifted vertically by [-hRangeMax / 2; hRangeMax / 2]
+	getShiftAgreements(buffers.pyramid.at(0), -hRangeMax / 2, hRangeMax - 1 - hRangeMax / 2, buffers.agreements, buffers.bandAgreements);
 	// correlation processing
 	for(int h = 0; h < hRangeMax; ++h)
 	{
-		for(int i = 0; i < binaryImg.rows; ++i)
-		{
-			for(int j = 0; j < binaryImg.cols / 2; ++j)
-			{
-				// the values of indexRowShifted are beetwen i + [-hRangeMax / 2; hRangeMax / 2]
-				indexRowShifted = i - h + round(hRangeMax / 2.0);
-				if((indexRowShifted < 0) || (indexRowShifted >= binaryImg.rows))
-				{
-					continue;
-				}
-				// Rescale the binary values of the image in the range [-1; 1] => if img(x,y) = 0, img'(x,y) = -1
-				leftPixelValue = 1;
-				rightPixelValue = 1;
-				// the 'left image' [0;  width / 2]
-				if(binaryImg.at<unsigned char>(i, j) == 0)
-				{
-					leftPixelValue = -1;
-				}
-				// the 'right image' [width / 2; width] shifted vertically by [-hRangeMax / 2; hRangeMax / 2]
-				if(binaryImg.at<unsigned char>(indexRowShifted, j + halfImgWidth) == 0)
-				{
-					rightPixelValue = -1;
-				}
-				// add 1 to the correlation vector if pixColor(leftImg) = pixColor(rightShiftedImg) and -1 if not
-				vectCor.at(h) += (leftPixelValue * rightPixelValue);
-			}
-		}
-		// normalize the values of the correlation vector
-		vectCor.at(h) *= 2.0;
-	    vectCor.at(h) /= static_cast<double>(binaryImg.cols * binaryImg.rows);
+		cor = static_cast<double>(buffers.agreements.at(h));
+		// normalize the value of the correlation (the sum is an integer so this is exactly the value the pixel by pixel accumulation gave)
+		cor *= 2.0;
+		cor /= static_cast<double>(pixelsNb);
 		// get the index of the maximum value of the correlation vector (= hMax) which represents the best vertical shift ot the right image so that the lines of both images are superimposed
-		if(vectCor.at(h) > maxCor)
+		if(cor > maxCor)
 		{
-			maxCor = vectCor.at(h);
+			maxCor = cor;
 			// shift by hRangeMax / 2 so that the range of h [0 ; hRangeMax] correponds to the range of shift [-hRangeMax / 2; hRangeMax / 2]
 			hMax = h - hRangeMax / 2;
 		}
@@ -137,121 +479,363 @@ int		correlation(cv::Mat const& binaryImg)
 	return hMax;
 }
 
-cv::Mat	correctSlope(cv::Mat const& binaryImg)
+static SlopeEstimate	searchSlopeAround(SlopeBuffers& buffers, std::size_t pixelsNb, int priorHMax, int residualRange)
 {
-	int		hMax = correlation(binaryImg);
-	int		index = 0;
-	cv::Mat	correctedImg;
+	SlopeEstimate			estimate = {priorHMax, static_cast<double>(priorHMax), 0.0, 0.0};
+	PackedHalves const&		halves = buffers.pyramid.at(0);
+	int						shiftMin = priorHMax - residualRange;
+	int						shiftMax = priorHMax + residualRange;
+
+	estimate.hMax = searchShifts(halves, shiftMin, shiftMax, buffers.agreements, buffers.bandAgreements);
+	setPeak(halves, buffers.agreements, shiftMin, pixelsNb, buffers, estimate);
+	// a peak on the border of the window may just be the side of a better peak out of it
+	if(estimate.hMax > shiftMin && estimate.hMax < shiftMax)
+	{
+		estimate.confidence = getPeakConfidence(buffers.agreements, estimate.hMax - shiftMin);
+	}
+	return estimate;
+}
+
+static SlopeEstimate	searchSlope(SlopeBuffers& buffers, std::size_t pixelsNb)
+{
+	SlopeEstimate					estimate = {0, 0.0, 0.0, 0.0};
+	std::vector<long long>&			agreements = buffers.agreements;
+	std::vector<long long>&			coarseAgreements = buffers.coarseAgreements;
+	std::vector<long long>&			bestAgreements = buffers.bestAgreements;
+	std::vector<long long> const*	candidateAgreements = nullptr;
+	std::vector<int>&				candidates = buffers.candidates;
+	int								searchRange = getSlopeSearchRange(buffers.pyramid.at(0).rows);
+	int								coarsestLevel = 0;
+	int								coarseRange = 0;
+	int								levelRange = 0;
+	int								center = 0;
+	int								shift = 0;
+	int								shiftMin = 0;
+	int								bestShiftMin = 0;
+	int								bestCandidate = 0;
 
-	correctedImg = cv::Mat::zeros(binaryImg.rows, binaryImg.cols, CV_8UC1);
-	for(int i = 0; i < binaryImg.rows; ++i)
+	// level l of the pyramid is the page decimated by 2^l, the coarsest level keeps at least SLOPE_LEVEL_MIN_ROWS rows (the levels beyond it are left from a bigger image)
+	while(coarsestLevel < SLOPE_LEVELS_MAX && buffers.pyramid.at(coarsestLevel).rows / 2 >= SLOPE_LEVEL_MIN_ROWS)
+	{
+		// the level is added before the finer one is read, adding it may move the levels
+		getPyramidLevel(buffers, coarsestLevel + 1);
+		decimate(buffers.pyramid.at(coarsestLevel), buffers.pyramid.at(coarsestLevel + 1));
+		++coarsestLevel;
+	}
+	// the whole range is searched at the coarsest level. A shift of one interline superimposes 4 of the 5 lines of every stave and the decimation blurs the right shift, so the best local maxima are all kept as candidates. The agreements of the coarsest level are kept for the contrast of the chosen candidate
+	coarseRange = static_cast<int>(std::ceil(searchRange / static_cast<double>(1 << coarsestLevel)));
+	searchShifts(buffers.pyramid.at(coarsestLevel), -coarseRange, coarseRange, coarseAgreements, buffers.bandAgreements);
+	getBestLocalMaxima(coarseAgreements, SLOPE_CANDIDATES_NB, candidates);
+	for(std::size_t c = 0; c < candidates.size(); ++c)
 	{
-		for(int j = 0; j < binaryImg.cols; ++j)
+		shift = candidates.at(c) - coarseRange;
+		// without a finer level, the agreements are still the ones of the coarsest level
+		shiftMin = -coarseRange;
+		candidateAgreements = &coarseAgreements;
+		// a shift s at a level stands for the shifts around 2s at the finer level. The coarse range is rounded up : 2s is brought back in the range of the finer level so that its window is never empty
+		for(int level = coarsestLevel - 1; level >= 0; --level)
 		{
-			index = i - (2 * hMax * j / binaryImg.cols);
-			if(index >= 0 && index < binaryImg.rows)
-			{
-				correctedImg.at<unsigned char>(i, j) = binaryImg.at<unsigned char>(index, j);
-			}
+			levelRange = searchRange >> level;
+			center = std::max(-levelRange, std::min(levelRange, 2 * shift));
+			shiftMin = std::max(center - SLOPE_REFINEMENT_RANGE, -levelRange);
+			shift = searchShifts(buffers.pyramid.at(level), shiftMin, std::min(center + SLOPE_REFINEMENT_RANGE, levelRange), agreements, buffers.bandAgreements);
+			candidateAgreements = &agreements;
+		}
+		// keep the candidate with the best correlation at full resolution
+		if(c == 0 || candidateAgreements->at(shift - shiftMin) > bestAgreements.at(estimate.hMax - bestShiftMin))
+		{
+			estimate.hMax = shift;
+			bestShiftMin = shiftMin;
+			bestCandidate = candidates.at(c);
+			bestAgreements = *candidateAgreements;
+		}
+	}
+	// the contrast of the peak of the chosen candidate is measured on the whole range of the coarsest level
+	estimate.confidence = getPeakConfidence(coarseAgreements, bestCandidate);
+	setPeak(buffers.pyramid.at(0), bestAgreements, bestShiftMin, pixelsNb, buffers, estimate);
+	return estimate;
+}
+
+static void	setPeak(PackedHalves const& halves, std::vector<long long> const& agreements, int shiftMin, std::size_t pixelsNb, SlopeBuffers& buffers, SlopeEstimate& estimate)
+{
+	std::vector<long long>&	neighbourAgreements = buffers.neighbourAgreements;
+	int						shiftMax = shiftMin + static_cast<int>(agreements.size()) - 1;
+	double					before = 0.0;
+	double					peak = static_cast<double>(agreements.at(estimate.hMax - shiftMin));
+	double					after = 0.0;
+	double					denominator = 0.0;
+
+	estimate.maxCor = 2.0 * peak / static_cast<double>(pixelsNb);
+	estimate.hMaxSub = estimate.hMax;
+	// sub pixel position of the peak : vertex of the parabola through the correlations at hMax - 1, hMax and hMax + 1. The neighbours out of the searched window are processed now, both in one pass over the bands (comparing 3 shifts costs about as much as 1, the page is read once)
+	if(estimate.hMax == shiftMin || estimate.hMax == shiftMax)
+	{
+		getShiftAgreements(halves, estimate.hMax - 1, estimate.hMax + 1, neighbourAgreements, buffers.bandAgreements);
+	}
+	before = static_cast<double>(estimate.hMax > shiftMin ? agreements.at(estimate.hMax - 1 - shiftMin) : neighbourAgreements.at(0));
+	after = static_cast<double>(estimate.hMax < shiftMax ? agreements.at(estimate.hMax + 1 - shiftMin) : neighbourAgreements.at(2));
+	denominator = before - 2.0 * peak + after;
+	if(denominator < 0.0)
+	{
+		estimate.hMaxSub += std::max(-0.5, std::min(0.5, 0.5 * (before - after) / denominator));
+	}
+}
+
+static double	getPeakConfidence(std::vector<long long> const& agreements, int peakIndex)
+{
+	double	peak = static_cast<double>(agreements.at(peakIndex));
+	double	mean = 0.0;
+	double	min = peak;
+
+	for(std::size_t i = 0; i < agreements.size(); ++i)
+	{
+		mean += static_cast<double>(agreements.at(i));
+		min = std::min(min, static_cast<double>(agreements.at(i)));
+	}
+	mean /= static_cast<double>(agreements.size());
+	if(peak > min)
+	{
+		return (peak - mean) / (peak - min);
+	}
+	return 0.0;
+}
+
+static void	packHalves(cv::Mat const& binaryImg, PackedHalves& halves)
+{
+	halves.rows = binaryImg.rows;
+	halves.width = binaryImg.cols / 2;
+	packRows(binaryImg, 0, halves.width, 0, halves.leftWords);
+	packRows(binaryImg, static_cast<int>(std::round(binaryImg.cols / 2.0)), halves.width, 0, halves.rightWords);
+}
+
+static void	extractHalves(BitPlane const& binaryPlane, PackedHalves& halves)
+{
+	halves.rows = binaryPlane.getRows();
+	halves.width = binaryPlane.getCols() / 2;
+	binaryPlane(cv::Rect(0, 0, halves.width, halves.rows)).getPackedWords(halves.leftWords);
+	binaryPlane(cv::Rect(static_cast<int>(std::round(binaryPlane.getCols() / 2.0)), 0, halves.width, halves.rows)).getPackedWords(halves.rightWords);
+}
+
+static PackedHalves&	getPyramidLevel(SlopeBuffers& buffers, int level)
+{
+	if(static_cast<int>(buffers.pyramid.size()) <= level)
+	{
+		buffers.pyramid.resize(level + 1);
+	}
+	return buffers.pyramid.at(level);
+}
+
+static int	searchShifts(PackedHalves const& halves, int shiftMin, int shiftMax, std::vector<long long>& agreements, std::vector<std::vector<long long>>& bandAgreements)
+{
+	int	bestShift = shiftMin;
+
+	getShiftAgreements(halves, shiftMin, shiftMax, agreements, bandAgreements);
+	for(int shift = shiftMin; shift <= shiftMax; ++shift)
+	{
+		if(agreements.at(shift - shiftMin) > agreements.at(bestShift - shiftMin))
+		{
+			bestShift = shift;
+		}
+	}
+	return bestShift;
+}
+
+static void	getBestLocalMaxima(std::vector<long long> const& data, int maximaNb, std::vector<int>& maxima)
+{
+	int		dataSize = static_cast<int>(data.size());
+
+	maxima.clear();
+	for(int i = 0; i < dataSize; ++i)
+	{
+		// the first index of a plateau is kept
+		if((i == 0 || data.at(i) > data.at(i - 1)) && (i == dataSize - 1 || data.at(i) >= data.at(i + 1)))
+		{
+			maxima.push_back(i);
+		}
+	}
+	// the highest maxima first (the smallest index first for equal values, which std::sort keeps without the buffer of std::stable_sort)
+	std::sort(maxima.begin(), maxima.end(), [&data](int a, int b) { return data.at(a) > data.at(b) || (data.at(a) == data.at(b) && a < b); });
+	if(static_cast<int>(maxima.size()) > maximaNb)
+	{
+		maxima.resize(maximaNb);
+	}
+}
+
+static int	getSlopeSearchRange(int rows)
+{
+	return std::max(1, static_cast<int>(std::ceil(rows * SLOPE_RANGE_RATIO)));
+}
+
+static void	decimate(PackedHalves const& halves, PackedHalves& decimatedHalves)
+{
+	int		wordsNb = getPackedWordsNb(halves.width);
+
+	decimatedHalves.rows = halves.rows / 2;
+	decimatedHalves.width = halves.width;
+	decimatedHalves.leftWords.resize(static_cast<std::size_t>(decimatedHalves.rows) * wordsNb);
+	decimatedHalves.rightWords.resize(static_cast<std::size_t>(decimatedHalves.rows) * wordsNb);
+	for(int i = 0; i < decimatedHalves.rows; ++i)
+	{
+		for(int w = 0; w < wordsNb; ++w)
+		{
+			// a pixel is black if one of the 2 pixels it stands for is black, so that the lines of the staves are kept whatever their thickness
+			decimatedHalves.leftWords[i * wordsNb + w] = halves.leftWords[2 * i * wordsNb + w] | halves.leftWords[(2 * i + 1) * wordsNb + w];
+			decimatedHalves.rightWords[i * wordsNb + w] = halves.rightWords[2 * i * wordsNb + w] | halves.rightWords[(2 * i + 1) * wordsNb + w];
+		}
+	}
+}
+
+static void	getShiftAgreements(PackedHalves const& halves, int shiftMin, int shiftMax, std::vector<long long>& agreements, std::vector<std::vector<long long>>& bandAgreements)
+{
+	int		bandsNb = (halves.rows + SLOPE_BAND_ROWS - 1) / SLOPE_BAND_ROWS;
+
+	agreements.assign(shiftMax - shiftMin + 1, 0);
+	// the bands beyond bandsNb are left from a bigger image
+	if(static_cast<int>(bandAgreements.size()) < bandsNb)
+	{
+		bandAgreements.resize(bandsNb);
+	}
+	parallelFor(cv::Range(0, bandsNb), ShiftAgreementBody(halves, shiftMin, shiftMax, bandAgreements));
+	for(int b = 0; b < bandsNb; ++b)
+	{
+		for(std::size_t k = 0; k < agreements.size(); ++k)
+		{
+			agreements[k] += bandAgreements[b][k];
 		}
 	}
+}
+
+cv::Mat	correctSlope(cv::Mat const& binaryImg)
+{
+	return correctSlope(binaryImg, estimateSlope(binaryImg).hMax);
+}
+
+cv::Mat	correctSlope(cv::Mat const& binaryImg, int hMax)
+{
+	cv::Mat	correctedImg;
+
+	shearColumns(binaryImg, correctedImg, getShearOffsets(binaryImg.cols, hMax));
 	return correctedImg;
 }
 
+void	correctSlope(cv::Mat const& binaryImg, double hMax, cv::Mat& correctedImg)
+{
+	shearColumns(binaryImg, correctedImg, getShearOffsets(binaryImg.cols, hMax));
+}
+
+void	correctSlope(cv::Mat const& binaryImg, double hMax, cv::Mat& correctedImg, SlopeBuffers& buffers)
+{
+	getShearOffsets(binaryImg.cols, hMax, buffers.shearOffsets);
+	shearColumns(binaryImg, correctedImg, buffers.shearOffsets, buffers.shearRuns);
+}
+
+BitPlane	correctSlope(BitPlane const& binaryPlane, int hMax)
+{
+	BitPlane	correctedPlane;
+
+	shearColumns(binaryPlane, correctedPlane, getShearOffsets(binaryPlane.getCols(), hMax));
+	return correctedPlane;
+}
+
+void	correctSlope(BitPlane const& binaryPlane, int hMax, BitPlane& correctedPlane, SlopeBuffers& buffers)
+{
+	getShearOffsets(binaryPlane.getCols(), static_cast<double>(hMax), buffers.shearOffsets);
+	shearColumns(binaryPlane, correctedPlane, buffers.shearOffsets, buffers.shearRuns);
+}
+
+DetectionBuffers::DetectionBuffers() :
+	combFilter(STAVE_LINES_NB, 0, INTERLINE_EPSILON),
+	tracker(0, 1.0, TrackingMode::SMOOTHING)
+{
+
+}
+
 std::vector<int>	detectMiddleLineAbsc(std::vector<int> const& profileVect, int interline)
 {
 	std::vector<int>	middleLineAbscs;
-	std::vector<int>	stavesProfileVect;
+	DetectionBuffers	buffers;
 
+	detectMiddleLineAbsc(profileVect, interline, buffers, middleLineAbscs);
+	return middleLineAbscs;
+}
+
+void	detectMiddleLineAbsc(std::vector<int> const& profileVect, int interline, DetectionBuffers& buffers, std::vector<int>& middleLineAbscs)
+{
+	middleLineAbscs.clear();
 	if(interline > 0 && profileVect.size() > 0)
 	{
-		stavesProfileVect = getStavesProfileVect(profileVect, interline);
-		middleLineAbscs = getLocMaxima(stavesProfileVect, interline * 2);
+		getStavesProfileVect(profileVect, interline, buffers.combFilter, buffers.stavesProfile);
+		getLocMaxima(buffers.stavesProfile, interline * 2, buffers, middleLineAbscs);
 	}
-	return middleLineAbscs;
 }
 
 std::vector<int>	getStavesProfileVect(std::vector<int> const& profileVect, int interline)
 {
 	std::vector<int>	stavesProfileVect;
-	int	profileVectSize = static_cast<int>(profileVect.size());
-	int	indexLineRow = 0;
+	CombFilter			combFilter(STAVE_LINES_NB, interline, INTERLINE_EPSILON);
+
+	getStavesProfileVect(profileVect, interline, combFilter, stavesProfileVect);
+	return stavesProfileVect;
+}
 
+void	getStavesProfileVect(std::vector<int> const& profileVect, int interline, CombFilter& combFilter, std::vector<int>& stavesProfileVect)
+{
+	stavesProfileVect.clear();
 	if(interline > 0 && profileVect.size() > 0)
 	{
-		stavesProfileVect.assign(profileVectSize, 0);
-		// run through all the range of value of the vertical profile
-		for(int x = 0; x < profileVectSize; ++x)
-		{
-			// look for the line which is in the middle of the 5 lines of the stave
-			for(int i = -2; i <= 2; ++i)
-			{
-				// use an epsilon range on the considered interline because it varies beetwen every line of stave
-				for(int j = -1; j <= 1; ++j)
-				{
-					// process the index of the row of the i-th considered line in the stave
-					indexLineRow = x + i * interline + j;
-					if((indexLineRow) < profileVectSize && (indexLineRow) >= 0)
-					{
-						stavesProfileVect.at(x) += profileVect.at(indexLineRow);
-					}
-				}
-			}
-		}
+		// look for the line which is in the middle of the 5 lines of the stave, with an epsilon range on the interline because it varies beetwen every line of stave
+		combFilter.setup(STAVE_LINES_NB, interline, INTERLINE_EPSILON);
+		combFilter.apply(profileVect, stavesProfileVect);
 	}
-	return stavesProfileVect;
 }
 
-static std::vector<int>	getLocMaxima(std::vector<int> const& data, int range)
+std::vector<int>	getLocMaxima(std::vector<int> const& data, int range)
 {
 	std::vector<int>	locMaxima;
-	int					sizeData = static_cast<int>(data.size());
-	int					initMax = 0;
-	int					max = 0;
-	int					indexMax = 0;
+	DetectionBuffers	buffers;
+
+	getLocMaxima(data, range, buffers, locMaxima);
+	return locMaxima;
+}
 
+void	getLocMaxima(std::vector<int> const& data, int range, DetectionBuffers& buffers, std::vector<int>& locMaxima)
+{
+	int		sizeData = static_cast<int>(data.size());
+	int		minHeight = 0;
+
+	locMaxima.clear();
 	if(range > 0 && data.size() > 0)
 	{
-		initMax = std::round(getMax(data) / 3.0);
-		max = initMax;
-		locMaxima.reserve(10);
-
-		for(int i = range; i < sizeData - range; ++i)
+		// the acceptance of the former scan : the maxima lower than a third of the global maximum are not staves, neither are the ones closer than range to the borders
+		minHeight = static_cast<int>(std::round(getMax(data) / 3.0));
+		findPeaks(data, range, minHeight, buffers.peaks, buffers.peakBuffers);
+		for(auto const& peak : buffers.peaks)
 		{
-			if(data.at(i) > max)
+			if(peak.index >= range && peak.index < sizeData - range)
 			{
-				max = data.at(i);
-				indexMax = i;
-				for(int r = i - range; r < i + range; ++r)
-				{
-					if(data.at(r) > max)
-					{
-						indexMax = -1;
-						break;
-					}
-				}
-				if(indexMax == i)
-				{
-					locMaxima.push_back(i);
-					i = i + range;
-					max = initMax;
-				}
+				locMaxima.push_back(peak.index);
 			}
 		}
 	}
-	return locMaxima;
 }
 
 int	detectMiddleLineAbscInSub(std::vector<int> const& profileVect, int interline)
+{
+	DetectionBuffers	buffers;
+
+	return detectMiddleLineAbscInSub(profileVect, interline, buffers);
+}
+
+int	detectMiddleLineAbscInSub(std::vector<int> const& profileVect, int interline, DetectionBuffers& buffers)
 {
 	int					indexMax = 0;
 	int					max = 0;
 	std::size_t			sizeStavesProfileVect = 0;
-	std::vector<int>	stavesProfileVect;
+	std::vector<int>&	stavesProfileVect = buffers.stavesProfile;
 
 	if(interline > 0 && profileVect.size() > 0)
 	{
-		stavesProfileVect = getStavesProfileVect(profileVect, interline);
+		getStavesProfileVect(profileVect, interline, buffers.combFilter, stavesProfileVect);
 		sizeStavesProfileVect = stavesProfileVect.size();
 	
 		// we only have to find one maximum because the stavesProfileVect just contains one stave
@@ -268,48 +852,226 @@ int	detectMiddleLineAbscInSub(std::vector<int> const& profileVect, int interline
 }
 
 std::vector<int>	getLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, cv::Mat const& binaryImg)
+{
+	std::vector<int>				histogram;
+	std::vector<int>				bandLineAbsc(1, 0);
+	std::vector<std::vector<int>>	taskHistograms;
+	BitPlane						bandPlane;
+	int								halfHeightSize = std::round(heightSize / 2.0);
+	int								top = 0;
+	int								bottom = 0;
+
+	CV_Assert(binaryImg.type() == CV_8UC1);
+	if(middleLineAbscs.size() > 0 && heightSize > 0)
+	{
+		histogram.assign(heightSize, 0);
+		// only the rows of the bands are packed, one band at a time (the bands of the staves are followed separately even when they overlap)
+		for(auto line = middleLineAbscs.begin(); line != middleLineAbscs.end(); ++line)
+		{
+			top = std::max(0, *line - halfHeightSize);
+			bottom = std::min(binaryImg.rows, *line + halfHeightSize);
+			if(top < bottom)
+			{
+				BitPlane::fromMat(binaryImg.rowRange(top, bottom), 0, bandPlane);
+				bandLineAbsc[0] = *line - top;
+				addLineThicknessHistogram(bandLineAbsc, heightSize, bandPlane, histogram, taskHistograms);
+			}
+		}
+	}
+	return histogram;
+}
+
+std::vector<int>	getLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, BitPlane const& binaryPlane)
 {
 	std::vector<int>	histogram;
-	int					halfHeightSize = 0;
-	int					black = 0;
-	unsigned char		colorPix = 0;
 
 	if(middleLineAbscs.size() > 0 && heightSize > 0)
 	{
-		halfHeightSize = std::round(heightSize / 2.0);
 		histogram.assign(heightSize, 0);
-		for(int j = 0; j < binaryImg.cols; ++j)
+		addLineThicknessHistogram(middleLineAbscs, heightSize, binaryPlane, histogram);
+	}
+	return histogram;
+}
+
+void	addLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, BitPlane const& binaryPlane, std::vector<int>& histogram)
+{
+	std::vector<std::vector<int>>	taskHistograms;
+
+	addLineThicknessHistogram(middleLineAbscs, heightSize, binaryPlane, histogram, taskHistograms);
+}
+
+void	addLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, BitPlane const& binaryPlane, std::vector<int>& histogram, std::vector<std::vector<int>>& taskHistograms)
+{
+	int		stripsNb = (binaryPlane.getCols() + THICKNESS_STRIP_COLS - 1) / THICKNESS_STRIP_COLS;
+	int		tasksNb = static_cast<int>(middleLineAbscs.size()) * stripsNb;
+
+	CV_Assert(static_cast<int>(histogram.size()) >= heightSize);
+	if(heightSize > 0 && tasksNb > 0)
+	{
+		// the histograms of the tasks keep their memory from one call to another
+		if(static_cast<int>(taskHistograms.size()) < tasksNb)
+		{
+			taskHistograms.resize(tasksNb);
+		}
+		parallelFor(cv::Range(0, tasksNb), ThicknessHistogramBody(binaryPlane, middleLineAbscs, heightSize, stripsNb, taskHistograms));
+		for(int t = 0; t < tasksNb; ++t)
+		{
+			for(int thickness = 0; thickness < heightSize; ++thickness)
+			{
+				histogram[thickness] += taskHistograms[t][thickness];
+			}
+		}
+	}
+}
+
+ShiftAgreementBody::ShiftAgreementBody(PackedHalves const& halves, int shiftMin, int shiftMax, std::vector<std::vector<long long>>& bandAgreements) :
+	m_halves(halves),
+	m_shiftMin(shiftMin),
+	m_shiftMax(shiftMax),
+	m_bandAgreements(bandAgreements)
+{
+
+}
+
+void	ShiftAgreementBody::operator()(cv::Range const& bands) const
+{
+	int						wordsNb = getPackedWordsNb(m_halves.width);
+	int						bandStart = 0;
+	int						bandEnd = 0;
+	int						differences = 0;
+	long long				agreement = 0;
+	std::uint64_t const*	leftRow = nullptr;
+	std::uint64_t const*	rightRow = nullptr;
+
+	for(int b = bands.start; b < bands.end; ++b)
+	{
+		m_bandAgreements.at(b).assign(m_shiftMax - m_shiftMin + 1, 0);
+		bandStart = b * SLOPE_BAND_ROWS;
+		bandEnd = std::min(m_halves.rows, bandStart + SLOPE_BAND_ROWS);
+		// the rows of the band and the rows of the right half they meet stay in the cache from a shift to the next one
+		for(int shift = m_shiftMin; shift <= m_shiftMax; ++shift)
 		{
-			for(auto line = middleLineAbscs.begin(); line != middleLineAbscs.end(); ++line)
+			agreement = 0;
+			// only the rows i such that the shifted row i - shift is in the image are compared
+			for(int i = std::max(bandStart, shift); i < std::min(bandEnd, m_halves.rows + shift); ++i)
 			{
-				// we run through every row beetwen middleLineRow - staveHalfHeight to middleLineRow + staveHalfHeight
-				for(int i = *line - halfHeightSize; i < *line + halfHeightSize; ++i)
+				leftRow = m_halves.leftWords.data() + static_cast<std::size_t>(i) * wordsNb;
+				rightRow = m_halves.rightWords.data() + static_cast<std::size_t>(i - shift) * wordsNb;
+				// a bit of the xor is set when the colors of the pixels differ : every pixel adds 1 to the correlation if pixColor(leftImg) = pixColor(rightShiftedImg) and -1 if not
+				differences = 0;
+				for(int w = 0; w < wordsNb; ++w)
 				{
-					if(i >= 0 && i < binaryImg.rows)
+					differences += popCount(leftRow[w] ^ rightRow[w]);
+				}
+				agreement += m_halves.width - 2 * differences;
+			}
+			m_bandAgreements.at(b).at(shift - m_shiftMin) = agreement;
+		}
+	}
+}
+
+ThicknessHistogramBody::ThicknessHistogramBody(BitPlane const& binaryPlane, std::vector<int> const& middleLineAbscs, int heightSize, int stripsNb, std::vector<std::vector<int>>& histograms) :
+	m_binaryPlane(binaryPlane),
+	m_middleLineAbscs(middleLineAbscs),
+	m_histograms(histograms),
+	m_heightSize(heightSize),
+	m_halfHeightSize(std::round(heightSize / 2.0)),
+	m_stripsNb(stripsNb)
+{
+
+}
+
+void	ThicknessHistogramBody::operator()(cv::Range const& tasks) const
+{
+	int*				histogram = nullptr;
+	int					line = 0;
+	int					top = 0;
+	int					bottom = 0;
+	int					stripStart = 0;
+	int					stripEnd = 0;
+	int					k = 0;
+	int					runLengths[64];
+	std::uint64_t		bits = 0;
+	std::uint64_t		previousBits = 0;
+	std::uint64_t		runBits = 0;
+
+	for(int t = tasks.start; t < tasks.end; ++t)
+	{
+		line = m_middleLineAbscs.at(t / m_stripsNb);
+		// the rows of the band out of the plane are skipped, a run stops at the border of the band or of the plane
+		top = std::max(0, line - m_halfHeightSize);
+		bottom = std::min(m_binaryPlane.getRows(), line + m_halfHeightSize);
+		stripStart = (t % m_stripsNb) * THICKNESS_STRIP_COLS;
+		stripEnd = std::min(m_binaryPlane.getCols(), stripStart + THICKNESS_STRIP_COLS);
+		m_histograms.at(t).assign(m_heightSize, 0);
+		histogram = m_histograms.at(t).data();
+		// the runs of 64 columns are followed together, row by row
+		for(int j = stripStart; j < stripEnd; j += 64)
+		{
+			std::fill(runLengths, runLengths + 64, 0);
+			previousBits = 0;
+			for(int i = top; i <= bottom; ++i)
+			{
+				bits = (i < bottom) ? m_binaryPlane.getBits(i, j) : 0;
+				// the runs of the columns whose pixel becomes white are over
+				runBits = previousBits & ~bits;
+				while(runBits != 0)
+				{
+					k = getLowestBit(runBits);
+					if(runLengths[k] < m_heightSize)
 					{
-						colorPix = binaryImg.at<unsigned char>(i, j);
-						if(colorPix == black)
-						{
-							// if the color of pixel is black => the thickness of line is initialized at 1
-							int thickness = 1;
-							// increase the value of thickness if the color of pixel in the next row (++i) is still black (== 0)
-							while(++i < *line + halfHeightSize && binaryImg.at<unsigned char>(i, j) == 0)
-							{
-								++thickness;
-							}
-							// to avoid the overtaking of the definition of our vector
-							if(thickness < heightSize)
-							{
-								// store the thickness
-								++histogram.at(thickness);
-							}
-						}
+						++histogram[runLengths[k]];
 					}
+					runLengths[k] = 0;
+					runBits &= runBits - 1;
+				}
+				runBits = bits;
+				while(runBits != 0)
+				{
+					++runLengths[getLowestBit(runBits)];
+					runBits &= runBits - 1;
 				}
+				previousBits = bits;
 			}
 		}
 	}
-	return histogram;
+}
+
+SubImageBody::SubImageBody(cv::Mat const& binaryImg, int imgOrigin, std::vector<int> const& subImgOrigins, std::vector<int> const& subImgHeights, SlopeModel& slopeModel, unsigned int firstSlot, PageWorkspace& workspace, std::vector<cv::Mat>& subImages) :
+	m_binaryImg(binaryImg),
+	m_imgOrigin(imgOrigin),
+	m_subImgOrigins(subImgOrigins),
+	m_subImgHeights(subImgHeights),
+	m_slopeModel(slopeModel),
+	m_firstSlot(firstSlot),
+	m_workspace(workspace),
+	m_subImages(subImages)
+{
+
+}
+
+void	SubImageBody::operator()(cv::Range const& staves) const
+{
+	StaveBuffersLease	lease(m_workspace);
+	DetectionBuffers&	buffers = lease.get();
+	cv::Mat				correctedImg;
+	int					residualHMax = 0;
+
+	for(int i = staves.start; i < staves.end; ++i)
+	{
+		m_subImages.at(i) = m_binaryImg(cv::Rect(0, m_subImgOrigins.at(i) - m_imgOrigin, m_binaryImg.cols, m_subImgHeights.at(i)));
+		//correction of the residual slope of every sub image, searched around the slope of the page : only a sub image with a residual slope gets its own pixels
+		residualHMax = m_slopeModel.setStave(m_firstSlot + i, m_subImages.at(i), m_slopeModel.getPageEstimate().hMax, buffers.slope).hMax;
+		if(residualHMax != 0)
+		{
+			// the pixels come from the pool of the workspace, the header then forgets the pool (it may be gone when the header is created again)
+			correctedImg.release();
+			correctedImg.allocator = m_workspace.getAllocator();
+			correctSlope(m_subImages.at(i), static_cast<double>(residualHMax), correctedImg, buffers.slope);
+			correctedImg.allocator = nullptr;
+			m_subImages.at(i) = correctedImg;
+		}
+	}
 }
 
 double	getLineThickness(std::vector<int> const& histogram, unsigned int maxHisto)
@@ -332,22 +1094,44 @@ double	getLineThickness(std::vector<int> const& histogram, unsigned int maxHisto
 	return -1;	
 }
 
-std::vector<cv::Mat>	extractSubImages(cv::Mat const& binaryImg, std::vector<int> const& middleLineAbscs, int interline)
+std::vector<cv::Mat>	extractSubImages(cv::Mat const& binaryImg, std::vector<int> const& middleLineAbscs, int interline, SlopeModel& slopeModel, std::vector<int>& subImgOrigins)
+{
+	PageWorkspace	workspace;
+
+	extractSubImages(binaryImg, middleLineAbscs, interline, slopeModel, workspace);
+	subImgOrigins = workspace.getPage().subImgOrigins;
+	return workspace.getPage().subImages;
+}
+
+void	extractSubImages(cv::Mat const& binaryImg, std::vector<int> const& middleLineAbscs, int interline, SlopeModel& slopeModel, PageWorkspace& workspace)
 {
 	int						middleLineAbscsSize = static_cast<int>(middleLineAbscs.size());
-	std::vector<int>		profileVect;
-	std::vector<int>		subImgCenter;
-	std::vector<int>		subImgOrigin;
-	std::vector<int>		subImgHeight;
-	std::vector<cv::Mat>	subImages;
+	unsigned int			firstSlot = 0;
 
+	getSubImageRows(middleLineAbscs, interline, binaryImg.rows, workspace);
+	// the sub images are views on the rows of the page, they overlap without copying it. The staves are independent : they are extracted in parallel into their slots
+	workspace.getPage().subImages.resize(middleLineAbscsSize);
+	firstSlot = static_cast<unsigned int>(slopeModel.getStaveEstimates().size());
+	slopeModel.reserveStaves(middleLineAbscsSize);
+	extractSubImages(binaryImg, 0, cv::Range(0, middleLineAbscsSize), slopeModel, firstSlot, workspace);
+}
+
+void	getSubImageRows(std::vector<int> const& middleLineAbscs, int interline, int rows, PageWorkspace& workspace)
+{
+	int						middleLineAbscsSize = static_cast<int>(middleLineAbscs.size());
+	std::vector<int>&		subImgCenter = workspace.getPage().subImgCenters;
+	std::vector<int>&		subImgOrigin = workspace.getPage().subImgOrigins;
+	std::vector<int>&		subImgHeight = workspace.getPage().subImgHeights;
+
+	subImgCenter.clear();
+	subImgOrigin.clear();
+	subImgHeight.clear();
 	// subImgCenter represents the middle of 2 successive middle lines of the staves in the page of score
 	subImgCenter.reserve(middleLineAbscsSize);
 	// subImgOrigin represents the position of the upper line in every stave
 	subImgOrigin.reserve(middleLineAbscsSize);
 	// subImgHeight is the height of the sub image 
 	subImgHeight.reserve(middleLineAbscsSize);
-	subImages.reserve(middleLineAbscsSize);
 	subImgCenter.push_back(0);
 	subImgOrigin.push_back(0);
 	for(int i = 1; i < middleLineAbscsSize; ++i)
@@ -361,152 +1145,152 @@ std::vector<cv::Mat>	extractSubImages(cv::Mat const& binaryImg, std::vector<int>
 		subImgHeight.push_back(subImgCenter.at(i + 1) + 2 * interline - subImgOrigin.at(i));
 	}
 	// the last height is processed accoring the last row of the score
-	subImgHeight.push_back(binaryImg.rows - subImgOrigin.at(middleLineAbscsSize - 1));
-	// fill the sub images
-	for(int i = 0; i < middleLineAbscsSize; ++i)
+	subImgHeight.push_back(rows - subImgOrigin.at(middleLineAbscsSize - 1));
+}
+
+void	extractSubImages(cv::Mat const& band, int bandOrigin, cv::Range const& staves, SlopeModel& slopeModel, unsigned int firstSlot, PageWorkspace& workspace)
+{
+	PageBuffers&	page = workspace.getPage();
+
+	if(static_cast<int>(page.subImages.size()) < staves.end)
 	{
-		subImages.push_back(cv::Mat::zeros(subImgHeight.at(i), binaryImg.cols, CV_8UC1));
-		for(int x = 0; x < subImgHeight.at(i); ++x)
-		{
-			for(int y = 0; y < binaryImg.cols; ++y)
-			{
-				(subImages.at(i)).at<unsigned char>(x, y) = binaryImg.at<unsigned char>(x + subImgOrigin.at(i), y);
-			}
-		}
-		//correction of the slope of every sub image
-		subImages.at(i) = correctSlope(subImages.at(i));
-		// print sub images
-		//cv::imshow(std::to_string(i), subImages.at(i));
-		//cv::waitKey(0);
+		page.subImages.resize(staves.end);
 	}
-	return subImages;
+	parallelFor(staves, SubImageBody(band, bandOrigin, page.subImgOrigins, page.subImgHeights, slopeModel, firstSlot, workspace, page.subImages));
 }
 
-static int	getMaxDeltaOrdProfile(int interline, int subImgCenter, cv::Mat const& subImg, int thickness0, int col)
+std::vector<int>	getStaveExtentProfile(cv::Mat const& subImg, int subImgCenter, int interline, int thickness0)
 {
-	int		profileDeltaXP = 0;
-	int 	black = 0;
-	int		maxProfile = 0;
-	int 	deltaXRange = std::floor(static_cast<double>(thickness0) / 2.0) + 1;
-	int		deltaXPRange = std::round(interline / 2.0);
-	int		index = 0;
-	
-	// deltaXPRange range is [-interline / 2; interline / 2] to evaluate the best vertical shift in this range of value that maximizes the horizontal profile and then represents the best shift to find the nearest value of the middle of every line in a stave
+	DetectionBuffers	buffers;
+
+	getStaveExtentProfile(subImg, subImgCenter, interline, thickness0, buffers);
+	return buffers.extentProfile;
+}
+
+void	getStaveExtentProfile(cv::Mat const& subImg, int subImgCenter, int interline, int thickness0, DetectionBuffers& buffers)
+{
+	std::vector<int>&		extentProfile = buffers.extentProfile;
+	std::vector<int>&		prefixSums = buffers.prefixSums;
+	std::vector<int>&		shiftProfile = buffers.shiftProfile;
+	int						deltaXRange = std::floor(static_cast<double>(thickness0) / 2.0) + 1;
+	int						deltaXPRange = std::round(interline / 2.0);
+	int						reach = 2 * std::abs(interline) + deltaXPRange + deltaXRange;
+	int						top = std::max(0, std::min(subImg.rows, subImgCenter - reach));
+	int						bottom = std::max(top, std::min(subImg.rows, subImgCenter + reach + 1));
+	int						cols = subImg.cols;
+	int						windowStart = 0;
+	int						windowEnd = 0;
+	int const*				startSums = nullptr;
+	int const*				endSums = nullptr;
+	unsigned char const*	row = nullptr;
+
+	CV_Assert(subImg.type() == CV_8UC1);
+	extentProfile.assign(cols, 0);
+	// prefixSums[(r - top) * cols + col] is the number of black pixels of the column col in the rows [top; r[, only the rows reached by the windows are summed
+	prefixSums.assign(static_cast<std::size_t>(bottom - top + 1) * cols, 0);
+	for(int r = top; r < bottom; ++r)
+	{
+		row = subImg.ptr<unsigned char>(r);
+		startSums = prefixSums.data() + static_cast<std::size_t>(r - top) * cols;
+		for(int col = 0; col < cols; ++col)
+		{
+			prefixSums[static_cast<std::size_t>(r + 1 - top) * cols + col] = startSums[col] + (row[col] == 0);
+		}
+	}
+	// deltaXP range is [-interline / 2; interline / 2] to evaluate the best vertical shift that maximizes the number of black pixels on the 5 lines of the stave, every line being the rows [-thickness0 / 2 - 1; thickness0 / 2 + 1] around its theoretical row. All the columns are processed together for each shift
 	for(int deltaXP = -deltaXPRange; deltaXP <= deltaXPRange; ++deltaXP)
 	{
-		profileDeltaXP = 0;
+		shiftProfile.assign(cols, 0);
 		for(int k = -2; k <= 2; ++k)
 		{
-			// deltaX range is approximately [-thickness0 / 2; thickness0 / 2] to run through all the rows that define a single line (all the thickness)
-			for(int deltaX = -deltaXRange; deltaX <= deltaXRange; ++deltaX)
+			windowStart = std::max(top, subImgCenter + k * interline + deltaXP - deltaXRange);
+			windowEnd = std::min(bottom, subImgCenter + k * interline + deltaXP + deltaXRange + 1);
+			if(windowStart < windowEnd)
 			{
-				index = subImgCenter + k * interline + deltaX + deltaXP;
-				if(index >= 0 && index < subImg.rows)
+				startSums = prefixSums.data() + static_cast<std::size_t>(windowStart - top) * cols;
+				endSums = prefixSums.data() + static_cast<std::size_t>(windowEnd - top) * cols;
+				for(int col = 0; col < cols; ++col)
 				{
-					if(subImg.at<unsigned char>(index, col) == black)
-					{
-						profileDeltaXP += 1;
-					}
+					shiftProfile[col] += endSums[col] - startSums[col];
 				}
 			}
 		}
-		// we keep the maximum values of the profile according to the deltaXPRange
-		if(maxProfile < profileDeltaXP)
+		for(int col = 0; col < cols; ++col)
 		{
-			maxProfile = profileDeltaXP;
+			extentProfile[col] = std::max(extentProfile[col], shiftProfile[col]);
 		}
 	}
-	return maxProfile;
 }
 
-static int	getLeftOrd(std::vector<double> profile, int thresh, int subImgWidth, int interline)
+static int	getLeftOrd(std::vector<int> const& profile, int originThresh, int interline, DetectionBuffers& buffers)
 {
-	int yMax = 0;
+	std::vector<int>&	windowMins = buffers.windowMins;
+	int					bestThresh = -1;
+	int					thresh = 0;
+	int					leftOrd = -1;
 
-	for(int y = 0; y < subImgWidth; ++y)
+	if(interline > 0)
 	{
-		if(y > 0 && profile.at(y) > thresh)
+		// windowMins[y + 1] is the minimum of the profile on the 2 * interline - 1 columns after y, the columns too close to the right border have no window
+		getSlidingMin(profile, 2 * interline - 1, windowMins, buffers.peakBuffers.window);
+		for(int y = 1; y + 1 < static_cast<int>(windowMins.size()); ++y)
 		{
-			yMax = y + interline * 2;
-			for(int yAfter = y + 1; yAfter < yMax; ++yAfter)
+			thresh = std::min(originThresh, std::min(profile[y] - 1, windowMins[y + 1]));
+			// the first column of the highest threshold is kept
+			if(thresh > bestThresh)
 			{
-				if(profile.at(yAfter) < thresh)
-				{
-					break;
-				}
-				else if(yAfter == yMax - 1)
-				{
-					return y;
-				}
+				bestThresh = thresh;
+				leftOrd = y;
 			}
 		}
 	}
-	return -1;
+	return leftOrd;
 }
 
-static int	getRightOrd(std::vector<double> profile, int thresh, int subImgWidth, int interline)
+static int	getRightOrd(std::vector<int> const& profile, int originThresh, int interline, DetectionBuffers& buffers)
 {
-	int	rightOrd = -1;
+	std::vector<int>&	windowMins = buffers.windowMins;
+	int					bestThresh = -1;
+	int					thresh = 0;
+	int					rightOrd = -1;
 
-	for(int y = interline + 1; y < subImgWidth; ++y)
+	if(interline > 0)
 	{
-		if(profile.at(y) > thresh)
+		// windowMins[y - interline] is the minimum of the profile on the interline columns before y
+		getSlidingMin(profile, interline, windowMins, buffers.peakBuffers.window);
+		for(int y = static_cast<int>(profile.size()) - 1; y > interline; --y)
 		{
-			for(int yBefore = y - interline; yBefore < y; ++yBefore)
+			thresh = std::min(originThresh, std::min(profile[y] - 1, windowMins[y - interline]));
+			// the last column of the highest threshold is kept
+			if(thresh > bestThresh)
 			{
-				if(profile.at(yBefore) < thresh)
-				{
-					break;
-				}
-				else if(yBefore == y - 1)
-				{
-					rightOrd = y;
-				}
+				bestThresh = thresh;
+				rightOrd = y;
 			}
 		}
 	}
 	return rightOrd;
 }
 
-Bivector  getOrdsPosition(std::vector<cv::Mat> const& subImg, double thicknessAvg, int thickness0, int interline, std::vector<int> const& subImgCenter)
+void	getStaveOrds(cv::Mat const& subImg, double thicknessAvg, int thickness0, int interline, int subImgCenter, int& leftOrd, int& rightOrd)
 {
-	Bivector			ords;
-	std::vector<int>	leftOrds;
-	std::vector<int>	rightOrds;
-	std::vector<double>	profile;
-	int					originThresh = round(2.5 * thicknessAvg);
-	int					thresh = originThresh + 1;
+	DetectionBuffers	buffers;
 
-	leftOrds.assign(static_cast<int>(subImg.size()), -1);
-	rightOrds.assign(static_cast<int>(subImg.size()), -1);
-	for(int i = 0; i < static_cast<int>(subImg.size()); ++i)
-	{
-		profile.clear();
-		profile.reserve(subImg.at(i).cols);
-		for(int y = 0; y < subImg.at(i).cols; ++y)
-		{
-			profile.push_back(getMaxDeltaOrdProfile(interline, subImgCenter.at(i), subImg.at(i), thickness0, y));
-		}
-		//  finding the left and right ordinates of a stave
-		while(leftOrds.at(i) == -1 && --thresh >= 0)
-		{
-			leftOrds.at(i) = getLeftOrd(profile, thresh, subImg.at(i).cols, interline);
-		}
-		thresh = originThresh + 1;
-		while(rightOrds.at(i) == -1 && --thresh >= 0)
-		{
-			rightOrds.at(i) = getRightOrd(profile, thresh, subImg.at(i).cols, interline);
-		}
-	}
-	// store the values in the Bivector 'ords'
-	ords.setLeft(leftOrds);
-	ords.setRight(rightOrds);
-	return ords;
+	getStaveOrds(subImg, thicknessAvg, thickness0, interline, subImgCenter, leftOrd, rightOrd, buffers);
+}
+
+void	getStaveOrds(cv::Mat const& subImg, double thicknessAvg, int thickness0, int interline, int subImgCenter, int& leftOrd, int& rightOrd, DetectionBuffers& buffers)
+{
+	int		originThresh = round(2.5 * thicknessAvg);
+
+	getStaveExtentProfile(subImg, subImgCenter, interline, thickness0, buffers);
+	//  finding the left and right ordinates of a stave, with the highest threshold lower or equal to originThresh that gives one
+	leftOrd = getLeftOrd(buffers.extentProfile, originThresh, interline, buffers);
+	rightOrd = getRightOrd(buffers.extentProfile, originThresh, interline, buffers);
 }
 
-static std::vector<int>	getMask(int interline, int thickness0, int staveHeight)
+static void	getMask(int interline, int thickness0, int staveHeight, std::vector<int>& mask)
 {	
-	std::vector<int> mask;
 	int				height = round(staveHeight);
 	mask.assign(height, -1);
 	int deltaB = floor(thickness0 / 2.0);
@@ -525,50 +1309,71 @@ static std::vector<int>	getMask(int interline, int thickness0, int staveHeight)
 			}
 		}
 	}
-	return mask;
 }
 
-std::vector<int>	getMiddleLineAbsc(int middleLineAbsc, int interline, int thickness0, cv::Mat subImgI, int leftOrd, int rightOrd)
+std::vector<int>	getMiddleLineAbsc(int middleLineAbsc, int interline, int thickness0, cv::Mat subImgI, int leftOrd, int rightOrd, TrackingMode trackingMode)
 {	
-	std::vector<int>			improvedCenterLineAbsc;
+	DetectionBuffers	buffers;
+
+	getMiddleLineAbsc(middleLineAbsc, interline, thickness0, subImgI, leftOrd, rightOrd, trackingMode, buffers);
+	return buffers.middleLineAbsc;
+}
+
+void	getMiddleLineAbsc(int middleLineAbsc, int interline, int thickness0, cv::Mat const& subImgI, int leftOrd, int rightOrd, TrackingMode trackingMode, DetectionBuffers& buffers)
+{	
+	std::vector<int>&			improvedCenterLineAbsc = buffers.middleLineAbsc;
 	double						staveHeight = 2.0 * floor(2.5 * interline);
 	int							xShiftedRange = floor(interline / 2.0);
-	cv::Mat						maskImgCorrelation;
-	double						maxCor = -1.0;
-	double						alpha = 0.98;
+	std::vector<int>&			mask = buffers.mask;
+	std::vector<cv::Range>&		maskRuns = buffers.maskRuns;
+	std::vector<int>&			startColumn = buffers.startColumn;
+	std::vector<int>&			column = buffers.column;
+	cv::Mat&					maskImgCorrelation = buffers.maskImgCorrelation;
+	StaveTracker&				tracker = buffers.tracker;
 	int							shift = 0;
 	int							startY = leftOrd - 1;
+	int							blockEnd = 0;
 
+	improvedCenterLineAbsc.clear();
 	// if the left and right ordinates has not been detected in even one sub image, they will be equal to -1 which leads to a segmentation fault in this process, so we better have to check
 	if(leftOrd >= 0 && rightOrd >= 0 && !subImgI.empty() && middleLineAbsc > 0 && interline > 0 && thickness0 > 0)
 	{
-		improvedCenterLineAbsc.assign(rightOrd - leftOrd + 1, middleLineAbsc);
-
+		getMask(interline, thickness0, staveHeight, mask);
+		getMaskRuns(mask, maskRuns);
+		tracker.setup(xShiftedRange, staveHeight, trackingMode);
 		findStartY(staveHeight, subImgI, startY, middleLineAbsc);
-		maskImgCorrelation = processMaskImgCorrelation(startY, leftOrd, rightOrd, xShiftedRange, staveHeight, middleLineAbsc, interline, shift, thickness0, subImgI);
-		improvedCenterLineAbsc.at(0) += shift;
-		// adjust the correlation values to smooth the detected line
-		for(int y = leftOrd + 1; y <= rightOrd; ++y)
+		startColumn.assign(2 * xShiftedRange + 1, 0);
+		column.assign(2 * xShiftedRange + 1, 0);
+		if(startY <= rightOrd)
+		{
+			processMaskImgCorrelation(startY, startY + 1, xShiftedRange, middleLineAbsc, mask, maskRuns, subImgI, buffers.prefixSums, maskImgCorrelation);
+			shift = getStartShift(maskImgCorrelation, staveHeight, startY == leftOrd, startColumn);
+		}
+		tracker.start(startColumn.data(), shift);
+		for(int y = leftOrd + 1; y < std::min(startY, rightOrd + 1); ++y)
+		{
+			tracker.addColumn(startColumn.data());
+		}
+		// the columns from startY are correlated by blocks of TRACKING_BLOCK_COLS columns and followed one by one, the memory does not depend on the width of the stave
+		for(int blockStart = std::max(startY, leftOrd + 1); blockStart <= rightOrd; blockStart = blockEnd)
 		{
-			maxCor = 0.0;
-			for(int xShifted = -xShiftedRange; xShifted <= xShiftedRange; ++xShifted)
+			blockEnd = std::min(rightOrd + 1, blockStart + TRACKING_BLOCK_COLS);
+			processMaskImgCorrelation(blockStart, blockEnd, xShiftedRange, middleLineAbsc, mask, maskRuns, subImgI, buffers.prefixSums, maskImgCorrelation);
+			for(int j = 0; j < blockEnd - blockStart; ++j)
 			{
-				// update the value of the correlation at y by weighting its value with its previous value (at y - 1)
-				maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) *= (1.0 - alpha);
-				maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) +=  (maskImgCorrelation.at<double>(xShifted + xShiftedRange, y - 1) * alpha);
-				// store xShifted maximizing the filtered correlation
-				if(maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) > maxCor)
+				for(int s = 0; s < maskImgCorrelation.rows; ++s)
 				{
-					maxCor = maskImgCorrelation.at<double>(xShifted + xShiftedRange, y);
-					shift = xShifted;
+					column[s] = maskImgCorrelation.at<int>(s, j);
 				}
+				tracker.addColumn(column.data());
 			}
-			// update the abscissa of the middle line
-			improvedCenterLineAbsc.at(y - leftOrd) += shift;
 		}
-		maskImgCorrelation.release();
+		improvedCenterLineAbsc = tracker.finish();
+		for(auto& lineAbsc : improvedCenterLineAbsc)
+		{
+			lineAbsc += middleLineAbsc;
+		}
 	}
-	return improvedCenterLineAbsc;
 }
 
 static void	findStartY(double staveHeight, cv::Mat const& subImgI, int& startY, int middleLineAbsc)
@@ -586,7 +1391,8 @@ static void	findStartY(double staveHeight, cv::Mat const& subImgI, int& startY,
 		++startY;
 		for(int h = -halfStaveHeight; h < halfStaveHeight; ++h)
 		{
-			pixCol = subImgI.at<unsigned char>(h + middleLineAbsc, startY);
+			// the rows out of the sub image are white, as in processMaskImgCorrelation
+			pixCol = (h + middleLineAbsc >= 0 && h + middleLineAbsc < subImgI.rows) ? subImgI.at<unsigned char>(h + middleLineAbsc, startY) : 255;
 			if(pixCol == 255)
 			{
 				++whitePix;
@@ -608,46 +1414,113 @@ static void	findStartY(double staveHeight, cv::Mat const& subImgI, int& startY,
 	}
 }
 
-static cv::Mat	processMaskImgCorrelation(int startY, int leftOrd, int rightOrd, int xShiftedRange, double staveHeight, int middleLineAbsc, int interline, int& shift, int thickness0, cv::Mat const& subImgI)
+static void	processMaskImgCorrelation(int firstCol, int endCol, int xShiftedRange, int middleLineAbsc, std::vector<int> const& mask, std::vector<cv::Range> const& maskRuns, cv::Mat const& subImgI, std::vector<int>& prefixSums, cv::Mat& maskImgCorrelation)
 {
-	cv::Mat						maskImgCorrelation;
-	double						maxCor = -1.0;
-	int							halfStaveHeight = std::round(staveHeight / 2.0);
-	unsigned char				pixCol = 0;
-	std::vector<int>			mask = getMask(interline, thickness0, staveHeight);
-	double						imgValue = 0;
-	double						maskValue = 0;
+	int							halfStaveHeight = static_cast<int>(mask.size()) / 2;
+	int							maskSum = 0;
+	int							firstRow = middleLineAbsc - halfStaveHeight - xShiftedRange;
+	int							rowsNb = 2 * (halfStaveHeight + xShiftedRange);
+	int							width = endCol - firstCol;
+	int							maskStart = 0;
+	int							row = 0;
+	int*						correlation = nullptr;
+	int const*					startSums = nullptr;
+	int const*					endSums = nullptr;
+	unsigned char const*		pixels = nullptr;
 
-	maskImgCorrelation = cv::Mat::zeros((xShiftedRange * 2 + 1), rightOrd + 1, CV_64F);
-	for(int y = startY; y <= rightOrd; ++y)
+	// the buffer only grows : a block narrower than the previous one uses its first columns
+	if(maskImgCorrelation.rows != xShiftedRange * 2 + 1 || maskImgCorrelation.cols < width)
+	{
+		maskImgCorrelation.create(xShiftedRange * 2 + 1, width, CV_32S);
+	}
+	for(auto const& value : mask)
 	{
-		for(int xShifted = -xShiftedRange; xShifted <= xShiftedRange; ++xShifted)
+		maskSum += value;
+	}
+	// prefixSums[r * width + j] is the number of black pixels of the column firstCol + j in the rows [firstRow; firstRow + r[ (the rows out of the image are white)
+	prefixSums.assign(static_cast<std::size_t>(rowsNb + 1) * width, 0);
+	for(int r = 0; r < rowsNb; ++r)
+	{
+		row = firstRow + r;
+		startSums = prefixSums.data() + static_cast<std::size_t>(r) * width;
+		correlation = prefixSums.data() + static_cast<std::size_t>(r + 1) * width;
+		if(row >= 0 && row < subImgI.rows)
 		{
-			for(int h = -halfStaveHeight; h < halfStaveHeight; ++h)
+			pixels = subImgI.ptr<unsigned char>(row) + firstCol;
+			for(int j = 0; j < width; ++j)
 			{
-				pixCol = subImgI.at<unsigned char>(h + middleLineAbsc + xShifted, y);
-				imgValue = -1.0;
-				maskValue = static_cast<double>(mask.at(h + halfStaveHeight));
-				if(pixCol == 0)
-				{
-					imgValue = 1.0;
-				}
-				// get the correlation of every ordinate and with x shifted aroud the abscissa of the middle line of the stave
-				maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) += maskValue * imgValue;
+				correlation[j] = startSums[j] + (pixels[j] == 0);
 			}
-			maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) /= staveHeight;
-			if(y == startY && maskImgCorrelation.at<double>(xShifted + xShiftedRange, y) > maxCor)
+		}
+		else
+		{
+			std::copy(startSums, startSums + width, correlation);
+		}
+	}
+	for(int xShifted = -xShiftedRange; xShifted <= xShiftedRange; ++xShifted)
+	{
+		// the row of the index 0 of the mask in prefixSums
+		maskStart = xShifted + xShiftedRange;
+		correlation = maskImgCorrelation.ptr<int>(xShifted + xShiftedRange);
+		startSums = prefixSums.data() + static_cast<std::size_t>(maskStart) * width;
+		endSums = prefixSums.data() + static_cast<std::size_t>(maskStart + mask.size()) * width;
+		for(int j = 0; j < width; ++j)
+		{
+			correlation[j] = -maskSum - 2 * (endSums[j] - startSums[j]);
+		}
+		for(auto const& run : maskRuns)
+		{
+			startSums = prefixSums.data() + static_cast<std::size_t>(maskStart + run.start) * width;
+			endSums = prefixSums.data() + static_cast<std::size_t>(maskStart + run.end) * width;
+			for(int j = 0; j < width; ++j)
 			{
-				// store xShifted maximizing the correlation at the left ordinate of the stave
-				maxCor = maskImgCorrelation.at<double>(xShifted + xShiftedRange, y);
-				shift = xShifted;
-				// keep the same value of correlation at the ordinates of the black vertical line in the begining of the stave
-				for(int yShift = leftOrd; yShift < startY; ++yShift)
-				{
-					maskImgCorrelation.at<double>(xShifted + xShiftedRange, yShift) = maxCor;
-				}
+				correlation[j] += 4 * (endSums[j] - startSums[j]);
 			}
 		}
 	}
-	return maskImgCorrelation;
+}
+
+static int	getStartShift(cv::Mat const& maskImgCorrelation, double staveHeight, bool isStartYFirst, std::vector<int>& startColumn)
+{
+	double	maxCor = -1.0;
+	int		xShiftedRange = maskImgCorrelation.rows / 2;
+	int		shift = 0;
+	int		correlation = 0;
+
+	for(int xShifted = -xShiftedRange; xShifted <= xShiftedRange; ++xShifted)
+	{
+		correlation = maskImgCorrelation.at<int>(xShifted + xShiftedRange, 0);
+		if(isStartYFirst)
+		{
+			startColumn.at(xShifted + xShiftedRange) = correlation;
+		}
+		// the correlation is only normalized to be compared with the best one
+		if(correlation / staveHeight > maxCor)
+		{
+			// store xShifted maximizing the correlation at the left ordinate of the stave
+			maxCor = correlation / staveHeight;
+			shift = xShifted;
+			// keep the same value of correlation at the ordinates of the black vertical line in the begining of the stave
+			startColumn.at(xShifted + xShiftedRange) = correlation;
+		}
+	}
+	return shift;
+}
+
+static void	getMaskRuns(std::vector<int> const& mask, std::vector<cv::Range>& maskRuns)
+{
+	int		maskSize = static_cast<int>(mask.size());
+
+	maskRuns.clear();
+	for(int x = 0; x < maskSize; ++x)
+	{
+		if(mask[x] == 1 && (x == 0 || mask[x - 1] != 1))
+		{
+			maskRuns.push_back(cv::Range(x, x + 1));
+		}
+		else if(mask[x] == 1)
+		{
+			maskRuns.back().end = x + 1;
+		}
+	}
 }
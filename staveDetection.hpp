@@ -4,7 +4,15 @@
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/core/core.hpp>
 #include <vector>
-#include "Bivector.hpp"
+#include <cstdint>
+#include "BitPlane.hpp"
+#include "CombFilter.hpp"
+#include "peaks.hpp"
+#include "shear.hpp"
+#include "StaveTracker.hpp"
+
+class SlopeModel;
+class PageWorkspace;
 
 /*!
   	\brief
@@ -16,12 +24,224 @@ int						correlation(cv::Mat const& binaryImg);
 
 /*!
   	\brief
-	Correction of the slope according to hMax
+	correlation of a bit plane
+
+	\param binaryPlane binarized page of score
+*/
+int						correlation(BitPlane const& binaryPlane);
+
+/*!
+  	\struct SlopeEstimate
+	\brief SlopeEstimate stores the best vertical shift between the left and right halves of an image found by estimateSlope
+*/
+struct SlopeEstimate
+{
+	int		hMax;		///< best integer vertical shift (same meaning as the value returned by correlation)
+	double	hMaxSub;	///< position of the peak of the correlation interpolated between the shifts around hMax
+	double	maxCor;		///< normalized correlation at hMax
+	double	confidence;	///< contrast of the peak of the correlation among the searched shifts, in [0; 1] (0 when the peak is on the border of the searched window)
+};
+
+/*!
+  	\struct PackedHalves
+	\brief PackedHalves stores the left and right halves of a binary image packed by packRows (see bitPacking.hpp), as compared by correlation and estimateSlope
+*/
+struct PackedHalves
+{
+	std::vector<std::uint64_t>	leftWords;
+	std::vector<std::uint64_t>	rightWords;
+	int							rows;
+	int							width;
+};
+
+/*!
+  	\struct SlopeBuffers
+	\brief SlopeBuffers stores the buffers of the search and of the correction of a slope, reused from one call to another : once they have grown to the size of the page, a search allocates nothing
+*/
+struct SlopeBuffers
+{
+	std::vector<PackedHalves>			pyramid;				///< halves of the image (level 0) and their decimations by estimateSlope, the levels are kept when a smaller image needs less of them
+	std::vector<long long>				agreements;				///< agreements of the last searched shifts
+	std::vector<long long>				coarseAgreements;		///< agreements of the whole range of the coarsest level of estimateSlope
+	std::vector<long long>				bestAgreements;			///< agreements of the best candidate of estimateSlope
+	std::vector<long long>				neighbourAgreements;	///< agreements of the shifts hMax - 1, hMax and hMax + 1 around a peak on the border of the searched window
+	std::vector<std::vector<long long>>	bandAgreements;			///< agreements of every band of rows, never shrunk so that the bands keep their memory
+	std::vector<int>					candidates;				///< best local maxima of the coarsest level of estimateSlope
+	std::vector<int>					shearOffsets;			///< see getShearOffsets
+	std::vector<ShearRun>				shearRuns;				///< see getShearRuns
+	std::vector<std::uint64_t>			stripWords;				///< packed half of the last strip added by addStripHalves
+};
+
+/*!
+  	\brief
+	Coarse to fine version of correlation : the range of shifts follows the height of the image (see SLOPE_RANGE_RATIO), it is fully searched on the image whose rows are decimated by 2 or 4 only, then every finer level just searches a few shifts around the double of the shift found at the coarser one. The peak of the correlation of the full resolution image is interpolated by a parabola to get a sub pixel shift
+
+	\param binaryImg binarized image of the page of score
+*/
+SlopeEstimate			estimateSlope(cv::Mat const& binaryImg);
+
+/*!
+  	\brief
+	estimateSlope of a bit plane, so that a page packed when it is binarized does not have to be unpacked (see preprocessScore)
+
+	\param binaryPlane binarized page of score
+*/
+SlopeEstimate			estimateSlope(BitPlane const& binaryPlane);
+
+/*!
+  	\brief
+	estimateSlope with the buffers of the caller
+
+	\param binaryImg binarized image of the page of score
+	\param buffers see SlopeBuffers
+*/
+SlopeEstimate			estimateSlope(cv::Mat const& binaryImg, SlopeBuffers& buffers);
+
+/*!
+  	\brief
+	estimateSlope of a bit plane with the buffers of the caller
+
+	\param binaryPlane binarized page of score
+	\param buffers see SlopeBuffers
+*/
+SlopeEstimate			estimateSlope(BitPlane const& binaryPlane, SlopeBuffers& buffers);
+
+/*!
+  	\brief
+	Pack the halves of a strip of rows of a gray page after the halves of the strips added before it, for estimateSlopeOfHalves : a page read strip by strip, from its first row to its last one, only has its halves in memory (1 bit per pixel) when its slope is searched. The halves are the ones estimateSlope compares on the page binarized with thresh
+
+	\param strip rows of the page in gray scale (8 bits)
+	\param thresh highest gray level of a black pixel (see binarize)
+	\param isFirstStrip the strip starts the page : the halves of the previous page are forgotten
+	\param buffers the halves are in the level 0 of its pyramid
+*/
+void					addStripHalves(cv::Mat const& strip, unsigned char thresh, bool isFirstStrip, SlopeBuffers& buffers);
+
+/*!
+  	\brief
+	estimateSlope of the halves of a page packed by addStripHalves
+
+	\param cols number of columns of the page
+	\param buffers see addStripHalves
+*/
+SlopeEstimate			estimateSlopeOfHalves(int cols, SlopeBuffers& buffers);
+
+/*!
+  	\brief
+	Search of the vertical shift between the left and right halves of an image in the narrow window [priorHMax - residualRange; priorHMax + residualRange] only, at full resolution
+
+	\param binaryImg binarized image (of a stave)
+	\param priorHMax expected shift
+	\param residualRange half size of the searched window
+*/
+SlopeEstimate			estimateSlopeAround(cv::Mat const& binaryImg, int priorHMax, int residualRange);
+
+/*!
+  	\brief
+	estimateSlopeAround of a bit plane
+
+	\param binaryPlane binarized image (of a stave)
+	\param priorHMax expected shift
+	\param residualRange half size of the searched window
+*/
+SlopeEstimate			estimateSlopeAround(BitPlane const& binaryPlane, int priorHMax, int residualRange);
+
+/*!
+  	\brief
+	estimateSlopeAround with the buffers of the caller
+
+	\param binaryImg binarized image (of a stave)
+	\param priorHMax expected shift
+	\param residualRange half size of the searched window
+	\param buffers see SlopeBuffers
+*/
+SlopeEstimate			estimateSlopeAround(cv::Mat const& binaryImg, int priorHMax, int residualRange, SlopeBuffers& buffers);
+
+/*!
+  	\brief
+	Correction of the slope according to hMax (given by estimateSlope)
 
 	\param binaryImg binarized image of the page of score
 */
 cv::Mat					correctSlope(cv::Mat const& binaryImg);
 
+/*!
+  	\brief
+	Correction of the slope according to a known hMax : the column j is shifted down by 2 * hMax * j / cols rows (see shearColumns)
+
+	\param binaryImg binarized image of the page of score
+	\param hMax vertical shift between the left and right halves of the image
+*/
+cv::Mat					correctSlope(cv::Mat const& binaryImg, int hMax);
+
+/*!
+  	\brief
+	Correction of the slope according to a sub pixel hMax (SlopeEstimate::hMaxSub) written in a buffer given by the caller, reallocated only if its size is not the one of binaryImg. correctedImg may be binaryImg itself to correct it in place
+
+	\param binaryImg binarized image of the page of score
+	\param hMax vertical shift between the left and right halves of the image
+	\param correctedImg corrected image
+*/
+void					correctSlope(cv::Mat const& binaryImg, double hMax, cv::Mat& correctedImg);
+
+/*!
+  	\brief
+	correctSlope of a sub pixel hMax with the buffers of the caller (the offsets and the runs of the columns)
+
+	\param binaryImg binarized image of the page of score
+	\param hMax vertical shift between the left and right halves of the image
+	\param correctedImg corrected image
+	\param buffers see SlopeBuffers
+*/
+void					correctSlope(cv::Mat const& binaryImg, double hMax, cv::Mat& correctedImg, SlopeBuffers& buffers);
+
+/*!
+  	\brief
+	Correction of the slope of a bit plane according to a known hMax (same pixels as the 8 bits version)
+
+	\param binaryPlane binarized page of score
+	\param hMax vertical shift between the left and right halves of the image
+*/
+BitPlane				correctSlope(BitPlane const& binaryPlane, int hMax);
+
+/*!
+  	\brief
+	correctSlope of a bit plane in a plane given by the caller, whose words are reused (see shearColumns), with the buffers of the caller
+
+	\param binaryPlane binarized page of score
+	\param hMax vertical shift between the left and right halves of the image
+	\param correctedPlane corrected plane
+	\param buffers see SlopeBuffers
+*/
+void					correctSlope(BitPlane const& binaryPlane, int hMax, BitPlane& correctedPlane, SlopeBuffers& buffers);
+
+/*!
+  	\struct DetectionBuffers
+	\brief DetectionBuffers stores the buffers of the detection of the staves of a page (detectMiddleLineAbsc) or of one stave at a time (detectMiddleLineAbscInSub, getStaveOrds, getMiddleLineAbsc and its residual slope), reused from one page or stave to another so that the detection allocates nothing once they have grown. A thread needs its own buffers (see PageWorkspace)
+*/
+struct DetectionBuffers
+{
+	std::vector<int>		profile;			///< row profile of the sub image of a stave
+	std::vector<int>		stavesProfile;		///< see getStavesProfileVect
+	CombFilter				combFilter;			///< see getStavesProfileVect, set up again for every interline
+	std::vector<Peak>		peaks;				///< peaks of the staves profile
+	PeakBuffers				peakBuffers;		///< see findPeaks
+	std::vector<int>		extentProfile;		///< see getStaveExtentProfile
+	std::vector<int>		prefixSums;			///< prefix sums of the columns of getStaveExtentProfile and of the correlation with the mask
+	std::vector<int>		shiftProfile;		///< extent profile of one vertical shift of the stave
+	std::vector<int>		windowMins;			///< minimums of the extent profile used to find the ordinates of a stave
+	std::vector<int>		mask;				///< mask of the lines of a stave
+	std::vector<cv::Range>	maskRuns;			///< runs of the mask equal to 1
+	std::vector<int>		startColumn;		///< correlations of the first column of a stave
+	std::vector<int>		column;				///< correlations of the current column of a stave
+	cv::Mat					maskImgCorrelation;	///< correlations of a block of columns of a stave, keeps its columns when a block is narrower
+	StaveTracker			tracker;			///< set up again for every stave
+	std::vector<int>		middleLineAbsc;		///< see getMiddleLineAbsc
+	SlopeBuffers			slope;				///< search and correction of the residual slope of a stave, or of the slope of the page
+
+	DetectionBuffers();
+};
+
 /*!
   	\brief
 	According to the processed vertical profile of the image (where the maximums correspond to the lines of the staves) we process a new profile which maxima represents the middle line of every stave
@@ -31,6 +251,37 @@ cv::Mat					correctSlope(cv::Mat const& binaryImg);
  */
 std::vector<int>		getStavesProfileVect(std::vector<int> const& profileVect, int interline);
 
+/*!
+  	\brief
+	getStavesProfileVect with the comb filter and the buffer of the caller
+
+	\param profileVect see getStavesProfileVect
+	\param interline see getStavesProfileVect
+	\param combFilter filter set up for the interline, its buffer is reused
+	\param stavesProfileVect profile whose maxima are the middle lines of the staves
+*/
+void					getStavesProfileVect(std::vector<int> const& profileVect, int interline, CombFilter& combFilter, std::vector<int>& stavesProfileVect);
+
+/*!
+  	\brief
+	Get the local maxima in the profile where maxima represent the middle line of every stave (the range of every considered maximum has to be near of the height of a stave : [-2 * interline ; 2 * interline]), see findPeaks. A maximum is kept if it is greater than a third of the global maximum and at least range away from the borders, as by the former scan : only the order of the scan no longer changes the maxima
+
+	\param data vector of data where local maxima have to be found
+	\param range minimum range between 2 local maxima
+*/
+std::vector<int>		getLocMaxima(std::vector<int> const& data, int range);
+
+/*!
+  	\brief
+	getLocMaxima with the buffers of the caller
+
+	\param data see getLocMaxima
+	\param range see getLocMaxima
+	\param buffers buffers of findPeaks
+	\param locMaxima indexes of the local maxima
+*/
+void					getLocMaxima(std::vector<int> const& data, int range, DetectionBuffers& buffers, std::vector<int>& locMaxima);
+
 /*!
   	\brief
 	Find every index of rows of the middle line of all the staves in the whole score
@@ -40,6 +291,17 @@ std::vector<int>		getStavesProfileVect(std::vector<int> const& profileVect, int
 */
 std::vector<int>		detectMiddleLineAbsc(std::vector<int> const& profileVect, int interline);
 
+/*!
+  	\brief
+	detectMiddleLineAbsc with the buffers of the caller
+
+	\param profileVect see getStavesProfileVect param
+	\param interline see getStavesProfileVect param
+	\param buffers see DetectionBuffers
+	\param middleLineAbscs rows of the middle lines of the staves
+*/
+void					detectMiddleLineAbsc(std::vector<int> const& profileVect, int interline, DetectionBuffers& buffers, std::vector<int>& middleLineAbscs);
+
 /*!
   	\brief
 	Adapt the method of detectMiddleLineAbsc to adjust the index of row of the middle line of stave according the vertical profile of just one stave (profileVect here is a part of the previous considered profileVect)
@@ -51,7 +313,17 @@ int						detectMiddleLineAbscInSub(std::vector<int> const& profileVect, int inte
 
 /*!
   	\brief
-	To determine the average thickness of the lines in all the staves, we process the histogram of the thickness of every line
+	detectMiddleLineAbscInSub with the buffers of the caller
+
+	\param profileVect see detectMiddleLineAbscInSub
+	\param interline see getStavesProfileVect param
+	\param buffers see DetectionBuffers
+*/
+int						detectMiddleLineAbscInSub(std::vector<int> const& profileVect, int interline, DetectionBuffers& buffers);
+
+/*!
+  	\brief
+	To determine the average thickness of the lines in all the staves, we process the histogram of the thickness of every line. Only the rows of the band of every stave are packed in a bit plane, read as by the bit plane version (a run stops at the border of the band or of the page)
 
 	\param middleLineAbscs vector of abscissa of the third lines of stave in every stave of the image
 	\param heightSize heigth of the page of score
@@ -59,6 +331,39 @@ int						detectMiddleLineAbscInSub(std::vector<int> const& profileVect, int inte
 */
 std::vector<int>		getLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, cv::Mat const& binaryImg);
 
+/*!
+  	\brief
+	getLineThicknessHistogram of a bit plane : the band of every stave is read row by row, 64 columns at a time with the length of the current run of every column (a run stops at the border of the band or of the page). The strips of columns of the bands are processed in parallel
+
+	\param middleLineAbscs see getLineThicknessHistogram
+	\param heightSize see getLineThicknessHistogram
+	\param binaryPlane binarized page of score
+*/
+std::vector<int>		getLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, BitPlane const& binaryPlane);
+
+/*!
+  	\brief
+	getLineThicknessHistogram of a bit plane added to the histogram of the caller, so that the bands of a page read by strips are added as they come (see Staves::setup)
+
+	\param middleLineAbscs see getLineThicknessHistogram, rows of binaryPlane
+	\param heightSize see getLineThicknessHistogram
+	\param binaryPlane binarized rows of the page holding the bands of middleLineAbscs (a band is cut at the borders of binaryPlane)
+	\param histogram histogram of at least heightSize values the runs are added to
+*/
+void					addLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, BitPlane const& binaryPlane, std::vector<int>& histogram);
+
+/*!
+  	\brief
+	addLineThicknessHistogram with the histograms of the tasks given by the caller, so that they keep their memory from one page to another
+
+	\param middleLineAbscs see addLineThicknessHistogram
+	\param heightSize see addLineThicknessHistogram
+	\param binaryPlane see addLineThicknessHistogram
+	\param histogram see addLineThicknessHistogram
+	\param taskHistograms one histogram for every strip of every band, grown when there are more tasks than histograms
+*/
+void					addLineThicknessHistogram(std::vector<int> const& middleLineAbscs, int heightSize, BitPlane const& binaryPlane, std::vector<int>& histogram, std::vector<std::vector<int>>& taskHistograms);
+
 /*!
   	\brief
 	maxHisto represents 'thickness0', the most represented value in the histogram of the thicknesses; this functions evaluate 'thicknessAvg' by getting an average of the 3 columns in the histogram that are around thickness0
@@ -70,37 +375,131 @@ double					getLineThickness(std::vector<int> const& histogram, unsigned int maxH
 
 /*!
   	\brief
-	Extraction the sub images of every stave in the whole score
+	Extraction the sub images of every stave in the whole score. A sub image is a view on the rows of binaryImg (its pixels are shared with the page, see Stave::getEditableStaveImg) unless it has a residual slope, then it is a corrected copy
 
 	\param binaryImg see getLineThicknessHistogram
 	\param middleLineAbscs see getLineThicknessHistogram
 	\param interline see getStavesProfileVect
+	\param slopeModel model of the slope of the page, the residual slope of every sub image is searched around it and recorded in it
+	\param subImgOrigins row of binaryImg of the first row of every sub image
 */
-std::vector<cv::Mat>	extractSubImages(cv::Mat const& binaryImg, std::vector<int> const& middleLineAbscs, int interline);
+std::vector<cv::Mat>	extractSubImages(cv::Mat const& binaryImg, std::vector<int> const& middleLineAbscs, int interline, SlopeModel& slopeModel, std::vector<int>& subImgOrigins);
 
 /*!
   	\brief
-	Process of the left and right ordinates of every stave in every sub image with an horizontal profile of every sub image thresholded in the lest and right part ords is an instance of a class Bivector which contains 2 vectors : the vector of the left ordinates of the sub images and the vector of the right ones
+	extractSubImages in the buffers of a workspace : the sub images and their origins are written in its page buffers, the staves search their residual slope with its buffers and the corrected copies get their pixels from its pool
 
-	\param subImg see getLineThicknessHistogram
+	\param binaryImg see getLineThicknessHistogram
+	\param middleLineAbscs see getLineThicknessHistogram
+	\param interline see getStavesProfileVect
+	\param slopeModel see extractSubImages
+	\param workspace see PageWorkspace, the sub images are in getPage().subImages and their origins in getPage().subImgOrigins
+*/
+void					extractSubImages(cv::Mat const& binaryImg, std::vector<int> const& middleLineAbscs, int interline, SlopeModel& slopeModel, PageWorkspace& workspace);
+
+/*!
+  	\brief
+	Rows of the sub images of extractSubImages, without extracting them : the centers, the origins and the heights of the sub images are written in the page buffers of the workspace
+
+	\param middleLineAbscs see getLineThicknessHistogram
+	\param interline see getStavesProfileVect
+	\param rows number of rows of the page
+	\param workspace see extractSubImages
+*/
+void					getSubImageRows(std::vector<int> const& middleLineAbscs, int interline, int rows, PageWorkspace& workspace);
+
+/*!
+  	\brief
+	extractSubImages of a range of staves whose rows (see getSubImageRows) are all in a band of rows of the page : the sub images are views on the band or corrected copies, written in the page buffers of the workspace. The staves of a page read strip by strip are extracted as soon as their rows are read (see Staves::setup)
+
+	\param band rows of the binarized page corrected from its slope
+	\param bandOrigin row of the page of the first row of band
+	\param staves staves extracted
+	\param slopeModel see extractSubImages, the slots of all the staves of the page are reserved
+	\param firstSlot slot of the slope model of the stave 0 (see SlopeModel::reserveStaves)
+	\param workspace see extractSubImages
+*/
+void					extractSubImages(cv::Mat const& band, int bandOrigin, cv::Range const& staves, SlopeModel& slopeModel, unsigned int firstSlot, PageWorkspace& workspace);
+
+/*!
+  	\brief
+	Profile of the extent of a stave, called by getStaveOrds : for every column, the maximum number of black pixels on the 5 lines of the stave (rows [-thickness0 / 2 - 1; thickness0 / 2 + 1] around their theoretical rows) over the vertical shifts of the stave in [-interline / 2; interline / 2]. A window is counted with 2 lookups in the prefix sums of the columns, the columns of a shift are processed together
+
+	\param subImg sub image of one stave of the score
+	\param subImgCenter row of the middle line of the stave in subImg
+	\param interline see getStavesProfileVect
+	\param thickness0 most represented value in the histogram of the thicknesses of line
+*/
+std::vector<int>		getStaveExtentProfile(cv::Mat const& subImg, int subImgCenter, int interline, int thickness0);
+
+/*!
+  	\brief
+	getStaveExtentProfile in buffers.extentProfile, with the buffers of the caller
+
+	\param subImg sub image of one stave of the score
+	\param subImgCenter row of the middle line of the stave in subImg
+	\param interline see getStavesProfileVect
+	\param thickness0 most represented value in the histogram of the thicknesses of line
+	\param buffers see DetectionBuffers
+*/
+void					getStaveExtentProfile(cv::Mat const& subImg, int subImgCenter, int interline, int thickness0, DetectionBuffers& buffers);
+
+/*!
+  	\brief
+	Left and right ordinates of one stave, from its extent profile (see getStaveExtentProfile) thresholded in its left and right parts
+
+	\param subImg sub image of the stave
 	\param thicknessAvg average vertical thickness of the lines of stave
 	\param thickness0 most represented value in the histogram of vertical thicknesses
 	\param interline see getStavesProfileVect
-	\param middleLineAbscs see getLineThicknessHistogram
+	\param subImgCenter row of the middle line of the stave in subImg
+	\param leftOrd first column of the stave, -1 if there is none
+	\param rightOrd last column of the stave, -1 if there is none
 */
-Bivector				getOrdsPosition(std::vector<cv::Mat> const& subImg, double thicknessAvg, int thickness0, int interline, std::vector<int> const& middleLineAbscs);
+void					getStaveOrds(cv::Mat const& subImg, double thicknessAvg, int thickness0, int interline, int subImgCenter, int& leftOrd, int& rightOrd);
+
+/*!
+  	\brief
+	getStaveOrds with the buffers of the caller
+
+	\param subImg sub image of the stave
+	\param thicknessAvg average vertical thickness of the lines of stave
+	\param thickness0 most represented value in the histogram of vertical thicknesses
+	\param interline see getStavesProfileVect
+	\param subImgCenter row of the middle line of the stave in subImg
+	\param leftOrd first column of the stave, -1 if there is none
+	\param rightOrd last column of the stave, -1 if there is none
+	\param buffers see DetectionBuffers
+*/
+void					getStaveOrds(cv::Mat const& subImg, double thicknessAvg, int thickness0, int interline, int subImgCenter, int& leftOrd, int& rightOrd, DetectionBuffers& buffers);
 
 /*!
   	\brief
 	Processes the 'algorithme de poursuite des portées' => tracking of staves algorithm in the thesis : it calculates the better abscissa (row) of the middle line of a stave at every column
 
-	\param middleLineAbsc see getMaxDeltaOrdProfile
+	\param middleLineAbsc see subImgCenter in getStaveExtentProfile
 	\param interline see getStavesProfileVect
-	\param thickness0 see getMaxDeltaOrdProfile
-	\param subImgI see subImg in getMaxDeltaOrdProfile
+	\param thickness0 see getStaveExtentProfile
+	\param subImgI see subImg in getStaveExtentProfile
 	\param leftOrd first detected ordinate of the stave
 	\param rightOrd last detected oridnate of the stave
+	\param trackingMode see TrackingMode
+*/
+std::vector<int>		getMiddleLineAbsc(int middleLineAbsc, int interline, int thickness0, cv::Mat subImgI, int leftOrd, int rightOrd, TrackingMode trackingMode = TrackingMode::SMOOTHING);
+
+/*!
+  	\brief
+	getMiddleLineAbsc in buffers.middleLineAbsc, with the buffers of the caller
+
+	\param middleLineAbsc see getMiddleLineAbsc
+	\param interline see getStavesProfileVect
+	\param thickness0 see getStaveExtentProfile
+	\param subImgI see subImg in getStaveExtentProfile
+	\param leftOrd see getMiddleLineAbsc
+	\param rightOrd see getMiddleLineAbsc
+	\param trackingMode see TrackingMode
+	\param buffers see DetectionBuffers
 */
-std::vector<int>		getMiddleLineAbsc(int middleLineAbsc, int interline, int thickness0, cv::Mat subImgI, int leftOrd, int rightOrd);
+void					getMiddleLineAbsc(int middleLineAbsc, int interline, int thickness0, cv::Mat const& subImgI, int leftOrd, int rightOrd, TrackingMode trackingMode, DetectionBuffers& buffers);
 
 #endif
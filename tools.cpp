@@ -1,6 +1,63 @@
 #include "tools.hpp"
+#include "profiles.hpp"
+#include "ResultSink.hpp"
+#include "TaskPool.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
+/*!
+	\brief
+	Number of rows of the tiles of the page binarized in parallel by binarizeAdaptive
+*/
+static int const	BINARIZATION_TILE_ROWS = 128;
+
+/*!
+	\brief
+	Ratio between the size of the window of binarizeAdaptive and the interline : a window of 2 interlines always contains a line of stave and the background around it
+*/
+static int const	BINARIZATION_WINDOW_INTERLINE_RATIO = 2;
+
+/*!
+	\brief
+	Smallest window of binarizeAdaptive, when the interline is not known
+*/
+static int const	BINARIZATION_WINDOW_MIN = 15;
+
+/*!
+	\brief
+	Weight k of the deviation in the threshold of Sauvola
+*/
+static double const	SAUVOLA_K = 0.2;
+
+/*!
+	\brief
+	Dynamic range R of the deviation in the threshold of Sauvola (half of the range of 8 bits gray levels)
+*/
+static double const	SAUVOLA_R = 128.0;
+
+/*!
+	\brief
+	Weight k of the deviation in the threshold of Niblack
+*/
+static double const	NIBLACK_K = -0.2;
+
+/*!
+	\class AdaptiveBinarizationBody
+	\brief Binarization of a range of tiles of rows for parallelFor : every tile computes the integral images of its rows and of the half window around them only, so that the memory stays bounded by the number of threads whatever the size of the page
+*/
+class AdaptiveBinarizationBody : public cv::ParallelLoopBody
+{
+	cv::Mat const&		m_img;
+	cv::Mat&			m_binaryImg;
+	BinarizationMode	m_mode;
+	int					m_halfWindow;
+
+public :
+	AdaptiveBinarizationBody(cv::Mat const& img, cv::Mat& binaryImg, BinarizationMode mode, int windowSize);
+	void	operator()(cv::Range const& tiles) const;
+};
+
 cv::Mat	binarize(cv::Mat const& img, unsigned char thresh)
 {
 	cv::Mat	binarizedImg(img.rows, img.cols, CV_8UC1);
@@ -9,34 +66,108 @@ cv::Mat	binarize(cv::Mat const& img, unsigned char thresh)
 	return binarizedImg;
 }
 
-std::vector<int>	getHorizontalProfile(cv::Mat const& img)
+cv::Mat	binarizeAdaptive(cv::Mat const& img, BinarizationMode mode, int windowSize)
+{
+	cv::Mat	binarizedImg(img.rows, img.cols, CV_8UC1);
+	int		tilesNb = (img.rows + BINARIZATION_TILE_ROWS - 1) / BINARIZATION_TILE_ROWS;
+
+	CV_Assert(img.type() == CV_8UC1 && mode != BinarizationMode::FIXED && windowSize > 0);
+	parallelFor(cv::Range(0, tilesNb), AdaptiveBinarizationBody(img, binarizedImg, mode, windowSize));
+	return binarizedImg;
+}
+
+int		getBinarizationWindowSize(int interline)
 {
-	std::vector<int> profileVect;
+	// odd so that the window is centered on the pixel
+	return std::max(BINARIZATION_WINDOW_MIN, BINARIZATION_WINDOW_INTERLINE_RATIO * interline) | 1;
+}
 
-	profileVect.assign(img.rows, 0);
-	for(int i = 0; i < img.rows; ++i)
-	{
-		for(int j = 0; j < img.cols; ++j)
-		{	
-			auto pixColor = img.at<unsigned char>(i, j);
-			profileVect.at(i) += ((pixColor / 255) + 1) % 2;
-		}
-	}
-	//print profile
-	cv::Mat profile(img.rows, img.cols, CV_8UC1, cv::Scalar(255));
-	for(int i = 0; i < img.rows; ++i)
+AdaptiveBinarizationBody::AdaptiveBinarizationBody(cv::Mat const& img, cv::Mat& binaryImg, BinarizationMode mode, int windowSize) :
+	m_img(img),
+	m_binaryImg(binaryImg),
+	m_mode(mode),
+	m_halfWindow(windowSize / 2)
+{
+
+}
+
+void	AdaptiveBinarizationBody::operator()(cv::Range const& tiles) const
+{
+	cv::Mat					sum;
+	cv::Mat					sqSum;
+	int						tileStart = 0;
+	int						tileEnd = 0;
+	int						bandStart = 0;
+	int						bandEnd = 0;
+	int						top = 0;
+	int						bottom = 0;
+	int						left = 0;
+	int						right = 0;
+	double					area = 0.0;
+	double					mean = 0.0;
+	double					deviation = 0.0;
+	double					thresh = 0.0;
+	double const*			topSum = nullptr;
+	double const*			bottomSum = nullptr;
+	double const*			topSqSum = nullptr;
+	double const*			bottomSqSum = nullptr;
+	unsigned char const*	row = nullptr;
+	unsigned char*			binaryRow = nullptr;
+
+	for(int t = tiles.start; t < tiles.end; ++t)
 	{
-		for(int j = 0; j < img.cols; ++j)
+		tileStart = t * BINARIZATION_TILE_ROWS;
+		tileEnd = std::min(m_img.rows, tileStart + BINARIZATION_TILE_ROWS);
+		// the band holds the rows of the tile and the half window above and below it
+		bandStart = std::max(0, tileStart - m_halfWindow);
+		bandEnd = std::min(m_img.rows, tileEnd + m_halfWindow + 1);
+		cv::integral(m_img.rowRange(bandStart, bandEnd), sum, sqSum, CV_64F, CV_64F);
+		for(int i = tileStart; i < tileEnd; ++i)
 		{
-			//img.cols - profileVect[i]
-			if(profileVect.at(i) >= j)
+			// the window is clipped by the borders of the page, the rows of the integral images are shifted by bandStart
+			top = std::max(0, i - m_halfWindow) - bandStart;
+			bottom = std::min(m_img.rows, i + m_halfWindow + 1) - bandStart;
+			topSum = sum.ptr<double>(top);
+			bottomSum = sum.ptr<double>(bottom);
+			topSqSum = sqSum.ptr<double>(top);
+			bottomSqSum = sqSum.ptr<double>(bottom);
+			row = m_img.ptr<unsigned char>(i);
+			binaryRow = m_binaryImg.ptr<unsigned char>(i);
+			for(int j = 0; j < m_img.cols; ++j)
 			{
-				profile.at<unsigned char>(i, j) = 0;
+				left = std::max(0, j - m_halfWindow);
+				right = std::min(m_img.cols, j + m_halfWindow + 1);
+				area = static_cast<double>((bottom - top) * (right - left));
+				mean = (bottomSum[right] - bottomSum[left] - topSum[right] + topSum[left]) / area;
+				deviation = std::sqrt(std::max(0.0, (bottomSqSum[right] - bottomSqSum[left] - topSqSum[right] + topSqSum[left]) / area - mean * mean));
+				if(m_mode == BinarizationMode::SAUVOLA)
+				{
+					thresh = mean * (1.0 + SAUVOLA_K * (deviation / SAUVOLA_R - 1.0));
+				}
+				else
+				{
+					thresh = mean + NIBLACK_K * deviation;
+				}
+				// same convention as binarize : the pixels lower or equal to the threshold are black
+				binaryRow[j] = (row[j] <= thresh) ? 0 : 255;
 			}
 		}
 	}
-	//cv::imshow("profile", profile);
-	//cv::waitKey(0);
+}
+
+std::vector<int>	getHorizontalProfile(cv::Mat const& img)
+{
+	std::vector<int>	profileVect;
+
+	getRowProfile(img, profileVect);
+	return profileVect;
+}
+
+std::vector<int>	getHorizontalProfile(BitPlane const& binaryPlane)
+{
+	std::vector<int>	profileVect;
+
+	getRowProfile(binaryPlane, profileVect);
 	return profileVect;
 }
 
@@ -72,33 +203,18 @@ int		findInterline(std::vector<int> profileVect)
 
 cv::Mat	getVerticalProfile(cv::Mat const& img)
 {
-	cv::Mat 			profile;
-	std::vector<double> profileVect;
+	std::vector<int>	profileVect;
 
-	profileVect.assign(img.rows, 0);
-	profile = cv::Mat::zeros(img.rows, img.cols, CV_8UC1);
-	for(int i = 0; i < img.cols; ++i)
-	{
-		for(int j = 0; j < img.rows; ++j)
-		{	
-			auto pixColor = img.at<cv::Vec3b>(cv::Point(i, j))[0];
-			profileVect.at(i) += static_cast<double>(pixColor / 255.0);
-		}
-	}
-	for(int i = 0; i < img.cols; ++i)
+	// the bars of the image are the white pixels of every column
+	getColProfile(img, profileVect);
+	for(std::size_t j = 0; j < profileVect.size(); ++j)
 	{
-		for(int j = 0; j < img.rows; ++j)
-		{
-			if(profileVect.at(i) > static_cast<double>(img.rows - 1 - j))
-			{
-				profile.at<unsigned char>(j, i) = 255;
-			}
-		}
+		profileVect.at(j) = img.rows - profileVect.at(j);
 	}
-	return profile;
+	return drawColProfile(profileVect, img.rows);
 }
 
-cv::Mat	filter(cv::Mat& img, cv::Mat kernel)
+cv::Mat	filter(cv::Mat& img, cv::Mat kernel, ResultSink& sink)
 {
 	if(img.empty() || kernel.empty())
 	{
@@ -111,8 +227,7 @@ cv::Mat	filter(cv::Mat& img, cv::Mat kernel)
 	{
 		cv::dilate(filteredImg, filteredImg, kernel);
 	}
-	cv::imshow("filteredImg", filteredImg);
-	cv::waitKey(0);
+	sink.putImage("filteredImg", filteredImg);
 	return filteredImg;
 }
 
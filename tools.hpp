@@ -4,6 +4,9 @@
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/core/core.hpp>
 #include <vector>
+#include "BitPlane.hpp"
+
+class ResultSink;
 
 // the binarization of the score has to be automated, for now, I just assign a threshold equal to 220 because the Otsu method failed and I was not able to find a strong method fast enough to keep the further process working each time : to be continued
 /*!
@@ -15,10 +18,41 @@
 cv::Mat				binarize(cv::Mat const& img, unsigned char threshold);
 
 /*!
-	\brief calculates the horizontal profile of the score of a part of the score
+	\brief method of binarization of the page of score : the fixed threshold of binarize or a local threshold following the mean and the standard deviation of the gray levels around every pixel (see binarizeAdaptive)
+*/
+enum class BinarizationMode
+{
+	FIXED,
+	SAUVOLA,	///< threshold = mean * (1 + k * (deviation / R - 1)), the background is clean whatever its lighting
+	NIBLACK		///< threshold = mean + k * deviation, keeps more of the faint lines but also more noise in the background
+};
+
+/*!
+	\brief adaptive binarization of the page of score for uneven lightings (photos of the score) : a pixel is black if it is lower or equal to a threshold computed on the window of windowSize x windowSize pixels centered on it. The sums and the sums of squares of the windows are read in integral images, so the cost of a pixel does not depend on the size of the window, and the tiles of rows of the page are binarized in parallel
+
+	\param img page of score in gray scale (8 bits)
+	\param mode BinarizationMode::SAUVOLA or BinarizationMode::NIBLACK
+	\param windowSize size of the side of the window (see getBinarizationWindowSize)
+*/
+cv::Mat				binarizeAdaptive(cv::Mat const& img, BinarizationMode mode, int windowSize);
+
+/*!
+	\brief size of the window of binarizeAdaptive for a score whose interline is known : the window has to contain the lines and the background between them
+
+	\param interline see findInterline
+*/
+int					getBinarizationWindowSize(int interline);
+
+/*!
+	\brief calculates the horizontal profile of the score of a part of the score (number of black pixels of every row, see getRowProfile, its image is given by drawRowProfile)
 */
 std::vector<int>	getHorizontalProfile(cv::Mat const& score);
 
+/*!
+	\brief calculates the horizontal profile of a bit plane by counting the set bits of every row
+*/
+std::vector<int>	getHorizontalProfile(BitPlane const& binaryPlane);
+
 /*!
 	\brief get the interline of the score (the method is not adjusted if there is many different widths of staves)
 
@@ -27,9 +61,9 @@ std::vector<int>	getHorizontalProfile(cv::Mat const& score);
 int					findInterline(std::vector<int> profileVect);
 
 /*!
-	\brief get the vertical profile of the stave
+	\brief get the image of the vertical profile of the stave : the column j is white from the bottom on the number of white pixels of the column j of the stave (see getColProfile and drawColProfile)
 
-	\param score image of a stave
+	\param score binarized image of a stave
 */
 cv::Mat				getVerticalProfile(cv::Mat const& score);
 
@@ -49,7 +83,7 @@ int					getMaxIndex(std::vector<int> const& data);
 
 // some tests have been done but this is not used yet : kept for further improvement of the quality and the thickness of the lines of the staves by improving  pre treaments and avoiding some disturbance of the double bars eighth ('barres de doubles croches') that sometimes (where the lines are very thin because of a resize of the score) leads to a wrong detection of the middle line in a stave used for the detection and removal of the lines
 //{
-cv::Mat				filter(cv::Mat& img, cv::Mat kernel);
+cv::Mat				filter(cv::Mat& img, cv::Mat kernel, ResultSink& sink);
 //}
 
 #endif